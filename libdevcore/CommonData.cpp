@@ -95,6 +95,26 @@ bytes dev::fromHex(std::string const& _s, WhenError _throw)
 	return ret;
 }
 
+string dev::toBase64(bytes const& _data)
+{
+	static char const* const alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	string ret;
+	ret.reserve((_data.size() + 2) / 3 * 4);
+	for (size_t i = 0; i < _data.size(); i += 3)
+	{
+		size_t remaining = _data.size() - i;
+		uint32_t group = uint32_t(_data[i]) << 16;
+		if (remaining > 1)
+			group |= uint32_t(_data[i + 1]) << 8;
+		if (remaining > 2)
+			group |= _data[i + 2];
+		ret += alphabet[(group >> 18) & 0x3f];
+		ret += alphabet[(group >> 12) & 0x3f];
+		ret += remaining > 1 ? alphabet[(group >> 6) & 0x3f] : '=';
+		ret += remaining > 2 ? alphabet[group & 0x3f] : '=';
+	}
+	return ret;
+}
 
 bool dev::passesAddressChecksum(string const& _str, bool _strict)
 {
@@ -135,6 +135,10 @@ int fromHex(char _i, WhenError _throw);
 /// @example fromHex("41626261") == asBytes("Abba")
 /// If _throw = ThrowType::DontThrow, it replaces bad hex characters with 0's, otherwise it will throw an exception.
 bytes fromHex(std::string const& _s, WhenError _throw = WhenError::DontThrow);
+/// Converts a series of bytes to its base64 encoding (RFC 4648, with padding).
+/// @example toBase64(asBytes("Abba")) == "QWJiYQ=="
+std::string toBase64(bytes const& _data);
+
 /// Converts byte array to a string containing the same (binary) data. Unless
 /// the byte array happens to contain ASCII data, this won't be printable.
 inline std::string asString(bytes const& _b)
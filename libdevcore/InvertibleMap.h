@@ -17,11 +17,20 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 /**
  * Data structure that keeps track of values and keys of a mapping.
+ *
+ * While at least one checkpoint is active, every modification is recorded
+ * together with the previous value of the key, so that the map can later be
+ * joined with its state at the checkpoint in time proportional to the number
+ * of changes instead of having to copy and compare the whole map.
  */
 template <class K, class V>
 struct InvertibleMap
@@ -32,34 +41,89 @@ struct InvertibleMap
 
 	void set(K _key, V _value)
 	{
-		if (values.count(_key))
-			references[values[_key]].erase(_key);
+		auto it = values.find(_key);
+		if (it != values.end())
+		{
+			record(_key, it->second);
+			references[it->second].erase(_key);
+		}
+		else
+			record(_key, boost::none);
 		values[_key] = _value;
 		references[_value].insert(_key);
 	}
 
 	void eraseKey(K _key)
 	{
-		if (values.count(_key))
-			references[values[_key]].erase(_key);
-		values.erase(_key);
+		auto it = values.find(_key);
+		if (it != values.end())
+		{
+			record(_key, it->second);
+			references[it->second].erase(_key);
+			values.erase(it);
+		}
 	}
 
 	void eraseValue(V _value)
 	{
 		if (references.count(_value))
 		{
-			for (V v: references[_value])
-				values.erase(v);
+			for (K k: references[_value])
+			{
+				record(k, _value);
+				values.erase(k);
+			}
 			references.erase(_value);
 		}
 	}
 
 	void clear()
 	{
+		if (m_activeCheckpoints > 0)
+			for (auto const& item: values)
+				record(item.first, item.second);
 		values.clear();
 		references.clear();
 	}
+
+	/// Starts recording changes.
+	/// @returns a marker that has to be passed to joinWithCheckpoint.
+	size_t checkpoint()
+	{
+		++m_activeCheckpoints;
+		return m_journal.size();
+	}
+
+	/// Removes all keys that did not exist or had a different value at the time
+	/// @a _checkpoint was taken and ends the checkpoint. Checkpoints have to be
+	/// joined in the reverse order of their creation.
+	void joinWithCheckpoint(size_t _checkpoint)
+	{
+		// The first change to a key after the checkpoint records its value at the checkpoint.
+		std::map<K, boost::optional<V>> valuesAtCheckpoint;
+		for (size_t i = _checkpoint; i < m_journal.size(); ++i)
+			valuesAtCheckpoint.emplace(m_journal[i].first, m_journal[i].second);
+		--m_activeCheckpoints;
+		for (auto const& item: valuesAtCheckpoint)
+		{
+			auto it = values.find(item.first);
+			if (it != values.end() && (!item.second || *item.second != it->second))
+				eraseKey(item.first);
+		}
+		if (m_activeCheckpoints == 0)
+			m_journal.clear();
+	}
+
+private:
+	void record(K const& _key, boost::optional<V> _previousValue)
+	{
+		if (m_activeCheckpoints > 0)
+			m_journal.emplace_back(_key, std::move(_previousValue));
+	}
+
+	/// Modifications as pairs of key and previous value, oldest first.
+	std::vector<std::pair<K, boost::optional<V>>> m_journal;
+	size_t m_activeCheckpoints = 0;
 };
 
 template <class T>
@@ -21,6 +21,7 @@
 
 #include <libdevcore/JSON.h>
 
+#include <libdevcore/Assertions.h>
 #include <libdevcore/CommonIO.h>
 
 #include <sstream>
@@ -101,6 +102,71 @@ string jsonCompactPrint(Json::Value const& _input)
 	return print(_input, writerBuilder);
 }
 
+void jsonCompactPrint(Json::Value const& _input, ostream& _output)
+{
+	static map<string, string> settings{{"indentation", ""}};
+	static StreamWriterBuilder writerBuilder(settings);
+	unique_ptr<Json::StreamWriter> writer(writerBuilder.newStreamWriter());
+	writer->write(_input, &_output);
+}
+
+void JsonStreamWriter::write(vector<string> const& _path, Json::Value const& _value)
+{
+	assertThrow(!m_finished, Exception, "JSON stream already finished.");
+	assertThrow(!_path.empty(), Exception, "Empty JSON member path.");
+
+	size_t common = 0;
+	while (common < m_openObjects.size() && common + 1 < _path.size() && m_openObjects[common] == _path[common])
+		common++;
+	for (; m_openObjects.size() > common; m_openObjects.pop_back())
+	{
+		m_output << '}';
+		m_hasMember = true;
+	}
+	for (; common + 1 < _path.size(); common++)
+	{
+		writeKey(_path[common]);
+		m_output << '{';
+		m_openObjects.push_back(_path[common]);
+		m_hasMember = false;
+	}
+	writeKey(_path.back());
+	jsonCompactPrint(_value, m_output);
+	m_hasMember = true;
+}
+
+void JsonStreamWriter::writeMembers(Json::Value const& _object)
+{
+	for (auto const& key: _object.getMemberNames())
+		write({key}, _object[key]);
+}
+
+void JsonStreamWriter::finish()
+{
+	if (m_finished)
+		return;
+	if (!m_started)
+		m_output << '{';
+	for (; !m_openObjects.empty(); m_openObjects.pop_back())
+		m_output << '}';
+	m_output << '}';
+	m_started = true;
+	m_finished = true;
+}
+
+void JsonStreamWriter::writeKey(string const& _key)
+{
+	if (!m_started)
+	{
+		m_output << '{';
+		m_started = true;
+	}
+	if (m_hasMember)
+		m_output << ',';
+	jsonCompactPrint(Json::Value(_key), m_output);
+	m_output << ':';
+}
+
 bool jsonParseStrict(string const& _input, Json::Value& _json, string* _errs /* = nullptr */)
 {
 	static StrictModeCharReaderBuilder readerBuilder;
@@ -24,7 +24,9 @@
 
 #include <json/json.h>
 
+#include <ostream>
 #include <string>
+#include <vector>
 
 namespace dev {
 
@@ -34,6 +36,45 @@ std::string jsonPrettyPrint(Json::Value const& _input);
 /// Serialise the JSON object (@a _input) without indentation
 std::string jsonCompactPrint(Json::Value const& _input);
 
+/// Serialise the JSON object (@a _input) without indentation to the stream @a _output
+void jsonCompactPrint(Json::Value const& _input, std::ostream& _output);
+
+/**
+ * Writes a JSON object to a stream member by member, without holding the whole document in memory.
+ *
+ * Members are identified by the path of keys leading to them and have to be written in the order
+ * of their paths. The enclosing objects are opened and closed as needed, so that the output is
+ * identical to the compact serialisation of the complete document.
+ */
+class JsonStreamWriter
+{
+public:
+	explicit JsonStreamWriter(std::ostream& _output): m_output(_output) {}
+
+	/// Writes @a _value as the member at @a _path, which has to be non-empty and
+	/// has to come after the path of the previously written member.
+	void write(std::vector<std::string> const& _path, Json::Value const& _value);
+	/// Writes all members of the object @a _object at the top level.
+	void writeMembers(Json::Value const& _object);
+	/// Closes all open objects. No member can be written afterwards.
+	void finish();
+
+	/// @returns true if anything was written to the stream.
+	bool started() const { return m_started; }
+
+private:
+	/// Opens the top-level object if needed and writes the separator and the key of a new member.
+	void writeKey(std::string const& _key);
+
+	std::ostream& m_output;
+	/// Keys of the currently open nested objects, outermost first.
+	std::vector<std::string> m_openObjects;
+	/// Whether the innermost open object already has a member.
+	bool m_hasMember = false;
+	bool m_started = false;
+	bool m_finished = false;
+};
+
 /// Parse a JSON string (@a _input) with enabled strict-mode and writes resulting JSON object to (@a _json)
 /// \param _input JSON input string
 /// \param _json [out] resulting JSON object
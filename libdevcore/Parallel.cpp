@@ -0,0 +1,111 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Helpers for running independent tasks concurrently.
+ */
+
+#include <libdevcore/Parallel.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace dev;
+
+WorkerPool::WorkerPool(size_t _threads)
+{
+	for (size_t i = 1; i < _threads; ++i)
+		m_workers.emplace_back([this]() { work(); });
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_batchStarted.notify_all();
+	for (thread& worker: m_workers)
+		worker.join();
+}
+
+void WorkerPool::parallelFor(size_t _count, function<void(size_t)> const& _task)
+{
+	if (m_workers.empty() || _count <= 1)
+	{
+		for (size_t i = 0; i < _count; ++i)
+			_task(i);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_task = &_task;
+		m_count = _count;
+		m_next = 0;
+		m_errors.assign(_count, nullptr);
+		m_activeWorkers = m_workers.size();
+		++m_batch;
+	}
+	m_batchStarted.notify_all();
+	runTasks();
+	{
+		unique_lock<mutex> lock(m_mutex);
+		m_batchFinished.wait(lock, [&]() { return m_activeWorkers == 0; });
+		m_task = nullptr;
+	}
+
+	for (exception_ptr const& error: m_errors)
+		if (error)
+			rethrow_exception(error);
+}
+
+void WorkerPool::work()
+{
+	size_t batch = 0;
+	while (true)
+	{
+		{
+			unique_lock<mutex> lock(m_mutex);
+			m_batchStarted.wait(lock, [&]() { return m_stopping || m_batch != batch; });
+			if (m_stopping)
+				return;
+			batch = m_batch;
+		}
+		runTasks();
+		lock_guard<mutex> lock(m_mutex);
+		if (--m_activeWorkers == 0)
+			m_batchFinished.notify_all();
+	}
+}
+
+void WorkerPool::runTasks()
+{
+	for (size_t i = m_next++; i < m_count; i = m_next++)
+		try
+		{
+			(*m_task)(i);
+		}
+		catch (...)
+		{
+			m_errors[i] = current_exception();
+		}
+}
+
+void dev::parallelFor(size_t _count, size_t _threads, function<void(size_t)> const& _task)
+{
+	WorkerPool(min(_threads, _count)).parallelFor(_count, _task);
+}
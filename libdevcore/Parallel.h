@@ -0,0 +1,85 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Helpers for running independent tasks concurrently.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dev
+{
+
+/**
+ * Set of worker threads that is kept alive between batches of tasks, so that
+ * threads are not started and thread-local state is not rebuilt for every batch.
+ */
+class WorkerPool
+{
+public:
+	/// Starts @a _threads - 1 worker threads, the thread calling parallelFor also runs tasks.
+	explicit WorkerPool(size_t _threads);
+	~WorkerPool();
+	WorkerPool(WorkerPool const&) = delete;
+	WorkerPool& operator=(WorkerPool const&) = delete;
+
+	/// @returns the number of threads running tasks, including the calling thread.
+	size_t threads() const { return m_workers.size() + 1; }
+
+	/// Calls @a _task for each index in [0, _count) using the threads of the pool.
+	/// Returns once all tasks have finished.
+	/// If tasks throw, the exception of the task with the smallest index is rethrown,
+	/// so the behaviour does not depend on the number of threads.
+	/// Must not be called concurrently or from within a task.
+	void parallelFor(size_t _count, std::function<void(size_t)> const& _task);
+
+private:
+	void work();
+	/// Runs tasks of the current batch until none are left.
+	void runTasks();
+
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_batchStarted;
+	std::condition_variable m_batchFinished;
+	/// Number of the current batch, workers wait for it to change.
+	size_t m_batch = 0;
+	/// Number of workers that did not finish the current batch yet.
+	size_t m_activeWorkers = 0;
+	bool m_stopping = false;
+
+	std::function<void(size_t)> const* m_task = nullptr;
+	size_t m_count = 0;
+	std::atomic<size_t> m_next{0};
+	std::vector<std::exception_ptr> m_errors;
+};
+
+/// Calls @a _task for each index in [0, _count), using up to @a _threads threads
+/// (including the calling thread). Returns once all tasks have finished.
+/// If tasks throw, the exception of the task with the smallest index is rethrown,
+/// so the behaviour does not depend on the number of threads.
+/// Starts new threads, use a WorkerPool to run several batches.
+void parallelFor(size_t _count, size_t _threads, std::function<void(size_t)> const& _task);
+
+}
@@ -26,6 +26,7 @@
 #include <libevmasm/PeepholeOptimiser.h>
 #include <libevmasm/JumpdestRemover.h>
 #include <libevmasm/BlockDeduplicator.h>
+#include <libevmasm/JumpThreader.h>
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/GasMeter.h>
 
@@ -58,6 +59,13 @@ void Assembly::append(Assembly const& _a)
 		append(i);
 	}
 	m_deposit = newDeposit;
+	for (auto const& table: _a.m_tagTables)
+	{
+		vector<size_t> tags;
+		for (size_t tag: table.second)
+			tags.push_back(tag + m_usedTags);
+		m_tagTables[table.first] = move(tags);
+	}
 	m_usedTags += _a.m_usedTags;
 	// This does not transfer the names of named tags on purpose. The tags themselves are
 	// transferred, but their names are only available inside the assembly.
@@ -112,7 +120,7 @@ unsigned Assembly::bytesRequired(unsigned subTagSize) const
 namespace
 {
 
-string locationFromSources(StringMap const& _sourceCodes, SourceLocation const& _location)
+string locationFromSources(SharedSourceMap const& _sourceCodes, SourceLocation const& _location)
 {
 	if (_location.isEmpty() || !_location.source.get() || _sourceCodes.empty() || _location.start >= _location.end || _location.start < 0)
 		return "";
@@ -121,7 +129,7 @@ string locationFromSources(StringMap const& _sourceCodes, SourceLocation const&
 	if (it == _sourceCodes.end())
 		return "";
 
-	string const& source = it->second;
+	string const& source = *it->second;
 	if (size_t(_location.start) >= source.size())
 		return "";
 
@@ -136,7 +144,7 @@ string locationFromSources(StringMap const& _sourceCodes, SourceLocation const&
 class Functionalizer
 {
 public:
-	Functionalizer (ostream& _out, string const& _prefix, StringMap const& _sourceCodes):
+	Functionalizer (ostream& _out, string const& _prefix, SharedSourceMap const& _sourceCodes):
 		m_out(_out), m_prefix(_prefix), m_sourceCodes(_sourceCodes)
 	{}
 
@@ -203,12 +211,12 @@ private:
 
 	ostream& m_out;
 	string const& m_prefix;
-	StringMap const& m_sourceCodes;
+	SharedSourceMap const& m_sourceCodes;
 };
 
 }
 
-void Assembly::assemblyStream(ostream& _out, string const& _prefix, StringMap const& _sourceCodes) const
+void Assembly::assemblyStream(ostream& _out, string const& _prefix, SharedSourceMap const& _sourceCodes) const
 {
 	Functionalizer f(_out, _prefix, _sourceCodes);
 
@@ -216,12 +224,19 @@ void Assembly::assemblyStream(ostream& _out, string const& _prefix, StringMap co
 		f.feed(i);
 	f.flush();
 
-	if (!m_data.empty() || !m_subs.empty())
+	if (!m_data.empty() || !m_tagTables.empty() || !m_subs.empty())
 	{
 		_out << _prefix << "stop" << endl;
 		for (auto const& i: m_data)
 			if (u256(i.first) >= m_subs.size())
 				_out << _prefix << "data_" << toHex(u256(i.first)) << " " << toHex(i.second) << endl;
+		for (auto const& table: m_tagTables)
+		{
+			_out << _prefix << "data_" << toHex(u256(table.first)) << " tags";
+			for (size_t tag: table.second)
+				_out << " tag_" << tag;
+			_out << endl;
+		}
 
 		for (size_t i = 0; i < m_subs.size(); ++i)
 		{
@@ -235,7 +250,7 @@ void Assembly::assemblyStream(ostream& _out, string const& _prefix, StringMap co
 		_out << endl << _prefix << "auxdata: 0x" << toHex(m_auxiliaryData) << endl;
 }
 
-string Assembly::assemblyString(StringMap const& _sourceCodes) const
+string Assembly::assemblyString(SharedSourceMap const& _sourceCodes) const
 {
 	ostringstream tmp;
 	assemblyStream(tmp, "", _sourceCodes);
@@ -262,7 +277,7 @@ string Assembly::toStringInHex(u256 _value)
 	return hexStr.str();
 }
 
-Json::Value Assembly::assemblyJSON(StringMap const& _sourceCodes) const
+Json::Value Assembly::assemblyJSON(SharedSourceMap const& _sourceCodes) const
 {
 	Json::Value root;
 
@@ -327,12 +342,18 @@ Json::Value Assembly::assemblyJSON(StringMap const& _sourceCodes) const
 		}
 	}
 
-	if (!m_data.empty() || !m_subs.empty())
+	if (!m_data.empty() || !m_tagTables.empty() || !m_subs.empty())
 	{
 		Json::Value& data = root[".data"] = Json::objectValue;
 		for (auto const& i: m_data)
 			if (u256(i.first) >= m_subs.size())
 				data[toStringInHex((u256)i.first)] = toHex(i.second);
+		for (auto const& table: m_tagTables)
+		{
+			Json::Value& tags = data[toStringInHex((u256)table.first)] = Json::arrayValue;
+			for (size_t tag: table.second)
+				tags.append(dev::toString(tag));
+		}
 
 		for (size_t i = 0; i < m_subs.size(); ++i)
 		{
@@ -363,6 +384,22 @@ AssemblyItem Assembly::newPushLibraryAddress(string const& _identifier)
 	return AssemblyItem{PushLibraryAddress, h};
 }
 
+AssemblyItem Assembly::newTagTable(vector<AssemblyItem> const& _tags)
+{
+	vector<size_t> tags;
+	string identifier = "tags";
+	for (AssemblyItem const& tag: _tags)
+	{
+		auto subAndTag = tag.splitForeignPushTag();
+		assertThrow(subAndTag.first == size_t(-1), AssemblyException, "Foreign tag in tag table.");
+		tags.push_back(subAndTag.second);
+		identifier += " " + to_string(subAndTag.second);
+	}
+	h256 h(dev::keccak256(identifier));
+	m_tagTables[h] = move(tags);
+	return AssemblyItem{PushData, h};
+}
+
 Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreation, size_t _runs)
 {
 	OptimiserSettings settings;
@@ -382,6 +419,51 @@ Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreat
 }
 
 
+namespace
+{
+
+/// @returns the tag of this assembly that is pushed immediately before the jump at position
+/// @a _jump of @a _items or size_t(-1) if the jump target is not known in that way.
+size_t directJumpTarget(AssemblyItems const& _items, size_t _jump)
+{
+	AssemblyItem const& jump = _items.at(_jump);
+	if (
+		_jump == 0 ||
+		jump.type() != Operation ||
+		(jump.instruction() != Instruction::JUMP && jump.instruction() != Instruction::JUMPI) ||
+		_items.at(_jump - 1).type() != PushTag
+	)
+		return size_t(-1);
+	auto subAndTag = _items.at(_jump - 1).splitForeignPushTag();
+	return subAndTag.first == size_t(-1) ? subAndTag.second : size_t(-1);
+}
+
+/// @returns the number of direct jumps (see above) to each tag of @a _items that can only be
+/// entered through such jumps or by falling through. Tags that are pushed for any other purpose
+/// or are contained in @a _escapingTags can be the target of any jump and are omitted.
+map<size_t, size_t> countDirectJumps(AssemblyItems const& _items, set<size_t> _escapingTags)
+{
+	map<size_t, size_t> directJumps;
+	for (size_t i = 0; i < _items.size(); ++i)
+		if (_items[i].type() == Tag)
+			directJumps[size_t(_items[i].data())];
+		else if (_items[i].type() == PushTag)
+		{
+			auto subAndTag = _items[i].splitForeignPushTag();
+			if (subAndTag.first != size_t(-1))
+				continue;
+			if (i + 1 < _items.size() && directJumpTarget(_items, i + 1) == subAndTag.second)
+				directJumps[subAndTag.second]++;
+			else
+				_escapingTags.insert(subAndTag.second);
+		}
+	for (size_t tag: _escapingTags)
+		directJumps.erase(tag);
+	return directJumps;
+}
+
+}
+
 Assembly& Assembly::optimise(OptimiserSettings const& _settings)
 {
 	optimiseInternal(_settings, {});
@@ -415,8 +497,11 @@ map<u256, u256> Assembly::optimiseInternal(
 
 		if (_settings.runJumpdestRemover)
 		{
+			set<size_t> referencedTags = _tagsReferencedFromOutside;
+			for (auto const& table: m_tagTables)
+				referencedTags.insert(table.second.begin(), table.second.end());
 			JumpdestRemover jumpdestOpt{m_items};
-			if (jumpdestOpt.optimise(_tagsReferencedFromOutside))
+			if (jumpdestOpt.optimise(referencedTags))
 				count++;
 		}
 
@@ -430,6 +515,15 @@ map<u256, u256> Assembly::optimiseInternal(
 			}
 		}
 
+		// This only modifies PushTags and moves blocks, the peephole optimiser and the jumpdest
+		// remover have to run again to remove the jumps and tags that became unnecessary.
+		if (_settings.runDeduplicate)
+		{
+			JumpThreader threader{m_items};
+			if (threader.optimise())
+				count++;
+		}
+
 		// This only modifies PushTags, we have to run again to actually remove code.
 		if (_settings.runDeduplicate)
 		{
@@ -452,6 +546,10 @@ map<u256, u256> Assembly::optimiseInternal(
 					if (_tagsReferencedFromOutside.erase(size_t(replacement.first)))
 						_tagsReferencedFromOutside.insert(size_t(replacement.second));
 				}
+				for (auto& table: m_tagTables)
+					for (size_t& tag: table.second)
+						if (dedup.replacedTags().count(tag))
+							tag = size_t(dedup.replacedTags().at(tag));
 				count++;
 			}
 		}
@@ -461,15 +559,30 @@ map<u256, u256> Assembly::optimiseInternal(
 			// Control flow graph optimization has been here before but is disabled because it
 			// assumes we only jump to tags that are pushed. This is not the case anymore with
 			// function types that can be stored in storage.
+			// Instead, knowledge is only carried over into a block if all ways to enter it are known
+			// and were analysed before, i.e. if its tag does not escape and is only jumped to from
+			// preceding code.
 			AssemblyItems optimisedItems;
 
 			bool usesMSize = (find(m_items.begin(), m_items.end(), AssemblyItem{Instruction::MSIZE}) != m_items.end());
+			// Removing memory accesses across blocks could change the value of MSIZE.
+			bool propagateKnowledge = !usesMSize;
+
+			set<size_t> escapingTags = _tagsReferencedFromOutside;
+			for (auto const& table: m_tagTables)
+				escapingTags.insert(table.second.begin(), table.second.end());
+			map<size_t, size_t> directJumps = countDirectJumps(m_items, escapingTags);
+			map<size_t, vector<KnownState>> statesAtJumps;
+			// All states have to share the expression classes to be comparable.
+			auto expressionClasses = make_shared<ExpressionClasses>();
+			KnownState state{expressionClasses};
 
 			auto iter = m_items.begin();
 			while (iter != m_items.end())
 			{
-				KnownState emptyState;
-				CommonSubexpressionEliminator eliminator{emptyState};
+				if (!propagateKnowledge)
+					state = KnownState{};
+				CommonSubexpressionEliminator eliminator{state};
 				auto orig = iter;
 				iter = eliminator.feedItems(iter, m_items.end(), usesMSize);
 				bool shouldReplace = false;
@@ -497,6 +610,53 @@ map<u256, u256> Assembly::optimiseInternal(
 				}
 				else
 					copy(orig, iter, back_inserter(optimisedItems));
+
+				if (!propagateKnowledge)
+					continue;
+				for (auto it = orig; it != iter; ++it)
+					state.feedItem(*it);
+				size_t lastIndex = size_t(iter - m_items.begin()) - 1;
+				AssemblyItem const& last = m_items[lastIndex];
+				if (last.type() == Tag)
+				{
+					size_t tag = size_t(last.data());
+					vector<KnownState> states;
+					if (directJumps.count(tag) && statesAtJumps[tag].size() == directJumps.at(tag))
+					{
+						states = move(statesAtJumps[tag]);
+						AssemblyItem const* previous = lastIndex > 0 ? &m_items[lastIndex - 1] : nullptr;
+						if (!previous || !(
+							*previous == AssemblyItem(Instruction::JUMP) ||
+							SemanticInformation::terminatesControlFlow(*previous)
+						))
+							states.push_back(state);
+					}
+					state = KnownState{expressionClasses};
+					if (!states.empty())
+					{
+						state = move(states.front());
+						for (size_t i = 1; i < states.size(); ++i)
+							state.reduceToCommonKnowledge(states[i], true);
+						if (states.size() > 1)
+							state.renewUnknownStackElements();
+						state.clearTagUnions();
+					}
+					statesAtJumps.erase(tag);
+				}
+				else if (last == AssemblyItem(Instruction::JUMP) || last == AssemblyItem(Instruction::JUMPI))
+				{
+					size_t target = directJumpTarget(m_items, lastIndex);
+					if (directJumps.count(target))
+						statesAtJumps[target].push_back(state);
+					if (last == AssemblyItem(Instruction::JUMP))
+						state = KnownState{expressionClasses};
+				}
+				else if (
+					SemanticInformation::terminatesControlFlow(last) ||
+					last == AssemblyItem(Instruction::JUMPDEST)
+				)
+					state = KnownState{expressionClasses};
+				state.removeUnavailableKnowledge();
 			}
 			if (optimisedItems.size() < m_items.size())
 			{
@@ -511,7 +671,8 @@ map<u256, u256> Assembly::optimiseInternal(
 			_settings.isCreation,
 			_settings.isCreation ? 1 : _settings.expectedExecutionsPerDeployment,
 			_settings.evmVersion,
-			*this
+			*this,
+			_settings.isCreation ? nullptr : _settings.executionProfile.get()
 		);
 
 	return tagReplacements;
@@ -545,6 +706,8 @@ LinkerObject const& Assembly::assemble() const
 	unsigned bytesRequiredIncludingData = bytesRequiredForCode + 1 + m_auxiliaryData.size();
 	for (auto const& sub: m_subs)
 		bytesRequiredIncludingData += sub->assemble().bytecode.size();
+	for (auto const& table: m_tagTables)
+		bytesRequiredIncludingData += 2 * table.second.size();
 
 	unsigned bytesPerDataRef = dev::bytesRequired(bytesRequiredIncludingData);
 	uint8_t dataRefPush = (uint8_t)Instruction::PUSH1 - 1 + bytesPerDataRef;
@@ -640,7 +803,7 @@ LinkerObject const& Assembly::assemble() const
 		}
 	}
 
-	if (!m_subs.empty() || !m_data.empty() || !m_auxiliaryData.empty())
+	if (!m_subs.empty() || !m_data.empty() || !m_tagTables.empty() || !m_auxiliaryData.empty())
 		// Append an INVALID here to help tests find miscompilation.
 		ret.bytecode.push_back(uint8_t(Instruction::INVALID));
 
@@ -685,6 +848,26 @@ LinkerObject const& Assembly::assemble() const
 		}
 		ret.bytecode += dataItem.second;
 	}
+	for (auto const& table: m_tagTables)
+	{
+		auto references = dataRef.equal_range(table.first);
+		if (references.first == references.second)
+			continue;
+		for (auto ref = references.first; ref != references.second; ++ref)
+		{
+			bytesRef r(ret.bytecode.data() + ref->second, bytesPerDataRef);
+			toBigEndian(ret.bytecode.size(), r);
+		}
+		for (size_t tag: table.second)
+		{
+			assertThrow(tag < m_tagPositionsInBytecode.size(), AssemblyException, "Reference to non-existing tag.");
+			size_t pos = m_tagPositionsInBytecode[tag];
+			assertThrow(pos != size_t(-1), AssemblyException, "Reference to tag without position.");
+			assertThrow(pos <= 0xffff, AssemblyException, "Tag too large for tag table.");
+			ret.bytecode.push_back(uint8_t(pos >> 8));
+			ret.bytecode.push_back(uint8_t(pos));
+		}
+	}
 
 	ret.bytecode += m_auxiliaryData;
 
@@ -22,6 +22,7 @@
 #include <libevmasm/AssemblyItem.h>
 #include <libevmasm/LinkerObject.h>
 #include <libevmasm/Exceptions.h>
+#include <libevmasm/ExecutionProfile.h>
 
 #include <liblangutil/EVMVersion.h>
 
@@ -51,6 +52,11 @@ public:
 	AssemblyItem namedTag(std::string const& _name);
 	AssemblyItem newData(bytes const& _data) { h256 h(dev::keccak256(asString(_data))); m_data[h] = _data; return AssemblyItem(PushData, h); }
 	bytes const& data(h256 const& _i) const { return m_data.at(_i); }
+	/// @returns a reference to a table in the data section that holds the code positions of the
+	/// given tags, each encoded in two bytes (big endian).
+	AssemblyItem newTagTable(std::vector<AssemblyItem> const& _tags);
+	/// @returns the tag tables of this assembly, keyed by the data reference that points to them.
+	std::map<h256, std::vector<size_t>> const& tagTables() const { return m_tagTables; }
 	AssemblyItem newSub(AssemblyPointer const& _sub) { m_subs.push_back(_sub); return AssemblyItem(PushSub, m_subs.size() - 1); }
 	Assembly const& sub(size_t _sub) const { return *m_subs.at(_sub); }
 	Assembly& sub(size_t _sub) { return *m_subs.at(_sub); }
@@ -111,6 +117,9 @@ public:
 		/// This specifies an estimate on how often each opcode in this assembly will be executed,
 		/// i.e. use a small value to optimise for size and a large value to optimise for runtime gas usage.
 		size_t expectedExecutionsPerDeployment = 200;
+		/// Execution counts of parts of the code that override expectedExecutionsPerDeployment
+		/// for the runtime code, can be nullptr.
+		std::shared_ptr<ExecutionProfile const> executionProfile;
 	};
 
 	/// Modify and return the current assembly such that creation and execution gas usage
@@ -126,17 +135,17 @@ public:
 
 	/// Create a text representation of the assembly.
 	std::string assemblyString(
-		StringMap const& _sourceCodes = StringMap()
+		langutil::SharedSourceMap const& _sourceCodes = langutil::SharedSourceMap()
 	) const;
 	void assemblyStream(
 		std::ostream& _out,
 		std::string const& _prefix = "",
-		StringMap const& _sourceCodes = StringMap()
+		langutil::SharedSourceMap const& _sourceCodes = langutil::SharedSourceMap()
 	) const;
 
 	/// Create a JSON representation of the assembly.
 	Json::Value assemblyJSON(
-		StringMap const& _sourceCodes = StringMap()
+		langutil::SharedSourceMap const& _sourceCodes = langutil::SharedSourceMap()
 	) const;
 
 public:
@@ -169,6 +178,8 @@ protected:
 	std::map<std::string, size_t> m_namedTags;
 	AssemblyItems m_items;
 	std::map<h256, bytes> m_data;
+	/// Tables of jump destinations, filled with the positions of the tags during assembly.
+	std::map<h256, std::vector<size_t>> m_tagTables;
 	/// Data that is appended to the very end of the contract.
 	bytes m_auxiliaryData;
 	std::vector<std::shared_ptr<Assembly>> m_subs;
@@ -156,7 +156,10 @@ AssemblyItems CSECodeGenerator::generateCode(
 	set<pair<unsigned, Id>> sequencedExpressions;
 	for (auto const& p: m_neededBy)
 		for (auto id: {p.first, p.second})
-			if (unsigned seqNr = m_expressionClasses.representative(id).sequenceNumber)
+			if (m_classPositions.count(id))
+				// Already on the stack, possibly computed before the initial sequence number.
+				continue;
+			else if (unsigned seqNr = m_expressionClasses.representative(id).sequenceNumber)
 			{
 				if (seqNr < _initialSequenceNumber)
 					// Invalid sequenced operation.
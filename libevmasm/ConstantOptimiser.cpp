@@ -22,6 +22,11 @@
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/Assembly.h>
 #include <libevmasm/GasMeter.h>
+#include <libevmasm/ExecutionProfile.h>
+
+#include <mutex>
+#include <tuple>
+
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
@@ -30,7 +35,8 @@ unsigned ConstantOptimisationMethod::optimiseConstants(
 	bool _isCreation,
 	size_t _runs,
 	langutil::EVMVersion _evmVersion,
-	Assembly& _assembly
+	Assembly& _assembly,
+	ExecutionProfile const* _profile
 )
 {
 	// TODO: design the optimiser in a way this is not needed
@@ -38,9 +44,14 @@ unsigned ConstantOptimisationMethod::optimiseConstants(
 
 	unsigned optimisations = 0;
 	map<AssemblyItem, size_t> pushes;
+	// Sum of the expected executions of all occurrences of a constant.
+	map<AssemblyItem, bigint> executions;
 	for (AssemblyItem const& item: _items)
 		if (item.type() == Push)
+		{
 			pushes[item]++;
+			executions[item] += _profile ? _profile->executions(item.location(), _runs) : _runs;
+		}
 	map<u256, AssemblyItems> pendingReplacements;
 	for (auto it: pushes)
 	{
@@ -50,7 +61,8 @@ unsigned ConstantOptimisationMethod::optimiseConstants(
 		Params params;
 		params.multiplicity = it.second;
 		params.isCreation = _isCreation;
-		params.runs = _runs;
+		// Use the average over all occurrences, which is just @a _runs without a profile.
+		params.runs = size_t((executions[item] + it.second - 1) / it.second);
 		params.evmVersion = _evmVersion;
 		LiteralMethod lit(params, item.data());
 		bigint literalGas = lit.gasNeeded();
@@ -185,14 +197,87 @@ AssemblyItems const& CodeCopyMethod::copyRoutine()
 	return copyRoutine;
 }
 
+namespace
+{
+
+/// Process-wide cache of the results of ComputeMethod, keyed by the value and all parameters
+/// the search depends on.
+class RepresentationCache
+{
+public:
+	using Key = tuple<u256, langutil::EVMVersion, bool, size_t, size_t>;
+
+	static RepresentationCache& instance()
+	{
+		static RepresentationCache cache;
+		return cache;
+	}
+
+	bool lookup(Key const& _key, AssemblyItems& _routine) const
+	{
+		lock_guard<mutex> lock(m_mutex);
+		auto it = m_routines.find(_key);
+		if (it == m_routines.end())
+			return false;
+		_routine = it->second;
+		++m_hits;
+		return true;
+	}
+
+	size_t hits() const
+	{
+		lock_guard<mutex> lock(m_mutex);
+		return m_hits;
+	}
+
+	void store(Key const& _key, AssemblyItems const& _routine)
+	{
+		lock_guard<mutex> lock(m_mutex);
+		// Keep memory bounded in long-running processes.
+		if (m_routines.size() >= c_maxEntries)
+			m_routines.clear();
+		m_routines[_key] = _routine;
+	}
+
+private:
+	static size_t const c_maxEntries = 0x10000;
+
+	mutable mutex m_mutex;
+	map<Key, AssemblyItems> m_routines;
+	mutable size_t m_hits = 0;
+};
+
+}
+
+size_t ComputeMethod::cacheHits()
+{
+	return RepresentationCache::instance().hits();
+}
+
 AssemblyItems ComputeMethod::findRepresentation(u256 const& _value)
+{
+	RepresentationCache::Key key{_value, m_params.evmVersion, m_params.isCreation, m_params.runs, m_params.multiplicity};
+	AssemblyItems routine;
+	if (!RepresentationCache::instance().lookup(key, routine))
+	{
+		routine = findRepresentation(_value, c_maxDepth);
+		RepresentationCache::instance().store(key, routine);
+	}
+	return routine;
+}
+
+AssemblyItems ComputeMethod::findRepresentation(u256 const& _value, unsigned _depth)
 {
 	if (_value < 0x10000)
 		// Very small value, not worth computing
 		return AssemblyItems{_value};
 	else if (dev::bytesRequired(~_value) < dev::bytesRequired(_value))
 		// Negated is shorter to represent
-		return findRepresentation(~_value) + AssemblyItems{Instruction::NOT};
+		return findRepresentation(~_value, _depth) + AssemblyItems{Instruction::NOT};
+	else if (_depth == 0)
+		return AssemblyItems{_value};
+	else if (m_representations.count({_value, _depth}))
+		return m_representations.at({_value, _depth});
 	else
 	{
 		// Decompose value into a * 2**k + b where abs(b) << 2**k
@@ -220,17 +305,17 @@ AssemblyItems ComputeMethod::findRepresentation(u256 const& _value)
 
 			AssemblyItems newRoutine;
 			if (lowerPart != 0)
-				newRoutine += findRepresentation(u256(abs(lowerPart)));
+				newRoutine += findRepresentation(u256(abs(lowerPart)), _depth - 1);
 			if (m_params.evmVersion.hasBitwiseShifting())
 			{
-				newRoutine += findRepresentation(upperPart);
+				newRoutine += findRepresentation(upperPart, _depth - 1);
 				newRoutine += AssemblyItems{u256(bits), Instruction::SHL};
 			}
 			else
 			{
 				newRoutine += AssemblyItems{u256(bits), u256(2), Instruction::EXP};
 				if (upperPart != 1)
-					newRoutine += findRepresentation(upperPart) + AssemblyItems{Instruction::MUL};
+					newRoutine += findRepresentation(upperPart, _depth - 1) + AssemblyItems{Instruction::MUL};
 			}
 			if (lowerPart > 0)
 				newRoutine += AssemblyItems{Instruction::ADD};
@@ -246,6 +331,7 @@ AssemblyItems ComputeMethod::findRepresentation(u256 const& _value)
 				routine = move(newRoutine);
 			}
 		}
+		m_representations[{_value, _depth}] = routine;
 		return routine;
 	}
 }
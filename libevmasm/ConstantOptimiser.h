@@ -29,6 +29,7 @@
 #include <libdevcore/CommonData.h>
 #include <libdevcore/CommonIO.h>
 
+#include <map>
 #include <vector>
 
 namespace dev
@@ -39,6 +40,7 @@ namespace eth
 class AssemblyItem;
 using AssemblyItems = std::vector<AssemblyItem>;
 class Assembly;
+class ExecutionProfile;
 
 /**
  * Abstract base class for one way to change how constants are represented in the code.
@@ -48,12 +50,15 @@ class ConstantOptimisationMethod
 public:
 	/// Tries to optimised how constants are represented in the source code and modifies
 	/// @a _assembly.
+	/// If @a _profile is given, the number of runs of each occurrence of a constant is
+	/// taken from the profile based on its source location, with @a _runs as default.
 	/// @returns zero if no optimisations could be performed.
 	static unsigned optimiseConstants(
 		bool _isCreation,
 		size_t _runs,
 		langutil::EVMVersion _evmVersion,
-		Assembly& _assembly
+		Assembly& _assembly,
+		ExecutionProfile const* _profile = nullptr
 	);
 
 protected:
@@ -130,6 +135,10 @@ protected:
 
 /**
  * Method that tries to compute the constant.
+ *
+ * The best representation found for a value under given parameters is stored in a cache that
+ * is shared by all instances in the process, since the same constants (masks, selectors, ...)
+ * appear in many contracts.
  */
 class ComputeMethod: public ConstantOptimisationMethod
 {
@@ -151,15 +160,25 @@ public:
 		return m_routine;
 	}
 
+	/// @returns the number of representations taken from the cache so far. Intended for testing.
+	static size_t cacheHits();
+
 protected:
-	/// Tries to recursively find a way to compute @a _value.
+	/// @returns the cached representation of @a _value or searches for one and caches it.
 	AssemblyItems findRepresentation(u256 const& _value);
+	/// Tries to recursively find a way to compute @a _value, decomposing it
+	/// at most @a _depth times in a row.
+	AssemblyItems findRepresentation(u256 const& _value, unsigned _depth);
 	/// Recomputes the value from the calculated representation and checks for correctness.
 	bool checkRepresentation(u256 const& _value, AssemblyItems const& _routine) const;
 	bigint gasNeeded(AssemblyItems const& _routine) const;
 
+	/// Maximum number of nested decompositions. Deeper nesting hardly ever pays off.
+	static unsigned const c_maxDepth = 3;
 	/// Counter for the complexity of optimization, will stop when it reaches zero.
 	size_t m_maxSteps = 10000;
+	/// Best representations of the parts of the value found so far, keyed by value and depth.
+	std::map<std::pair<u256, unsigned>, AssemblyItems> m_representations;
 	AssemblyItems m_routine;
 };
 
@@ -0,0 +1,113 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Recorded execution counts of source ranges, used to tune the optimiser per piece of code.
+ */
+
+#include <libevmasm/ExecutionProfile.h>
+
+#include <libevmasm/Exceptions.h>
+
+#include <libdevcore/Assertions.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+ExecutionProfile ExecutionProfile::fromJson(Json::Value const& _profile)
+{
+	assertThrow(_profile.isObject(), InvalidExecutionProfile, "The execution profile has to be an object.");
+
+	ExecutionProfile profile;
+	for (auto const& sourceName: _profile.getMemberNames())
+	{
+		Json::Value const& ranges = _profile[sourceName];
+		assertThrow(
+			ranges.isObject(),
+			InvalidExecutionProfile,
+			"The execution counts of \"" + sourceName + "\" have to be an object."
+		);
+		for (auto const& range: ranges.getMemberNames())
+		{
+			vector<string> parts;
+			boost::split(parts, range, boost::is_any_of(":"));
+			auto isNumber = [](string const& _s) {
+				return !_s.empty() && _s.size() < 10 && all_of(_s.begin(), _s.end(), [](char _c) { return isdigit(static_cast<unsigned char>(_c)); });
+			};
+			assertThrow(
+				parts.size() == 2 && isNumber(parts[0]) && isNumber(parts[1]),
+				InvalidExecutionProfile,
+				"Invalid source range \"" + range + "\" in the execution profile of \"" + sourceName + "\"."
+			);
+			assertThrow(
+				ranges[range].isUInt(),
+				InvalidExecutionProfile,
+				"The execution count of \"" + range + "\" in \"" + sourceName + "\" has to be an unsigned number."
+			);
+			int start = stoi(parts[0]);
+			profile.add(sourceName, start, start + stoi(parts[1]), ranges[range].asUInt());
+		}
+	}
+	return profile;
+}
+
+Json::Value ExecutionProfile::toJson() const
+{
+	Json::Value profile{Json::objectValue};
+	for (auto const& source: m_ranges)
+	{
+		profile[source.first] = Json::objectValue;
+		for (Range const& range: source.second)
+			profile[source.first][to_string(range.start) + ":" + to_string(range.end - range.start)] =
+				Json::Value(Json::LargestUInt(range.executions));
+	}
+	return profile;
+}
+
+void ExecutionProfile::add(string const& _sourceName, int _start, int _end, size_t _executions)
+{
+	m_ranges[_sourceName].emplace_back(Range{_start, _end, _executions});
+}
+
+size_t ExecutionProfile::executions(langutil::SourceLocation const& _location, size_t _default) const
+{
+	if (!_location.source || _location.start < 0 || _location.end < _location.start)
+		return _default;
+	auto ranges = m_ranges.find(_location.source->name());
+	if (ranges == m_ranges.end())
+		return _default;
+
+	Range const* innermost = nullptr;
+	for (Range const& range: ranges->second)
+		if (
+			range.start <= _location.start &&
+			_location.end <= range.end &&
+			(!innermost || range.end - range.start < innermost->end - innermost->start)
+		)
+			innermost = &range;
+	return innermost ? innermost->executions : _default;
+}
+
+bool ExecutionProfile::operator==(ExecutionProfile const& _other) const
+{
+	return m_ranges == _other.m_ranges;
+}
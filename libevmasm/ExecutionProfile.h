@@ -0,0 +1,86 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Recorded execution counts of source ranges, used to tune the optimiser per piece of code.
+ */
+
+#pragma once
+
+#include <liblangutil/SourceLocation.h>
+
+#include <json/json.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * Execution counts of source ranges, e.g. derived from transaction traces and source maps.
+ *
+ * The optimiser uses the count of the innermost range that contains a piece of code as the
+ * expected number of executions of that code instead of the global number of runs. Code
+ * outside of all ranges still uses the global number of runs.
+ *
+ * The JSON representation maps source unit names to objects that map ranges in the
+ * ``<start>:<length>`` format of source mappings to execution counts:
+ *
+ * { "contract.sol": { "120:453": 10000, "580:90": 3 } }
+ */
+class ExecutionProfile
+{
+public:
+	/// Parses the JSON representation described above.
+	/// Throws InvalidExecutionProfile if @a _profile is malformed.
+	static ExecutionProfile fromJson(Json::Value const& _profile);
+	Json::Value toJson() const;
+
+	/// Records that the code in the range [@a _start, @a _end) of @a _sourceName was executed
+	/// @a _executions times.
+	void add(std::string const& _sourceName, int _start, int _end, size_t _executions);
+
+	/// @returns the execution count of the innermost range that contains @a _location or
+	/// @a _default if there is no such range.
+	size_t executions(langutil::SourceLocation const& _location, size_t _default) const;
+
+	bool empty() const { return m_ranges.empty(); }
+
+	bool operator==(ExecutionProfile const& _other) const;
+	bool operator!=(ExecutionProfile const& _other) const { return !operator==(_other); }
+
+private:
+	struct Range
+	{
+		int start;
+		int end;
+		size_t executions;
+
+		bool operator==(Range const& _other) const
+		{
+			return start == _other.start && end == _other.end && executions == _other.executions;
+		}
+	};
+
+	std::map<std::string, std::vector<Range>> m_ranges;
+};
+
+}
+}
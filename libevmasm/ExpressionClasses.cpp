@@ -47,19 +47,20 @@ bool ExpressionClasses::Expression::operator<(ExpressionClasses::Expression cons
 	{
 		auto instr = item->instruction();
 		auto otherInstr = _other.item->instruction();
-		return std::tie(instr, arguments, sequenceNumber) <
-			std::tie(otherInstr, _other.arguments, _other.sequenceNumber);
+		return std::tie(instr, arguments, sequenceNumber, origin) <
+			std::tie(otherInstr, _other.arguments, _other.sequenceNumber, _other.origin);
 	}
 	else
-		return std::tie(item->data(), arguments, sequenceNumber) <
-			std::tie(_other.item->data(), _other.arguments, _other.sequenceNumber);
+		return std::tie(item->data(), arguments, sequenceNumber, origin) <
+			std::tie(_other.item->data(), _other.arguments, _other.sequenceNumber, _other.origin);
 }
 
 ExpressionClasses::Id ExpressionClasses::find(
 	AssemblyItem const& _item,
 	Ids const& _arguments,
 	bool _copyItem,
-	unsigned _sequenceNumber
+	unsigned _sequenceNumber,
+	Id _origin
 )
 {
 	Expression exp;
@@ -67,6 +68,7 @@ ExpressionClasses::Id ExpressionClasses::find(
 	exp.item = &_item;
 	exp.arguments = _arguments;
 	exp.sequenceNumber = _sequenceNumber;
+	exp.origin = _origin;
 
 	if (SemanticInformation::isCommutativeOperation(_item))
 		sort(exp.arguments.begin(), exp.arguments.end());
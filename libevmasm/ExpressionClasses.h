@@ -61,7 +61,9 @@ public:
 		Ids arguments;
 		/// Storage modification sequence, only used for storage and memory operations.
 		unsigned sequenceNumber = 0;
-		/// Behaves as if this was a tuple of (item->type(), item->data(), arguments, sequenceNumber).
+		/// Distinguishes unknown values (UndefinedItem) that are otherwise equal, zero for all other expressions.
+		Id origin = 0;
+		/// Behaves as if this was a tuple of (item->type(), item->data(), arguments, sequenceNumber, origin).
 		bool operator<(Expression const& _other) const;
 	};
 
@@ -70,11 +72,13 @@ public:
 	/// @param _copyItem if true, copies the assembly item to an internal storage instead of just
 	/// keeping a pointer.
 	/// The @a _sequenceNumber indicates the current storage or memory access sequence.
+	/// The @a _origin distinguishes unknown values that are otherwise equal.
 	Id find(
 		AssemblyItem const& _item,
 		Ids const& _arguments = {},
 		bool _copyItem = true,
-		unsigned _sequenceNumber = 0
+		unsigned _sequenceNumber = 0,
+		Id _origin = 0
 	);
 	/// @returns the canonical representative of an expression class.
 	Expression const& representative(Id _id) const { return m_representatives.at(_id); }
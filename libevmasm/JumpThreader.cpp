@@ -0,0 +1,165 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Threads jumps through trivial blocks and reorders blocks so that jumps
+ * become fall-throughs.
+ */
+
+#include <libevmasm/JumpThreader.h>
+
+#include <libevmasm/AssemblyItem.h>
+#include <libevmasm/SemanticInformation.h>
+
+#include <map>
+#include <set>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+/// @returns the local tag pushed by @a _item or size_t(-1) if it is not a push of a local tag.
+size_t pushedLocalTag(AssemblyItem const& _item)
+{
+	if (_item.type() != PushTag)
+		return size_t(-1);
+	auto subAndTag = _item.splitForeignPushTag();
+	return subAndTag.first == size_t(-1) ? subAndTag.second : size_t(-1);
+}
+
+/// @returns true if the control flow never continues after @a _item.
+bool endsSegment(AssemblyItem const& _item)
+{
+	return _item == AssemblyItem(Instruction::JUMP) || SemanticInformation::terminatesControlFlow(_item);
+}
+
+}
+
+bool JumpThreader::optimise()
+{
+	bool threaded = threadJumps();
+	bool reordered = layoutBlocks();
+	return threaded || reordered;
+}
+
+bool JumpThreader::threadJumps()
+{
+	map<size_t, size_t> tagPositions;
+	for (size_t i = 0; i < m_items.size(); ++i)
+		if (m_items[i].type() == Tag)
+			tagPositions[size_t(m_items[i].data())] = i;
+
+	// @returns the tag where the control flow ends up after jumping to @a _tag without
+	// executing anything but JUMPDESTs and direct jumps.
+	auto finalTarget = [&](size_t _tag) -> size_t
+	{
+		set<size_t> visited{_tag};
+		size_t target = _tag;
+		while (tagPositions.count(target))
+		{
+			size_t position = tagPositions.at(target) + 1;
+			while (position < m_items.size() && m_items[position].type() == Tag)
+				target = size_t(m_items[position++].data());
+			if (
+				position + 1 >= m_items.size() ||
+				m_items[position + 1] != AssemblyItem(Instruction::JUMP) ||
+				pushedLocalTag(m_items[position]) == size_t(-1)
+			)
+				break;
+			target = pushedLocalTag(m_items[position]);
+			// Keep endless loops as they are.
+			if (!visited.insert(target).second)
+				return _tag;
+		}
+		return target;
+	};
+
+	bool changed = false;
+	for (size_t i = 1; i < m_items.size(); ++i)
+	{
+		if (m_items[i] != AssemblyItem(Instruction::JUMP) && m_items[i] != AssemblyItem(Instruction::JUMPI))
+			continue;
+		size_t tag = pushedLocalTag(m_items[i - 1]);
+		if (tag == size_t(-1))
+			continue;
+		size_t target = finalTarget(tag);
+		if (target != tag)
+		{
+			m_items[i - 1].setPushTagSubIdAndTag(size_t(-1), target);
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+bool JumpThreader::layoutBlocks()
+{
+	// Segments are ranges of items that are only entered at their beginning (apart from jumps
+	// to tags inside) and the control flow does not leave them by running off their end,
+	// with the possible exception of the last segment.
+	vector<pair<size_t, size_t>> segments;
+	for (size_t i = 0; i < m_items.size(); ++i)
+		if (segments.empty() || endsSegment(m_items[i - 1]))
+			segments.emplace_back(i, i + 1);
+		else
+			segments.back().second = i + 1;
+
+	map<size_t, size_t> segmentAtTag;
+	for (size_t i = 1; i < segments.size(); ++i)
+	{
+		AssemblyItem const& first = m_items[segments[i].first];
+		if (first.type() == Tag && endsSegment(m_items[segments[i].second - 1]))
+			segmentAtTag[size_t(first.data())] = i;
+	}
+
+	// @returns the segment that the segment @a _index jumps to unconditionally at its end,
+	// if it can be moved directly behind it.
+	auto successor = [&](size_t _index) -> size_t
+	{
+		size_t end = segments[_index].second;
+		if (end - segments[_index].first < 2 || m_items[end - 1] != AssemblyItem(Instruction::JUMP))
+			return size_t(-1);
+		size_t tag = pushedLocalTag(m_items[end - 2]);
+		return segmentAtTag.count(tag) ? segmentAtTag.at(tag) : size_t(-1);
+	};
+
+	vector<size_t> order;
+	vector<bool> placed(segments.size(), false);
+	for (size_t i = 0; i < segments.size(); ++i)
+		for (size_t segment = i; segment != size_t(-1) && !placed[segment]; segment = successor(segment))
+		{
+			placed[segment] = true;
+			order.push_back(segment);
+		}
+
+	bool changed = false;
+	for (size_t i = 0; i < order.size(); ++i)
+		if (order[i] != i)
+			changed = true;
+	if (!changed)
+		return false;
+
+	AssemblyItems items;
+	items.reserve(m_items.size());
+	for (size_t segment: order)
+		for (size_t i = segments[segment].first; i < segments[segment].second; ++i)
+			items.push_back(move(m_items[i]));
+	m_items = move(items);
+	return true;
+}
@@ -0,0 +1,72 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Threads jumps through trivial blocks and reorders blocks so that jumps
+ * become fall-throughs.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+
+class AssemblyItem;
+using AssemblyItems = std::vector<AssemblyItem>;
+
+/**
+ * Optimizer class that works on the jumps of the control flow graph.
+ * Modifies the passed vector in place.
+ *
+ * Jump threading: A tag that is pushed directly before a JUMP or JUMPI is replaced by the
+ * final target if the block at the tag does nothing but jump to another tag unconditionally
+ * (``tag: PUSH tag2 JUMP``) or consists only of tags and falls through. Only the push
+ * directly in front of the jump is modified, so all other uses of the tag (which might escape
+ * by being stored or referenced from outside) still reach the original block.
+ *
+ * Block layout: The code is split into segments at instructions that do not continue to the
+ * next instruction. A segment that starts with a tag and ends in such an instruction is moved
+ * directly behind the first segment that ends in an unconditional direct jump to this tag.
+ * The jump then jumps to the next item and is removed by the peephole optimiser.
+ * Since segments are only entered by jumping to their tags, moving them is always safe.
+ * The first segment and a segment that runs off the end of the code are never moved.
+ */
+class JumpThreader
+{
+public:
+	explicit JumpThreader(AssemblyItems& _items): m_items(_items) {}
+
+	/// @returns true if something was changed
+	bool optimise();
+
+private:
+	/// Retargets direct jumps into trivial blocks.
+	/// @returns true if something was changed
+	bool threadJumps();
+	/// Reorders segments to maximise fall-through.
+	/// @returns true if something was changed
+	bool layoutBlocks();
+
+	AssemblyItems& m_items;
+};
+
+}
+}
@@ -154,7 +154,13 @@ KnownState::StoreOperation KnownState::feedItem(AssemblyItem const& _item, bool
 				bool invStor = SemanticInformation::invalidatesStorage(_item.instruction());
 				// We could be a bit more fine-grained here (CALL only invalidates part of
 				// memory, etc), but we do not for now.
-				if (invMem)
+				if (
+					_item.instruction() == Instruction::CALLDATACOPY ||
+					_item.instruction() == Instruction::CODECOPY ||
+					_item.instruction() == Instruction::RETURNDATACOPY
+				)
+					invalidateMemory(arguments.at(0), arguments.at(2));
+				else if (invMem)
 					resetMemory();
 				if (invStor)
 					resetStorage();
@@ -226,10 +232,46 @@ void KnownState::reduceToCommonKnowledge(KnownState const& _other, bool _combine
 
 	intersect(m_storageContent, _other.m_storageContent);
 	intersect(m_memoryContent, _other.m_memoryContent);
+	intersect(m_knownKeccak256Hashes, _other.m_knownKeccak256Hashes);
 	if (_combineSequenceNumbers)
 		m_sequenceNumber = max(m_sequenceNumber, _other.m_sequenceNumber);
 }
 
+void KnownState::removeUnavailableKnowledge()
+{
+	map<Id, bool> available;
+	for (auto const& stackElement: m_stackElements)
+		available[stackElement.second] = true;
+	function<bool(Id)> isAvailable = [&](Id _id)
+	{
+		if (available.count(_id))
+			return available.at(_id);
+		ExpressionClasses::Expression const& expr = m_expressionClasses->representative(_id);
+		bool result =
+			expr.item &&
+			expr.item->type() != UndefinedItem &&
+			expr.sequenceNumber == 0 &&
+			(expr.item->type() != Operation || SemanticInformation::movable(expr.item->instruction())) &&
+			all_of(expr.arguments.begin(), expr.arguments.end(), isAvailable);
+		return available[_id] = result;
+	};
+	auto removeUnavailable = [&](map<Id, Id>& _content)
+	{
+		for (auto it = _content.begin(); it != _content.end();)
+			if (isAvailable(it->first) && isAvailable(it->second))
+				++it;
+			else
+				it = _content.erase(it);
+	};
+	removeUnavailable(m_storageContent);
+	removeUnavailable(m_memoryContent);
+	for (auto it = m_knownKeccak256Hashes.begin(); it != m_knownKeccak256Hashes.end();)
+		if (isAvailable(it->second))
+			++it;
+		else
+			it = m_knownKeccak256Hashes.erase(it);
+}
+
 bool KnownState::operator==(KnownState const& _other) const
 {
 	if (m_storageContent != _other.m_storageContent || m_memoryContent != _other.m_memoryContent)
@@ -249,7 +291,7 @@ ExpressionClasses::Id KnownState::stackElement(int _stackHeight, SourceLocation
 		return m_stackElements.at(_stackHeight);
 	// Stack element not found (not assigned yet), create new unknown equivalence class.
 	return m_stackElements[_stackHeight] =
-			m_expressionClasses->find(AssemblyItem(UndefinedItem, _stackHeight, _location));
+			m_expressionClasses->find(AssemblyItem(UndefinedItem, _stackHeight, _location), {}, true, 0, m_stackOrigin);
 }
 
 KnownState::Id KnownState::relativeStackElement(int _stackOffset, SourceLocation const& _location)
@@ -353,6 +395,26 @@ ExpressionClasses::Id KnownState::loadFromMemory(Id _slot, SourceLocation const&
 	return m_memoryContent[_slot] = m_expressionClasses->find(item, {_slot}, true, m_sequenceNumber);
 }
 
+void KnownState::invalidateMemory(Id _offset, Id _length)
+{
+	u256 const* offset = m_expressionClasses->knownConstant(_offset);
+	u256 const* length = m_expressionClasses->knownConstant(_length);
+	if (!offset || !length)
+	{
+		resetMemory();
+		return;
+	}
+	bigint start = *offset;
+	bigint end = start + *length;
+	decltype(m_memoryContent) memoryContents;
+	// copy over values at constant slots that do not overlap the modified range
+	for (auto const& memoryItem: m_memoryContent)
+		if (u256 const* slot = m_expressionClasses->knownConstant(memoryItem.first))
+			if (*length == 0 || bigint(*slot) + 32 <= start || end <= bigint(*slot))
+				memoryContents.insert(memoryItem);
+	m_memoryContent = move(memoryContents);
+}
+
 KnownState::Id KnownState::applyKeccak256(
 	Id _start,
 	Id _length,
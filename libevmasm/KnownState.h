@@ -112,6 +112,15 @@ public:
 	/// relatively.
 	/// @param _combineSequenceNumbers if true, sets the sequence number to the maximum of both
 	void reduceToCommonKnowledge(KnownState const& _other, bool _combineSequenceNumbers);
+	/// Removes all knowledge about storage, memory and Keccak-256 hashes that involves values
+	/// which are neither on the stack nor can be recomputed from constants and other such values.
+	/// Afterwards, the state can be used as the initial state of a new piece of code.
+	void removeUnavailableKnowledge();
+	/// Turns all stack elements that are not explicitly known into new unknown values that are
+	/// different from all values known so far. Unknown stack elements are only identified by
+	/// their height, so this has to be used after joining states that might have different
+	/// values at the same height.
+	void renewUnknownStackElements() { m_stackOrigin = m_expressionClasses->newClass({}); }
 
 	/// @returns a shared pointer to a copy of this state.
 	std::shared_ptr<KnownState> copy() const { return std::make_shared<KnownState>(*this); }
@@ -156,6 +165,9 @@ private:
 	StoreOperation storeInMemory(Id _slot, Id _value, langutil::SourceLocation const& _location);
 	/// Retrieves the current value at the given slot in memory or creates a new special mload class.
 	Id loadFromMemory(Id _slot, langutil::SourceLocation const& _location);
+	/// Deletes all memory information that might be overwritten by copying @a _length bytes
+	/// to memory at @a _offset.
+	void invalidateMemory(Id _offset, Id _length);
 	/// Finds or creates a new expression that applies the Keccak-256 hash function to the contents in memory.
 	Id applyKeccak256(Id _start, Id _length, langutil::SourceLocation const& _location);
 
@@ -166,6 +178,9 @@ private:
 	int m_stackHeight = 0;
 	/// Current stack layout, mapping stack height -> equivalence class
 	std::map<int, Id> m_stackElements;
+	/// Distinguishes unknown stack elements from those at the same height before the last call to
+	/// renewUnknownStackElements. Zero or an expression class that is only used for this purpose.
+	Id m_stackOrigin = 0;
 	/// Current sequence number, this is incremented with each modification to storage or memory.
 	unsigned m_sequenceNumber = 1;
 	/// Knowledge about storage content.
@@ -27,8 +27,12 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
-PathGasMeter::PathGasMeter(AssemblyItems const& _items, langutil::EVMVersion _evmVersion):
-	m_items(_items), m_evmVersion(_evmVersion)
+PathGasMeter::PathGasMeter(
+	AssemblyItems const& _items,
+	langutil::EVMVersion _evmVersion,
+	map<h256, vector<size_t>> _tagTables
+):
+	m_tagTables(move(_tagTables)), m_items(_items), m_evmVersion(_evmVersion)
 {
 	for (size_t i = 0; i < m_items.size(); ++i)
 		if (m_items[i].type() == Tag)
@@ -82,6 +86,9 @@ GasMeter::GasConsumption PathGasMeter::handleQueueItem()
 		return gas;
 
 	set<u256> jumpTags;
+	// Tags that can be loaded from a tag table in the current block. The code generator only
+	// uses tag tables for computed jumps inside the block that references the table.
+	set<u256> tableTags;
 	for (; index < m_items.size() && !gas.isInfinite; ++index)
 	{
 		bool branchStops = false;
@@ -94,11 +101,32 @@ GasMeter::GasConsumption PathGasMeter::handleQueueItem()
 			if (path->visitedJumpdests.count(index))
 				return GasMeter::GasConsumption::infinite();
 			path->visitedJumpdests.insert(index);
+			tableTags.clear();
+		}
+		else if (item.type() == PushData && m_tagTables.count(h256(item.data())))
+		{
+			for (size_t tag: m_tagTables.at(h256(item.data())))
+				tableTags.insert(tag);
+		}
+		else if (item == AssemblyItem(Instruction::CODECOPY) && !tableTags.empty())
+		{
+			ExpressionClasses::Id offset = state->relativeStackElement(-1);
+			for (auto const& table: m_tagTables)
+			{
+				set<u256> tags = tagsInTable(*state, table.first, offset);
+				if (!tags.empty())
+				{
+					tableTags = move(tags);
+					break;
+				}
+			}
 		}
 		else if (item == AssemblyItem(Instruction::JUMP))
 		{
 			branchStops = true;
 			jumpTags = state->tagsInExpression(state->relativeStackElement(0));
+			if (jumpTags.empty())
+				jumpTags = tableTags;
 			if (jumpTags.empty()) // unknown jump destination
 				return GasMeter::GasConsumption::infinite();
 		}
@@ -137,3 +165,39 @@ GasMeter::GasConsumption PathGasMeter::handleQueueItem()
 
 	return gas;
 }
+
+set<u256> PathGasMeter::tagsInTable(KnownState& _state, h256 const& _table, ExpressionClasses::Id _offset) const
+{
+	ExpressionClasses& classes = _state.expressionClasses();
+	auto isTable = [&](ExpressionClasses::Id _id) {
+		AssemblyItem const* item = classes.representative(_id).item;
+		return item && item->type() == PushData && h256(item->data()) == _table;
+	};
+	vector<size_t> const& tags = m_tagTables.at(_table);
+
+	// Offsets of the form "table + constant" select a single entry, other offsets into the
+	// table can select any of them.
+	u256 entryOffset;
+	ExpressionClasses::Expression const& expr = classes.representative(_offset);
+	if (isTable(_offset))
+		entryOffset = 0;
+	else if (expr.item && *expr.item == Instruction::ADD && expr.arguments.size() == 2)
+	{
+		ExpressionClasses::Id table = expr.arguments[0];
+		ExpressionClasses::Id constant = expr.arguments[1];
+		if (!isTable(table))
+			swap(table, constant);
+		if (!isTable(table))
+			return set<u256>();
+		if (u256 const* value = classes.knownConstant(constant))
+			entryOffset = *value;
+		else
+			return set<u256>(tags.begin(), tags.end());
+	}
+	else
+		return set<u256>();
+
+	if (entryOffset % 2 != 0 || entryOffset / 2 >= tags.size())
+		return set<u256>(tags.begin(), tags.end());
+	return set<u256>{tags[size_t(entryOffset / 2)]};
+}
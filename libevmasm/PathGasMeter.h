@@ -25,6 +25,9 @@
 
 #include <liblangutil/EVMVersion.h>
 
+#include <libdevcore/FixedHash.h>
+
+#include <map>
 #include <set>
 #include <vector>
 #include <memory>
@@ -53,7 +56,13 @@ struct GasPath
 class PathGasMeter
 {
 public:
-	explicit PathGasMeter(AssemblyItems const& _items, langutil::EVMVersion _evmVersion);
+	/// @param _tagTables the tag tables of the assembly (see Assembly::tagTables), used to
+	/// resolve jumps to destinations that are loaded from such a table.
+	explicit PathGasMeter(
+		AssemblyItems const& _items,
+		langutil::EVMVersion _evmVersion,
+		std::map<h256, std::vector<size_t>> _tagTables = {}
+	);
 
 	GasMeter::GasConsumption estimateMax(size_t _startIndex, std::shared_ptr<KnownState> const& _state);
 
@@ -61,10 +70,11 @@ public:
 		AssemblyItems const& _items,
 		langutil::EVMVersion _evmVersion,
 		size_t _startIndex,
-		std::shared_ptr<KnownState> const& _state
+		std::shared_ptr<KnownState> const& _state,
+		std::map<h256, std::vector<size_t>> _tagTables = {}
 	)
 	{
-		return PathGasMeter(_items, _evmVersion).estimateMax(_startIndex, _state);
+		return PathGasMeter(_items, _evmVersion, std::move(_tagTables)).estimateMax(_startIndex, _state);
 	}
 
 private:
@@ -74,12 +84,16 @@ private:
 	/// point in time, but it greatly reduces computational overhead.
 	void queue(std::unique_ptr<GasPath>&& _newPath);
 	GasMeter::GasConsumption handleQueueItem();
+	/// @returns the tags that can be loaded by a CODECOPY from the given code offset, which
+	/// references the tag table @a _table.
+	std::set<u256> tagsInTable(KnownState& _state, h256 const& _table, ExpressionClasses::Id _offset) const;
 
 	/// Map of jumpdest -> gas path, so not really a queue. We only have one queued up
 	/// item per jumpdest, because of the behaviour of `queue` above.
 	std::map<size_t, std::unique_ptr<GasPath>> m_queue;
 	std::map<size_t, GasMeter::GasConsumption> m_highestGasUsagePerJumpdest;
 	std::map<u256, size_t> m_tagPositions;
+	std::map<h256, std::vector<size_t>> m_tagTables;
 	AssemblyItems const& m_items;
 	langutil::EVMVersion m_evmVersion;
 };
@@ -53,6 +53,8 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
 #include <tuple>
 
@@ -63,18 +65,22 @@ namespace langutil
  * Bidirectional stream of characters.
  *
  * This CharStream is used by lexical analyzers as the source.
+ * The source text is kept in an immutable buffer that can be shared with other
+ * CharStreams and with the consumers of the source text, so that it is never copied.
  */
 class CharStream
 {
 public:
 	CharStream() = default;
-	explicit CharStream(std::string const& _source, std::string const& name):
-		m_source(_source), m_name(name) {}
+	explicit CharStream(std::string _source, std::string _name):
+		m_source(std::make_shared<std::string const>(std::move(_source))), m_name(std::move(_name)) {}
+	explicit CharStream(std::shared_ptr<std::string const> _source, std::string _name):
+		m_source(std::move(_source)), m_name(std::move(_name)) {}
 
 	int position() const { return m_position; }
-	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_position + _charsForward) >= m_source.size(); }
+	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_position + _charsForward) >= m_source->size(); }
 
-	char get(size_t _charsForward = 0) const { return m_source[m_position + _charsForward]; }
+	char get(size_t _charsForward = 0) const { return (*m_source)[m_position + _charsForward]; }
 	char advanceAndGet(size_t _chars = 1);
 	/// Sets scanner position to @ _amount characters backwards in source text.
 	/// @returns The character of the current location after update is returned.
@@ -86,7 +92,9 @@ public:
 
 	void reset() { m_position = 0; }
 
-	std::string const& source() const noexcept { return m_source; }
+	std::string const& source() const noexcept { return *m_source; }
+	/// @returns the buffer holding the source text, which can be shared without copying it.
+	std::shared_ptr<std::string const> const& sharedSource() const noexcept { return m_source; }
 	std::string const& name() const noexcept { return m_name; }
 
 	///@{
@@ -98,9 +106,12 @@ public:
 	///@}
 
 private:
-	std::string m_source;
+	std::shared_ptr<std::string const> m_source = std::make_shared<std::string const>();
 	std::string m_name;
 	size_t m_position{0};
 };
 
+/// Source texts by source name, sharing the buffers of their CharStreams.
+using SharedSourceMap = std::map<std::string, std::shared_ptr<std::string const>>;
+
 }
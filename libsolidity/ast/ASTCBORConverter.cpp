@@ -0,0 +1,977 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Converts the AST into a compact binary format.
+ */
+
+#include <libsolidity/ast/ASTCBORConverter.h>
+
+#include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTJsonConverter.h>
+#include <libyul/AsmData.h>
+#include <libyul/AsmPrinter.h>
+#include <liblangutil/Exceptions.h>
+
+#include <libdevcore/CommonData.h>
+#include <libdevcore/UTF8.h>
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+
+#include <cstring>
+
+using namespace std;
+using namespace langutil;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace
+{
+
+/// Tag marking the scope of a string reference table.
+uint64_t const c_stringRefNamespaceTag = 256;
+/// Tag of a reference to a string in the table.
+uint64_t const c_stringRefTag = 25;
+
+}
+
+bytes ASTCBORConverter::toCBOR(ASTNode const& _node)
+{
+	m_data.clear();
+	m_stringTable.clear();
+	appendHead(MajorType::Tag, c_stringRefNamespaceTag);
+	appendNode(_node);
+	solAssert(m_openNodes.empty(), "");
+	return std::move(m_data);
+}
+
+bytes ASTCBORConverter::toCBOR(Json::Value const& _json)
+{
+	ASTCBORConverter converter;
+	converter.appendHead(MajorType::Tag, c_stringRefNamespaceTag);
+	converter.appendValue(_json);
+	return std::move(converter.m_data);
+}
+
+bool ASTCBORConverter::visit(SourceUnit const& _node)
+{
+	beginNode(_node, "SourceUnit");
+	key("absolutePath");
+	appendString(_node.annotation().path);
+	key("exportedSymbols");
+	appendHead(MajorType::Map, _node.annotation().exportedSymbols.size());
+	for (auto const& symbol: _node.annotation().exportedSymbols)
+	{
+		appendString(symbol.first);
+		appendIds(symbol.second);
+	}
+	key("nodes");
+	appendNodes(_node.nodes());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(PragmaDirective const& _node)
+{
+	beginNode(_node, "PragmaDirective");
+	key("literals");
+	appendHead(MajorType::Array, _node.literals().size());
+	for (auto const& literal: _node.literals())
+		appendString(literal);
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ImportDirective const& _node)
+{
+	beginNode(_node, "ImportDirective");
+	key("file");
+	appendString(_node.path());
+	key("absolutePath");
+	appendString(_node.annotation().absolutePath);
+	key("sourceUnit");
+	appendInteger(_node.annotation().sourceUnit->id());
+	key("scope");
+	appendIdOrNull(_node.scope());
+	key("unitAlias");
+	appendString(_node.name());
+	key("symbolAliases");
+	appendHead(MajorType::Array, _node.symbolAliases().size());
+	for (auto const& symbolAlias: _node.symbolAliases())
+	{
+		solAssert(symbolAlias.first, "");
+		appendHead(MajorType::Map, 2);
+		appendString("foreign");
+		appendInteger(symbolAlias.first->id());
+		appendString("local");
+		if (symbolAlias.second)
+			appendString(*symbolAlias.second);
+		else
+			appendNull();
+	}
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ContractDefinition const& _node)
+{
+	beginNode(_node, "ContractDefinition");
+	key("name");
+	appendString(_node.name());
+	key("documentation");
+	appendDocumentation(_node.documentation());
+	key("contractKind");
+	appendString(ASTJsonConverter::contractKind(_node.contractKind()));
+	key("fullyImplemented");
+	appendBool(_node.annotation().unimplementedFunctions.empty());
+	key("linearizedBaseContracts");
+	appendIds(_node.annotation().linearizedBaseContracts);
+	key("baseContracts");
+	appendNodes(_node.baseContracts());
+	key("contractDependencies");
+	appendIds(_node.annotation().contractDependencies);
+	key("nodes");
+	appendNodes(_node.subNodes());
+	key("scope");
+	appendIdOrNull(_node.scope());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(InheritanceSpecifier const& _node)
+{
+	beginNode(_node, "InheritanceSpecifier");
+	key("baseName");
+	appendNode(_node.name());
+	key("arguments");
+	if (_node.arguments())
+		appendNodes(*_node.arguments());
+	else
+		appendNull();
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(UsingForDirective const& _node)
+{
+	beginNode(_node, "UsingForDirective");
+	key("libraryName");
+	appendNode(_node.libraryName());
+	key("typeName");
+	appendNodeOrNull(_node.typeName());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(StructDefinition const& _node)
+{
+	beginNode(_node, "StructDefinition");
+	key("name");
+	appendString(_node.name());
+	key("visibility");
+	appendString(Declaration::visibilityToString(_node.visibility()));
+	key("canonicalName");
+	appendString(_node.annotation().canonicalName);
+	key("members");
+	appendNodes(_node.members());
+	key("scope");
+	appendIdOrNull(_node.scope());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(EnumDefinition const& _node)
+{
+	beginNode(_node, "EnumDefinition");
+	key("name");
+	appendString(_node.name());
+	key("canonicalName");
+	appendString(_node.annotation().canonicalName);
+	key("members");
+	appendNodes(_node.members());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(EnumValue const& _node)
+{
+	beginNode(_node, "EnumValue");
+	key("name");
+	appendString(_node.name());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ParameterList const& _node)
+{
+	beginNode(_node, "ParameterList");
+	key("parameters");
+	appendNodes(_node.parameters());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(FunctionDefinition const& _node)
+{
+	beginNode(_node, "FunctionDefinition");
+	key("name");
+	appendString(_node.name());
+	key("documentation");
+	appendDocumentation(_node.documentation());
+	key("kind");
+	appendString(_node.isConstructor() ? "constructor" : (_node.isFallback() ? "fallback" : "function"));
+	key("stateMutability");
+	appendString(stateMutabilityToString(_node.stateMutability()));
+	key("superFunction");
+	appendIdOrNull(_node.annotation().superFunction);
+	key("visibility");
+	appendString(Declaration::visibilityToString(_node.visibility()));
+	key("parameters");
+	appendNode(_node.parameterList());
+	key("returnParameters");
+	appendNode(*_node.returnParameterList());
+	key("modifiers");
+	appendNodes(_node.modifiers());
+	key("body");
+	appendNodeOrNull(_node.isImplemented() ? &_node.body() : nullptr);
+	key("implemented");
+	appendBool(_node.isImplemented());
+	key("scope");
+	appendIdOrNull(_node.scope());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(VariableDeclaration const& _node)
+{
+	beginNode(_node, "VariableDeclaration");
+	key("name");
+	appendString(_node.name());
+	key("typeName");
+	appendNodeOrNull(_node.typeName());
+	key("constant");
+	appendBool(_node.isConstant());
+	key("stateVariable");
+	appendBool(_node.isStateVariable());
+	key("storageLocation");
+	appendString(ASTJsonConverter::location(_node.referenceLocation()));
+	key("visibility");
+	appendString(Declaration::visibilityToString(_node.visibility()));
+	key("value");
+	appendNodeOrNull(_node.value().get());
+	key("scope");
+	appendIdOrNull(_node.scope());
+	key("typeDescriptions");
+	appendTypeDescriptions(_node.annotation().type, true);
+	if (m_inEvent)
+	{
+		key("indexed");
+		appendBool(_node.isIndexed());
+	}
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ModifierDefinition const& _node)
+{
+	beginNode(_node, "ModifierDefinition");
+	key("name");
+	appendString(_node.name());
+	key("documentation");
+	appendDocumentation(_node.documentation());
+	key("visibility");
+	appendString(Declaration::visibilityToString(_node.visibility()));
+	key("parameters");
+	appendNode(_node.parameterList());
+	key("body");
+	appendNode(_node.body());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ModifierInvocation const& _node)
+{
+	beginNode(_node, "ModifierInvocation");
+	key("modifierName");
+	appendNode(*_node.name());
+	key("arguments");
+	if (_node.arguments())
+		appendNodes(*_node.arguments());
+	else
+		appendNull();
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(EventDefinition const& _node)
+{
+	m_inEvent = true;
+	beginNode(_node, "EventDefinition");
+	key("name");
+	appendString(_node.name());
+	key("documentation");
+	appendDocumentation(_node.documentation());
+	key("parameters");
+	appendNode(_node.parameterList());
+	key("anonymous");
+	appendBool(_node.isAnonymous());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ElementaryTypeName const& _node)
+{
+	beginNode(_node, "ElementaryTypeName");
+	key("name");
+	appendString(_node.typeName().toString());
+	key("typeDescriptions");
+	appendTypeDescriptions(_node.annotation().type, true);
+	if (_node.stateMutability())
+	{
+		key("stateMutability");
+		appendString(stateMutabilityToString(*_node.stateMutability()));
+	}
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(UserDefinedTypeName const& _node)
+{
+	beginNode(_node, "UserDefinedTypeName");
+	key("name");
+	appendString(ASTJsonConverter::namePathToString(_node.namePath()));
+	key("referencedDeclaration");
+	appendIdOrNull(_node.annotation().referencedDeclaration);
+	key("contractScope");
+	appendIdOrNull(_node.annotation().contractScope);
+	key("typeDescriptions");
+	appendTypeDescriptions(_node.annotation().type, true);
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(FunctionTypeName const& _node)
+{
+	beginNode(_node, "FunctionTypeName");
+	key("visibility");
+	appendString(Declaration::visibilityToString(_node.visibility()));
+	key("stateMutability");
+	appendString(stateMutabilityToString(_node.stateMutability()));
+	key("parameterTypes");
+	appendNode(*_node.parameterTypeList());
+	key("returnParameterTypes");
+	appendNode(*_node.returnParameterTypeList());
+	key("typeDescriptions");
+	appendTypeDescriptions(_node.annotation().type, true);
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Mapping const& _node)
+{
+	beginNode(_node, "Mapping");
+	key("keyType");
+	appendNode(_node.keyType());
+	key("valueType");
+	appendNode(_node.valueType());
+	key("typeDescriptions");
+	appendTypeDescriptions(_node.annotation().type, true);
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ArrayTypeName const& _node)
+{
+	beginNode(_node, "ArrayTypeName");
+	key("baseType");
+	appendNode(_node.baseType());
+	key("length");
+	appendNodeOrNull(_node.length());
+	key("typeDescriptions");
+	appendTypeDescriptions(_node.annotation().type, true);
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(InlineAssembly const& _node)
+{
+	beginNode(_node, "InlineAssembly");
+	key("operations");
+	appendString(yul::AsmPrinter()(_node.operations()));
+	key("externalReferences");
+	size_t references = 0;
+	for (auto const& reference: _node.annotation().externalReferences)
+		if (reference.first)
+			references++;
+	appendHead(MajorType::Array, references);
+	for (auto const& reference: _node.annotation().externalReferences)
+		if (reference.first)
+		{
+			appendHead(MajorType::Map, 1);
+			appendString(reference.first->name.str());
+			appendHead(MajorType::Map, 5);
+			appendString("src");
+			appendSourceLocation(reference.first->location);
+			appendString("declaration");
+			appendIdOrNull(reference.second.declaration);
+			appendString("isSlot");
+			appendBool(reference.second.isSlot);
+			appendString("isOffset");
+			appendBool(reference.second.isOffset);
+			appendString("valueSize");
+			appendHead(MajorType::UnsignedInteger, reference.second.valueSize);
+		}
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Block const& _node)
+{
+	beginNode(_node, "Block");
+	key("statements");
+	appendNodes(_node.statements());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(PlaceholderStatement const& _node)
+{
+	beginNode(_node, "PlaceholderStatement");
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(IfStatement const& _node)
+{
+	beginNode(_node, "IfStatement");
+	key("condition");
+	appendNode(_node.condition());
+	key("trueBody");
+	appendNode(_node.trueStatement());
+	key("falseBody");
+	appendNodeOrNull(_node.falseStatement());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(WhileStatement const& _node)
+{
+	beginNode(_node, _node.isDoWhile() ? "DoWhileStatement" : "WhileStatement");
+	key("condition");
+	appendNode(_node.condition());
+	key("body");
+	appendNode(_node.body());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ForStatement const& _node)
+{
+	beginNode(_node, "ForStatement");
+	key("initializationExpression");
+	appendNodeOrNull(_node.initializationExpression());
+	key("condition");
+	appendNodeOrNull(_node.condition());
+	key("loopExpression");
+	appendNodeOrNull(_node.loopExpression());
+	key("body");
+	appendNode(_node.body());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Continue const& _node)
+{
+	beginNode(_node, "Continue");
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Break const& _node)
+{
+	beginNode(_node, "Break");
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Return const& _node)
+{
+	beginNode(_node, "Return");
+	key("expression");
+	appendNodeOrNull(_node.expression());
+	key("functionReturnParameters");
+	appendIdOrNull(_node.annotation().functionReturnParameters);
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Throw const& _node)
+{
+	beginNode(_node, "Throw");
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(EmitStatement const& _node)
+{
+	beginNode(_node, "EmitStatement");
+	key("eventCall");
+	appendNode(_node.eventCall());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(VariableDeclarationStatement const& _node)
+{
+	beginNode(_node, "VariableDeclarationStatement");
+	key("assignments");
+	appendHead(MajorType::Array, _node.declarations().size());
+	for (auto const& declaration: _node.declarations())
+		appendIdOrNull(declaration.get());
+	key("declarations");
+	appendNodes(_node.declarations());
+	key("initialValue");
+	appendNodeOrNull(_node.initialValue());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ExpressionStatement const& _node)
+{
+	beginNode(_node, "ExpressionStatement");
+	key("expression");
+	appendNode(_node.expression());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Conditional const& _node)
+{
+	beginNode(_node, "Conditional");
+	key("condition");
+	appendNode(_node.condition());
+	key("trueExpression");
+	appendNode(_node.trueExpression());
+	key("falseExpression");
+	appendNode(_node.falseExpression());
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Assignment const& _node)
+{
+	beginNode(_node, "Assignment");
+	key("operator");
+	appendString(TokenTraits::toString(_node.assignmentOperator()));
+	key("leftHandSide");
+	appendNode(_node.leftHandSide());
+	key("rightHandSide");
+	appendNode(_node.rightHandSide());
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(TupleExpression const& _node)
+{
+	beginNode(_node, "TupleExpression");
+	key("isInlineArray");
+	appendBool(_node.isInlineArray());
+	key("components");
+	appendNodes(_node.components());
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(UnaryOperation const& _node)
+{
+	beginNode(_node, "UnaryOperation");
+	key("prefix");
+	appendBool(_node.isPrefixOperation());
+	key("operator");
+	appendString(TokenTraits::toString(_node.getOperator()));
+	key("subExpression");
+	appendNode(_node.subExpression());
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(BinaryOperation const& _node)
+{
+	beginNode(_node, "BinaryOperation");
+	key("operator");
+	appendString(TokenTraits::toString(_node.getOperator()));
+	key("leftExpression");
+	appendNode(_node.leftExpression());
+	key("rightExpression");
+	appendNode(_node.rightExpression());
+	key("commonType");
+	appendTypeDescriptions(_node.annotation().commonType);
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(FunctionCall const& _node)
+{
+	beginNode(_node, "FunctionCall");
+	key("expression");
+	appendNode(_node.expression());
+	key("names");
+	appendHead(MajorType::Array, _node.names().size());
+	for (auto const& name: _node.names())
+		appendString(*name);
+	key("arguments");
+	appendNodes(_node.arguments());
+	key("kind");
+	appendString(ASTJsonConverter::functionCallKind(_node.annotation().kind));
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(NewExpression const& _node)
+{
+	beginNode(_node, "NewExpression");
+	key("typeName");
+	appendNode(_node.typeName());
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(MemberAccess const& _node)
+{
+	beginNode(_node, "MemberAccess");
+	key("memberName");
+	appendString(_node.memberName());
+	key("expression");
+	appendNode(_node.expression());
+	key("referencedDeclaration");
+	appendIdOrNull(_node.annotation().referencedDeclaration);
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(IndexAccess const& _node)
+{
+	beginNode(_node, "IndexAccess");
+	key("baseExpression");
+	appendNode(_node.baseExpression());
+	key("indexExpression");
+	appendNodeOrNull(_node.indexExpression());
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Identifier const& _node)
+{
+	beginNode(_node, "Identifier");
+	key("name");
+	appendString(_node.name());
+	key("referencedDeclaration");
+	appendIdOrNull(_node.annotation().referencedDeclaration);
+	key("overloadedDeclarations");
+	appendIds(_node.annotation().overloadedDeclarations);
+	key("typeDescriptions");
+	appendTypeDescriptions(_node.annotation().type);
+	key("argumentTypes");
+	appendArgumentTypes(_node.annotation().arguments);
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(ElementaryTypeNameExpression const& _node)
+{
+	beginNode(_node, "ElementaryTypeNameExpression");
+	key("typeName");
+	appendString(_node.typeName().toString());
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+bool ASTCBORConverter::visit(Literal const& _node)
+{
+	beginNode(_node, "Literal");
+	key("kind");
+	appendString(ASTJsonConverter::literalTokenKind(_node.token()));
+	key("value");
+	if (dev::validateUTF8(_node.value()))
+		appendString(_node.value());
+	else
+		appendNull();
+	key("hexValue");
+	appendString(toHex(asBytes(_node.value())));
+	key("subdenomination");
+	Token subdenomination = Token(_node.subDenomination());
+	if (subdenomination == Token::Illegal)
+		appendNull();
+	else
+		appendString(TokenTraits::toString(subdenomination));
+	appendExpressionAttributes(_node.annotation());
+	endNode();
+	return false;
+}
+
+void ASTCBORConverter::endVisit(EventDefinition const&)
+{
+	m_inEvent = false;
+}
+
+void ASTCBORConverter::beginNode(ASTNode const& _node, string const& _nodeType)
+{
+	// Nodes have less than 24 attributes, so the size fits into the initial byte.
+	m_openNodes.emplace_back(m_data.size(), 0);
+	m_data.push_back(uint8_t(MajorType::Map) << 5);
+	key("id");
+	appendInteger(_node.id());
+	key("src");
+	appendSourceLocation(_node.location());
+	key("nodeType");
+	appendString(_nodeType);
+}
+
+void ASTCBORConverter::endNode()
+{
+	solAssert(!m_openNodes.empty(), "");
+	size_t position;
+	size_t attributes;
+	tie(position, attributes) = m_openNodes.back();
+	m_openNodes.pop_back();
+	solAssert(attributes < 24, "Too many attributes for a single-byte map head.");
+	m_data[position] |= uint8_t(attributes);
+}
+
+void ASTCBORConverter::key(string const& _key)
+{
+	solAssert(!m_openNodes.empty(), "");
+	m_openNodes.back().second++;
+	appendString(_key);
+}
+
+void ASTCBORConverter::appendNodeOrNull(ASTNode const* _node)
+{
+	if (_node)
+		appendNode(*_node);
+	else
+		appendNull();
+}
+
+void ASTCBORConverter::appendIdOrNull(ASTNode const* _node)
+{
+	if (_node)
+		appendInteger(_node->id());
+	else
+		appendNull();
+}
+
+void ASTCBORConverter::appendTypeDescriptions(TypePointer _type, bool _short)
+{
+	appendHead(MajorType::Map, 2);
+	appendString("typeString");
+	if (_type)
+		appendString(_type->toString(_short));
+	else
+		appendNull();
+	appendString("typeIdentifier");
+	if (_type)
+		appendString(_type->identifier());
+	else
+		appendNull();
+}
+
+void ASTCBORConverter::appendArgumentTypes(boost::optional<FuncCallArguments> const& _arguments)
+{
+	if (!_arguments)
+	{
+		appendNull();
+		return;
+	}
+	appendHead(MajorType::Array, _arguments->types.size());
+	for (auto const& type: _arguments->types)
+		appendTypeDescriptions(type);
+}
+
+void ASTCBORConverter::appendExpressionAttributes(ExpressionAnnotation const& _annotation)
+{
+	key("typeDescriptions");
+	appendTypeDescriptions(_annotation.type);
+	key("isConstant");
+	appendBool(_annotation.isConstant);
+	key("isPure");
+	appendBool(_annotation.isPure);
+	key("isLValue");
+	appendBool(_annotation.isLValue);
+	key("lValueRequested");
+	appendBool(_annotation.lValueRequested);
+	key("argumentTypes");
+	appendArgumentTypes(_annotation.arguments);
+}
+
+void ASTCBORConverter::appendDocumentation(ASTPointer<ASTString> const& _documentation)
+{
+	if (_documentation)
+		appendString(*_documentation);
+	else
+		appendNull();
+}
+
+void ASTCBORConverter::appendSourceLocation(SourceLocation const& _location)
+{
+	int sourceIndex = -1;
+	if (_location.source && m_sourceIndices.count(_location.source->name()))
+		sourceIndex = m_sourceIndices.at(_location.source->name());
+	int length = -1;
+	if (_location.start >= 0 && _location.end >= 0)
+		length = _location.end - _location.start;
+	appendHead(MajorType::Array, 3);
+	appendInteger(_location.start);
+	appendInteger(length);
+	appendInteger(sourceIndex);
+}
+
+void ASTCBORConverter::appendValue(Json::Value const& _value)
+{
+	switch (_value.type())
+	{
+	case Json::nullValue:
+		appendNull();
+		break;
+	case Json::booleanValue:
+		appendBool(_value.asBool());
+		break;
+	case Json::intValue:
+		appendInteger(_value.asInt64());
+		break;
+	case Json::uintValue:
+		appendHead(MajorType::UnsignedInteger, _value.asUInt64());
+		break;
+	case Json::realValue:
+	{
+		double value = _value.asDouble();
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		m_data.push_back(0xfb);
+		appendBigEndian(bits, 8);
+		break;
+	}
+	case Json::stringValue:
+		appendString(_value.asString());
+		break;
+	case Json::arrayValue:
+		appendHead(MajorType::Array, _value.size());
+		for (auto const& element: _value)
+			appendValue(element);
+		break;
+	case Json::objectValue:
+		appendHead(MajorType::Map, _value.size());
+		for (auto it = _value.begin(); it != _value.end(); ++it)
+		{
+			appendString(it.name());
+			if (it.name() == "src" && it->isString())
+			{
+				// Source location of the form "start:length:sourceIndex".
+				vector<string> parts;
+				boost::split(parts, it->asString(), boost::is_any_of(":"));
+				solAssert(parts.size() == 3, "Invalid source location: " + it->asString());
+				appendHead(MajorType::Array, parts.size());
+				for (string const& part: parts)
+					appendInteger(stoll(part));
+			}
+			else
+				appendValue(*it);
+		}
+		break;
+	}
+}
+
+void ASTCBORConverter::appendNull()
+{
+	m_data.push_back(0xf6);
+}
+
+void ASTCBORConverter::appendBool(bool _value)
+{
+	m_data.push_back(_value ? 0xf5 : 0xf4);
+}
+
+void ASTCBORConverter::appendInteger(int64_t _value)
+{
+	if (_value >= 0)
+		appendHead(MajorType::UnsignedInteger, uint64_t(_value));
+	else
+		appendHead(MajorType::NegativeInteger, uint64_t(-1 - _value));
+}
+
+void ASTCBORConverter::appendString(string const& _string)
+{
+	auto it = m_stringTable.find(_string);
+	if (it != m_stringTable.end())
+	{
+		appendHead(MajorType::Tag, c_stringRefTag);
+		appendHead(MajorType::UnsignedInteger, it->second);
+		return;
+	}
+	// As required by the stringref extension, strings are only added to the table
+	// if a reference to them would be shorter than the string.
+	size_t index = m_stringTable.size();
+	size_t minimumLength = index < 24 ? 3 : index < 0x100 ? 4 : index < 0x10000 ? 5 : index < 0x100000000 ? 7 : 11;
+	if (_string.size() >= minimumLength)
+		m_stringTable[_string] = index;
+	appendHead(MajorType::TextString, _string.size());
+	m_data += asBytes(_string);
+}
+
+void ASTCBORConverter::appendHead(MajorType _type, uint64_t _argument)
+{
+	uint8_t type = uint8_t(_type) << 5;
+	if (_argument < 24)
+		m_data.push_back(type | uint8_t(_argument));
+	else if (_argument <= 0xff)
+	{
+		m_data.push_back(type | 24);
+		m_data.push_back(uint8_t(_argument));
+	}
+	else if (_argument <= 0xffff)
+	{
+		m_data.push_back(type | 25);
+		appendBigEndian(_argument, 2);
+	}
+	else if (_argument <= 0xffffffff)
+	{
+		m_data.push_back(type | 26);
+		appendBigEndian(_argument, 4);
+	}
+	else
+	{
+		m_data.push_back(type | 27);
+		appendBigEndian(_argument, 8);
+	}
+}
+
+void ASTCBORConverter::appendBigEndian(uint64_t _value, size_t _size)
+{
+	bytes encoded(_size);
+	toBigEndian(_value, encoded);
+	m_data += encoded;
+}
@@ -0,0 +1,182 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Converts the AST into a compact binary format.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/ASTVisitor.h>
+#include <libsolidity/ast/ASTAnnotations.h>
+
+#include <libdevcore/Common.h>
+
+#include <json/json.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace langutil
+{
+struct SourceLocation;
+}
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Converter of the AST into CBOR.
+ *
+ * The encoded AST has the same structure as the compact JSON AST produced by the ASTJsonConverter,
+ * with two differences: Source locations are encoded as arrays of three integers
+ * (start, length and source index) instead of strings and repeated strings are replaced by
+ * references to their first occurrence (tags 256 and 25 of the CBOR "stringref" extension).
+ *
+ * The encoding is written while visiting the AST, without building the JSON AST first.
+ * Changes to the ASTJsonConverter have to be applied here as well.
+ */
+class ASTCBORConverter: public ASTConstVisitor
+{
+public:
+	/// @a _sourceIndices is used to abbreviate source names in source locations.
+	explicit ASTCBORConverter(std::map<std::string, unsigned> _sourceIndices = std::map<std::string, unsigned>()):
+		m_sourceIndices(std::move(_sourceIndices))
+	{}
+
+	/// @returns the CBOR encoding of the AST rooted at @a _node.
+	bytes toCBOR(ASTNode const& _node);
+	/// @returns the CBOR encoding of the JSON value @a _json, where members called "src"
+	/// are encoded as source locations.
+	static bytes toCBOR(Json::Value const& _json);
+
+	bool visit(SourceUnit const& _node) override;
+	bool visit(PragmaDirective const& _node) override;
+	bool visit(ImportDirective const& _node) override;
+	bool visit(ContractDefinition const& _node) override;
+	bool visit(InheritanceSpecifier const& _node) override;
+	bool visit(UsingForDirective const& _node) override;
+	bool visit(StructDefinition const& _node) override;
+	bool visit(EnumDefinition const& _node) override;
+	bool visit(EnumValue const& _node) override;
+	bool visit(ParameterList const& _node) override;
+	bool visit(FunctionDefinition const& _node) override;
+	bool visit(VariableDeclaration const& _node) override;
+	bool visit(ModifierDefinition const& _node) override;
+	bool visit(ModifierInvocation const& _node) override;
+	bool visit(EventDefinition const& _node) override;
+	bool visit(ElementaryTypeName const& _node) override;
+	bool visit(UserDefinedTypeName const& _node) override;
+	bool visit(FunctionTypeName const& _node) override;
+	bool visit(Mapping const& _node) override;
+	bool visit(ArrayTypeName const& _node) override;
+	bool visit(InlineAssembly const& _node) override;
+	bool visit(Block const& _node) override;
+	bool visit(PlaceholderStatement const& _node) override;
+	bool visit(IfStatement const& _node) override;
+	bool visit(WhileStatement const& _node) override;
+	bool visit(ForStatement const& _node) override;
+	bool visit(Continue const& _node) override;
+	bool visit(Break const& _node) override;
+	bool visit(Return const& _node) override;
+	bool visit(Throw const& _node) override;
+	bool visit(EmitStatement const& _node) override;
+	bool visit(VariableDeclarationStatement const& _node) override;
+	bool visit(ExpressionStatement const& _node) override;
+	bool visit(Conditional const& _node) override;
+	bool visit(Assignment const& _node) override;
+	bool visit(TupleExpression const& _node) override;
+	bool visit(UnaryOperation const& _node) override;
+	bool visit(BinaryOperation const& _node) override;
+	bool visit(FunctionCall const& _node) override;
+	bool visit(NewExpression const& _node) override;
+	bool visit(MemberAccess const& _node) override;
+	bool visit(IndexAccess const& _node) override;
+	bool visit(Identifier const& _node) override;
+	bool visit(ElementaryTypeNameExpression const& _node) override;
+	bool visit(Literal const& _node) override;
+
+	void endVisit(EventDefinition const&) override;
+
+private:
+	/// CBOR major types.
+	enum class MajorType: uint8_t
+	{
+		UnsignedInteger = 0,
+		NegativeInteger = 1,
+		TextString = 3,
+		Array = 4,
+		Map = 5,
+		Tag = 6
+	};
+
+	/// Starts the map encoding @a _node and appends the attributes common to all nodes.
+	/// The size of the map is filled in by endNode().
+	void beginNode(ASTNode const& _node, std::string const& _nodeType);
+	void endNode();
+	/// Appends the key of the next attribute of the current node.
+	void key(std::string const& _key);
+
+	void appendNode(ASTNode const& _node) { _node.accept(*this); }
+	void appendNodeOrNull(ASTNode const* _node);
+	template <class T>
+	void appendNodes(std::vector<ASTPointer<T>> const& _nodes)
+	{
+		appendHead(MajorType::Array, _nodes.size());
+		for (auto const& node: _nodes)
+			appendNodeOrNull(node.get());
+	}
+	void appendIdOrNull(ASTNode const* _node);
+	template <class Container>
+	void appendIds(Container const& _container)
+	{
+		appendHead(MajorType::Array, _container.size());
+		for (auto const& element: _container)
+		{
+			solAssert(element, "");
+			appendInteger(element->id());
+		}
+	}
+	void appendTypeDescriptions(TypePointer _type, bool _short = false);
+	void appendArgumentTypes(boost::optional<FuncCallArguments> const& _arguments);
+	void appendExpressionAttributes(ExpressionAnnotation const& _annotation);
+	void appendDocumentation(ASTPointer<ASTString> const& _documentation);
+	void appendSourceLocation(langutil::SourceLocation const& _location);
+
+	void appendValue(Json::Value const& _value);
+	void appendNull();
+	void appendBool(bool _value);
+	void appendInteger(int64_t _value);
+	/// Appends the string or a reference to it, if it was added to the table before.
+	void appendString(std::string const& _string);
+	void appendHead(MajorType _type, uint64_t _argument);
+	void appendBigEndian(uint64_t _value, size_t _size);
+
+	bool m_inEvent = false; ///< whether we are currently inside an event or not
+	std::map<std::string, unsigned> m_sourceIndices;
+	bytes m_data;
+	std::unordered_map<std::string, size_t> m_stringTable;
+	/// Positions of the heads and numbers of attributes of the nodes being encoded.
+	std::vector<std::pair<size_t, size_t>> m_openNodes;
+};
+
+}
+}
@@ -115,6 +115,13 @@ public:
 
 	void endVisit(EventDefinition const&) override;
 
+	/// String representations of AST properties, also used by the ASTCBORConverter.
+	static std::string namePathToString(std::vector<ASTString> const& _namePath);
+	static std::string location(VariableDeclaration::Location _location);
+	static std::string contractKind(ContractDefinition::ContractKind _kind);
+	static std::string functionCallKind(FunctionCallKind _kind);
+	static std::string literalTokenKind(Token _token);
+
 private:
 	void setJsonNode(
 		ASTNode const& _node,
@@ -127,7 +134,6 @@ private:
 		std::vector<std::pair<std::string, Json::Value>>&& _attributes
 	);
 	std::string sourceLocationToString(langutil::SourceLocation const& _location) const;
-	static std::string namePathToString(std::vector<ASTString> const& _namePath);
 	static Json::Value idOrNull(ASTNode const* _pt)
 	{
 		return _pt ? Json::Value(nodeId(*_pt)) : Json::nullValue;
@@ -137,10 +143,6 @@ private:
 		return _node ? toJson(*_node) : Json::nullValue;
 	}
 	Json::Value inlineAssemblyIdentifierToJson(std::pair<yul::Identifier const* , InlineAssemblyAnnotation::ExternalIdentifierInfo> _info) const;
-	static std::string location(VariableDeclaration::Location _location);
-	static std::string contractKind(ContractDefinition::ContractKind _kind);
-	static std::string functionCallKind(FunctionCallKind _kind);
-	static std::string literalTokenKind(Token _token);
 	static std::string type(Expression const& _expression);
 	static std::string type(VariableDeclaration const& _varDecl);
 	static int nodeId(ASTNode const& _node)
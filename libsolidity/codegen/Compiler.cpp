@@ -35,9 +35,44 @@ void Compiler::compileContract(
 	bytes const& _metadata
 )
 {
-	ContractCompiler runtimeCompiler(nullptr, m_runtimeContext, m_optimiserSettings);
+	compile(_contract, _otherCompilers, _metadata);
+
+	// The free memory pointer is initialised before the Yul optimiser decides whether
+	// it has to move variables to memory, so the memory can only be reserved in a second run.
+	size_t requiredMemory = max(m_runtimeContext->requiredReservedMemory(), m_context->requiredReservedMemory());
+	if (requiredMemory > 0)
+	{
+		resetContexts(requiredMemory);
+		compile(_contract, _otherCompilers, _metadata);
+		solAssert(
+			m_runtimeContext->requiredReservedMemory() <= requiredMemory &&
+			m_context->requiredReservedMemory() <= requiredMemory,
+			"Memory required for variables moved out of the stack changed between runs."
+		);
+	}
+
+	m_context->optimise(m_optimiserSettings);
+}
+
+void Compiler::resetContexts(size_t _reservedMemory)
+{
+	m_context.reset();
+	m_runtimeContext = make_unique<CompilerContext>(m_evmVersion, nullptr, m_functionLibrary);
+	m_runtimeContext->reserveMemory(_reservedMemory);
+	m_context = make_unique<CompilerContext>(m_evmVersion, m_runtimeContext.get(), m_functionLibrary);
+	m_context->reserveMemory(_reservedMemory);
+	m_runtimeSub = size_t(-1);
+}
+
+void Compiler::compile(
+	ContractDefinition const& _contract,
+	std::map<ContractDefinition const*, shared_ptr<Compiler const>> const& _otherCompilers,
+	bytes const& _metadata
+)
+{
+	ContractCompiler runtimeCompiler(nullptr, *m_runtimeContext, m_optimiserSettings);
 	runtimeCompiler.compileContract(_contract, _otherCompilers);
-	m_runtimeContext.appendAuxiliaryData(_metadata);
+	m_runtimeContext->appendAuxiliaryData(_metadata);
 
 	// This might modify m_runtimeContext because it can access runtime functions at
 	// creation time.
@@ -45,19 +80,18 @@ void Compiler::compileContract(
 	// The creation code will be executed at most once, so we modify the optimizer
 	// settings accordingly.
 	creationSettings.expectedExecutionsPerDeployment = 1;
-	ContractCompiler creationCompiler(&runtimeCompiler, m_context, creationSettings);
+	creationSettings.executionProfile = nullptr;
+	ContractCompiler creationCompiler(&runtimeCompiler, *m_context, creationSettings);
 	m_runtimeSub = creationCompiler.compileConstructor(_contract, _otherCompilers);
-
-	m_context.optimise(m_optimiserSettings);
 }
 
 std::shared_ptr<eth::Assembly> Compiler::runtimeAssemblyPtr() const
 {
-	solAssert(m_context.runtimeContext(), "");
-	return m_context.runtimeContext()->assemblyPtr();
+	solAssert(m_context->runtimeContext(), "");
+	return m_context->runtimeContext()->assemblyPtr();
 }
 
 eth::AssemblyItem Compiler::functionEntryLabel(FunctionDefinition const& _function) const
 {
-	return m_runtimeContext.functionEntryLabelIfExists(_function);
+	return m_runtimeContext->functionEntryLabelIfExists(_function);
 }
@@ -27,6 +27,7 @@
 #include <liblangutil/EVMVersion.h>
 #include <libevmasm/Assembly.h>
 #include <functional>
+#include <memory>
 #include <ostream>
 
 namespace dev {
@@ -35,13 +36,22 @@ namespace solidity {
 class Compiler
 {
 public:
-	explicit Compiler(langutil::EVMVersion _evmVersion, OptimiserSettings _optimiserSettings):
+	/// @param _functionLibrary if given, generated ABI functions are shared via this library.
+	explicit Compiler(
+		langutil::EVMVersion _evmVersion,
+		OptimiserSettings _optimiserSettings,
+		std::shared_ptr<YulFunctionLibrary> const& _functionLibrary = nullptr
+	):
+		m_evmVersion(_evmVersion),
 		m_optimiserSettings(std::move(_optimiserSettings)),
-		m_runtimeContext(_evmVersion),
-		m_context(_evmVersion, &m_runtimeContext)
-	{ }
+		m_functionLibrary(_functionLibrary)
+	{
+		resetContexts(0);
+	}
 
 	/// Compiles a contract.
+	/// If the Yul optimiser moves variables out of the stack, the contract is compiled a second
+	/// time with the memory for these variables reserved.
 	/// @arg _metadata contains the to be injected metadata CBOR
 	void compileContract(
 		ContractDefinition const& _contract,
@@ -49,39 +59,50 @@ public:
 		bytes const& _metadata
 	);
 	/// @returns Entire assembly.
-	eth::Assembly const& assembly() const { return m_context.assembly(); }
+	eth::Assembly const& assembly() const { return m_context->assembly(); }
 	/// @returns Entire assembly as a shared pointer to non-const.
-	std::shared_ptr<eth::Assembly> assemblyPtr() const { return m_context.assemblyPtr(); }
+	std::shared_ptr<eth::Assembly> assemblyPtr() const { return m_context->assemblyPtr(); }
 	/// @returns Runtime assembly.
 	std::shared_ptr<eth::Assembly> runtimeAssemblyPtr() const;
 	/// @returns The entire assembled object (with constructor).
-	eth::LinkerObject assembledObject() const { return m_context.assembledObject(); }
+	eth::LinkerObject assembledObject() const { return m_context->assembledObject(); }
 	/// @returns Only the runtime object (without constructor).
-	eth::LinkerObject runtimeObject() const { return m_context.assembledRuntimeObject(m_runtimeSub); }
+	eth::LinkerObject runtimeObject() const { return m_context->assembledRuntimeObject(m_runtimeSub); }
 	/// @arg _sourceCodes is the map of input files to source code strings
-	std::string assemblyString(StringMap const& _sourceCodes = StringMap()) const
+	std::string assemblyString(langutil::SharedSourceMap const& _sourceCodes = langutil::SharedSourceMap()) const
 	{
-		return m_context.assemblyString(_sourceCodes);
+		return m_context->assemblyString(_sourceCodes);
 	}
 	/// @arg _sourceCodes is the map of input files to source code strings
-	Json::Value assemblyJSON(StringMap const& _sourceCodes = StringMap()) const
+	Json::Value assemblyJSON(langutil::SharedSourceMap const& _sourceCodes = langutil::SharedSourceMap()) const
 	{
-		return m_context.assemblyJSON(_sourceCodes);
+		return m_context->assemblyJSON(_sourceCodes);
 	}
 	/// @returns Assembly items of the normal compiler context
-	eth::AssemblyItems const& assemblyItems() const { return m_context.assembly().items(); }
+	eth::AssemblyItems const& assemblyItems() const { return m_context->assembly().items(); }
 	/// @returns Assembly items of the runtime compiler context
-	eth::AssemblyItems const& runtimeAssemblyItems() const { return m_context.assembly().sub(m_runtimeSub).items(); }
+	eth::AssemblyItems const& runtimeAssemblyItems() const { return m_context->assembly().sub(m_runtimeSub).items(); }
 
 	/// @returns the entry label of the given function. Might return an AssemblyItem of type
 	/// UndefinedItem if it does not exist yet.
 	eth::AssemblyItem functionEntryLabel(FunctionDefinition const& _function) const;
 
 private:
+	/// Replaces the compiler contexts by empty ones that reserve @a _reservedMemory bytes of memory.
+	void resetContexts(size_t _reservedMemory);
+	/// Generates the creation and runtime code of the contract into the current contexts.
+	void compile(
+		ContractDefinition const& _contract,
+		std::map<ContractDefinition const*, std::shared_ptr<Compiler const>> const& _otherCompilers,
+		bytes const& _metadata
+	);
+
+	langutil::EVMVersion const m_evmVersion;
 	OptimiserSettings const m_optimiserSettings;
-	CompilerContext m_runtimeContext;
+	std::shared_ptr<YulFunctionLibrary> const m_functionLibrary;
+	std::unique_ptr<CompilerContext> m_runtimeContext;
 	size_t m_runtimeSub = size_t(-1); ///< Identifier of the runtime sub-assembly, if present.
-	CompilerContext m_context;
+	std::unique_ptr<CompilerContext> m_context;
 };
 
 }
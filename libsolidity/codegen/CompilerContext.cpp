@@ -422,15 +422,26 @@ void CompilerContext::appendInlineAssembly(
 	if (_optimiserSettings.runYulOptimiser && _localVariables.empty())
 	{
 		bool const isCreation = m_runtimeContext != nullptr;
-		yul::GasMeter meter(dialect, isCreation, _optimiserSettings.expectedExecutionsPerDeployment);
-		yul::OptimiserSuite::run(
+		// The code is shared by all callers, so its expected executions are those of the
+		// surrounding node, usually the contract.
+		yul::GasMeter meter(
+			dialect,
+			isCreation,
+			_optimiserSettings.expectedExecutions(m_visitedNodes.empty() ? SourceLocation() : m_visitedNodes.top()->location())
+		);
+		// The code only consists of functions called from the surrounding code, so variables
+		// that do not fit the stack can be moved into the memory area reserved for them.
+		size_t movedVariablesMemory = yul::OptimiserSuite::run(
 			dialect,
 			&meter,
 			*parserResult,
 			analysisInfo,
 			_optimiserSettings.optimizeStackAllocation,
-			externallyUsedIdentifiers
+			externallyUsedIdentifiers,
+			_optimiserSettings.yulThreads,
+			u256(CompilerUtils::generalPurposeMemoryStart)
 		);
+		m_requiredReservedMemory = max(m_requiredReservedMemory, movedVariablesMemory);
 		analysisInfo = yul::AsmAnalysisInfo{};
 		if (!yul::AsmAnalyzer(
 			analysisInfo,
@@ -500,7 +511,7 @@ void CompilerContext::updateSourceLocation()
 eth::Assembly::OptimiserSettings CompilerContext::translateOptimiserSettings(OptimiserSettings const& _settings)
 {
 	// Constructing it this way so that we notice changes in the fields.
-	eth::Assembly::OptimiserSettings asmSettings{false, false, false, false, false, false, m_evmVersion, 0};
+	eth::Assembly::OptimiserSettings asmSettings{false, false, false, false, false, false, m_evmVersion, 0, nullptr};
 	asmSettings.isCreation = true;
 	asmSettings.runJumpdestRemover = _settings.runJumpdestRemover;
 	asmSettings.runPeephole = _settings.runPeephole;
@@ -508,6 +519,7 @@ eth::Assembly::OptimiserSettings CompilerContext::translateOptimiserSettings(Opt
 	asmSettings.runCSE = _settings.runCSE;
 	asmSettings.runConstantOptimiser = _settings.runConstantOptimiser;
 	asmSettings.expectedExecutionsPerDeployment = _settings.expectedExecutionsPerDeployment;
+	asmSettings.executionProfile = _settings.executionProfile;
 	asmSettings.evmVersion = m_evmVersion;
 	return asmSettings;
 }
@@ -52,11 +52,21 @@ class Compiler;
 class CompilerContext
 {
 public:
-	explicit CompilerContext(langutil::EVMVersion _evmVersion, CompilerContext* _runtimeContext = nullptr):
+	/// @param _functionLibrary if given, ABI functions are taken from and stored in this library.
+	explicit CompilerContext(
+		langutil::EVMVersion _evmVersion,
+		CompilerContext* _runtimeContext = nullptr,
+		std::shared_ptr<YulFunctionLibrary> const& _functionLibrary = nullptr
+	):
 		m_asm(std::make_shared<eth::Assembly>()),
 		m_evmVersion(_evmVersion),
 		m_runtimeContext(_runtimeContext),
-		m_abiFunctions(m_evmVersion)
+		m_abiFunctions(
+			m_evmVersion,
+			_functionLibrary ?
+				std::make_shared<MultiUseYulFunctionCollector>(_functionLibrary, m_evmVersion) :
+				std::make_shared<MultiUseYulFunctionCollector>()
+		)
 	{
 		if (m_runtimeContext)
 			m_runtimeSub = size_t(m_asm->newSub(m_runtimeContext->m_asm).data());
@@ -189,6 +199,8 @@ public:
 	void appendProgramSize() { m_asm->appendProgramSize(); }
 	/// Adds data to the data section, pushes a reference to the stack
 	eth::AssemblyItem appendData(bytes const& _data) { return m_asm->append(_data); }
+	/// Adds a table of the code positions of the given tags to the data section, pushes a reference to the stack
+	eth::AssemblyItem appendTagTable(std::vector<eth::AssemblyItem> const& _tags) { return m_asm->append(m_asm->newTagTable(_tags)); }
 	/// Appends the address (virtual, will be filled in by linker) of a library.
 	void appendLibraryAddress(std::string const& _identifier) { m_asm->appendLibraryAddress(_identifier); }
 	/// Appends a zero-address that can be replaced by something else at deploy time (if the
@@ -231,6 +243,15 @@ public:
 	/// @returns the identifier of the runtime subroutine.
 	size_t runtimeSub() const { return m_runtimeSub; }
 
+	/// Reserves @a _size bytes of memory in front of the general purpose memory area for
+	/// variables the Yul optimiser moves out of the stack. Has to be called before any code is generated.
+	void reserveMemory(size_t _size) { m_reservedMemory = _size; }
+	/// @returns the number of bytes of memory reserved for variables moved out of the stack.
+	size_t reservedMemory() const { return m_reservedMemory; }
+	/// @returns the number of bytes of memory needed for variables moved out of the stack
+	/// in the code generated so far.
+	size_t requiredReservedMemory() const { return m_requiredReservedMemory; }
+
 	/// @returns a const reference to the underlying assembly.
 	eth::Assembly const& assembly() const { return *m_asm; }
 	/// @returns a shared pointer to the assembly.
@@ -238,13 +259,13 @@ public:
 	std::shared_ptr<eth::Assembly> assemblyPtr() const { return m_asm; }
 
 	/// @arg _sourceCodes is the map of input files to source code strings
-	std::string assemblyString(StringMap const& _sourceCodes = StringMap()) const
+	std::string assemblyString(langutil::SharedSourceMap const& _sourceCodes = langutil::SharedSourceMap()) const
 	{
 		return m_asm->assemblyString(_sourceCodes);
 	}
 
 	/// @arg _sourceCodes is the map of input files to source code strings
-	Json::Value assemblyJSON(StringMap const& _sourceCodes = StringMap()) const
+	Json::Value assemblyJSON(langutil::SharedSourceMap const& _sourceCodes = langutil::SharedSourceMap()) const
 	{
 		return m_asm->assemblyJSON(_sourceCodes);
 	}
@@ -330,6 +351,10 @@ private:
 	CompilerContext *m_runtimeContext;
 	/// The index of the runtime subroutine.
 	size_t m_runtimeSub = -1;
+	/// Number of bytes of memory reserved for variables moved out of the stack.
+	size_t m_reservedMemory = 0;
+	/// Number of bytes of memory needed for variables moved out of the stack.
+	size_t m_requiredReservedMemory = 0;
 	/// An index of low-level function labels by name.
 	std::map<std::string, eth::AssemblyItem> m_lowLevelFunctions;
 	/// Container for ABI functions to be generated.
@@ -47,7 +47,7 @@ static_assert(CompilerUtils::generalPurposeMemoryStart >= CompilerUtils::zeroPoi
 
 void CompilerUtils::initialiseFreeMemoryPointer()
 {
-	m_context << u256(generalPurposeMemoryStart);
+	m_context << u256(generalPurposeMemoryStart + m_context.reservedMemory());
 	storeFreeMemoryPointer();
 }
 
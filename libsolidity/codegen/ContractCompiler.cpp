@@ -264,6 +264,89 @@ void ContractCompiler::appendDelegatecallCheck()
 	// "We have not been called via DELEGATECALL".
 }
 
+namespace
+{
+
+/// Execution cost (summed over all functions) and code size of a function selector.
+struct SelectorCost
+{
+	size_t gas = 0;
+	size_t bytes = 0;
+};
+
+/// @returns true if the selector tree for the given number of functions should be split.
+/// See ContractCompiler::appendInternalSelector for the cost model.
+bool splitSelector(size_t _numFunctions, size_t _runs)
+{
+	// Start with some comparisons to avoid overflow, then do the actual comparison.
+	if (_numFunctions <= 4)
+		return false;
+	else if (_runs > (17 * eth::GasCosts::createDataGas) / 6)
+		return true;
+	else
+		return _runs * 6 * (_numFunctions - 4) > 17 * eth::GasCosts::createDataGas;
+}
+
+/// @returns the cost of the selector tree created by ContractCompiler::appendInternalSelector.
+SelectorCost selectorTreeCost(size_t _numFunctions, size_t _runs)
+{
+	// A comparison "dup1 push4 <id> eq/gt push2 <tag> jumpi" takes 22 gas and 11 bytes.
+	SelectorCost cost;
+	if (splitSelector(_numFunctions, _runs))
+	{
+		size_t smaller = _numFunctions / 2;
+		SelectorCost larger = selectorTreeCost(_numFunctions - smaller, _runs);
+		SelectorCost lessThan = selectorTreeCost(smaller, _runs);
+		// The functions in the smaller half also pay for the jumpdest.
+		cost.gas = 22 * _numFunctions + smaller + larger.gas + lessThan.gas;
+		cost.bytes = 11 + 1 + larger.bytes + lessThan.bytes;
+	}
+	else
+	{
+		// The i-th function is found after i comparisons, followed by "push2 <notfound> jump".
+		cost.gas = 22 * _numFunctions * (_numFunctions + 1) / 2;
+		cost.bytes = 11 * _numFunctions + 4;
+	}
+	return cost;
+}
+
+/// @returns the buckets of the given function identifiers when indexed by the identifier
+/// modulo @a _modulus.
+vector<vector<FixedHash<4>>> selectorBuckets(vector<FixedHash<4>> const& _ids, size_t _modulus)
+{
+	vector<vector<FixedHash<4>>> buckets(_modulus);
+	for (auto const& id: _ids)
+		buckets[size_t(u256(FixedHash<4>::Arith(id)) % _modulus)].push_back(id);
+	return buckets;
+}
+
+/// @returns the cost of the selector created by ContractCompiler::appendJumpTableSelector.
+SelectorCost jumpTableSelectorCost(vector<FixedHash<4>> const& _ids, size_t _modulus)
+{
+	// Loading the destination from the table takes 58 gas and 24 bytes, the table itself
+	// takes two bytes per entry.
+	SelectorCost cost;
+	cost.bytes = 24 + 2 * _modulus;
+	for (auto const& bucket: selectorBuckets(_ids, _modulus))
+		if (!bucket.empty())
+		{
+			// jumpdest, one comparison per function and "push2 <notfound> jump"
+			cost.bytes += 1 + 11 * bucket.size() + 4;
+			// The i-th function in a bucket is found after i comparisons.
+			cost.gas += (58 + 1) * bucket.size() + 22 * bucket.size() * (bucket.size() + 1) / 2;
+		}
+	return cost;
+}
+
+/// @returns the total cost of a selector for @a _numFunctions functions over the lifetime
+/// of the contract, assuming each function is called equally often.
+bigint totalSelectorCost(SelectorCost const& _cost, size_t _numFunctions, size_t _runs)
+{
+	return bigint(_runs) * _cost.gas + bigint(_numFunctions) * _cost.bytes * eth::GasCosts::createDataGas;
+}
+
+}
+
 void ContractCompiler::appendInternalSelector(
 	map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
 	vector<FixedHash<4>> const& _ids,
@@ -294,16 +377,7 @@ void ContractCompiler::appendInternalSelector(
 	// Which also means that the execution itself is not profitable
 	// unless we have at least 5 functions.
 
-	// Start with some comparisons to avoid overflow, then do the actual comparison.
-	bool split = false;
-	if (_ids.size() <= 4)
-		split = false;
-	else if (_runs > (17 * eth::GasCosts::createDataGas) / 6)
-		split = true;
-	else
-		split = (_runs * 6 * (_ids.size() - 4) > 17 * eth::GasCosts::createDataGas);
-
-	if (split)
+	if (splitSelector(_ids.size(), _runs))
 	{
 		size_t pivotIndex = _ids.size() / 2;
 		FixedHash<4> pivot{_ids.at(pivotIndex)};
@@ -328,6 +402,49 @@ void ContractCompiler::appendInternalSelector(
 	}
 }
 
+void ContractCompiler::appendJumpTableSelector(
+	map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
+	vector<FixedHash<4>> const& _ids,
+	eth::AssemblyItem const& _notFoundTag,
+	size_t _modulus
+)
+{
+	// Code for selecting from n functions using a table with m entries:
+	//   push <m>, dup2, mod, dup1, add, push <table>, add,
+	//   push1 2, swap1, push1 30, codecopy, push1 0, mload, push2 0xffff, and, jump
+	// and for each non-empty bucket:
+	//   tag_bucket:
+	//     SELECT[size of bucket]
+	// Empty buckets directly point to <notfound>.
+	//
+	// Loading the destination costs 58 gas, independent of the number of functions.
+	// The table is copied to the scratch space, of which only the last two bytes are used.
+	vector<vector<FixedHash<4>>> buckets = selectorBuckets(_ids, _modulus);
+	vector<eth::AssemblyItem> bucketTags;
+	for (auto const& bucket: buckets)
+		bucketTags.push_back(bucket.empty() ? _notFoundTag : m_context.newTag());
+
+	m_context << u256(_modulus) << dupInstruction(2) << Instruction::MOD;
+	m_context << dupInstruction(1) << Instruction::ADD;
+	m_context.appendTagTable(bucketTags);
+	m_context << Instruction::ADD;
+	m_context << u256(2) << Instruction::SWAP1 << u256(30) << Instruction::CODECOPY;
+	m_context << u256(0) << Instruction::MLOAD << u256(0xffff) << Instruction::AND;
+	m_context.appendJump();
+
+	for (size_t i = 0; i < buckets.size(); ++i)
+		if (!buckets[i].empty())
+		{
+			m_context << bucketTags[i];
+			for (auto const& id: buckets[i])
+			{
+				m_context << dupInstruction(1) << u256(FixedHash<4>::Arith(id)) << Instruction::EQ;
+				m_context.appendConditionalJumpTo(_entryPoints.at(id));
+			}
+			m_context.appendJumpTo(_notFoundTag);
+		}
+}
+
 namespace
 {
 
@@ -386,7 +503,25 @@ void ContractCompiler::appendFunctionSelector(ContractDefinition const& _contrac
 			sortedIDs.emplace_back(it.first);
 		}
 		std::sort(sortedIDs.begin(), sortedIDs.end());
-		appendInternalSelector(callDataUnpackerEntryPoints, sortedIDs, notFound, m_optimiserSettings.expectedExecutionsPerDeployment);
+
+		// Use a jump table instead of the selector tree if it is cheaper over the expected
+		// number of executions. Larger tables have fewer collisions, but cost more to deploy.
+		size_t runs = m_optimiserSettings.expectedExecutions(_contract.location());
+		bigint lowestCost = totalSelectorCost(selectorTreeCost(sortedIDs.size(), runs), sortedIDs.size(), runs);
+		size_t tableModulus = 0;
+		for (size_t modulus = sortedIDs.size(); modulus <= 2 * sortedIDs.size(); ++modulus)
+		{
+			bigint cost = totalSelectorCost(jumpTableSelectorCost(sortedIDs, modulus), sortedIDs.size(), runs);
+			if (cost < lowestCost)
+			{
+				lowestCost = cost;
+				tableModulus = modulus;
+			}
+		}
+		if (tableModulus > 0)
+			appendJumpTableSelector(callDataUnpackerEntryPoints, sortedIDs, notFound, tableModulus);
+		else
+			appendInternalSelector(callDataUnpackerEntryPoints, sortedIDs, notFound, runs);
 	}
 
 	m_context << notFound;
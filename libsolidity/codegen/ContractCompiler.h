@@ -94,6 +94,15 @@ private:
 		eth::AssemblyItem const& _notFoundTag,
 		size_t _runs
 	);
+	/// Appends a function selector that jumps through a table indexed by the function
+	/// identifier modulo @a _modulus. Each table entry points to a bucket that compares the
+	/// identifier with the few functions that share the index.
+	void appendJumpTableSelector(
+		std::map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
+		std::vector<FixedHash<4>> const& _ids,
+		eth::AssemblyItem const& _notFoundTag,
+		size_t _modulus
+	);
 	void appendFunctionSelector(ContractDefinition const& _contract);
 	void appendCallValueCheck();
 	void appendReturnValuePacker(TypePointers const& _typeParameters, bool _isLibrary);
@@ -41,12 +41,58 @@ string MultiUseYulFunctionCollector::requestedFunctions()
 
 string MultiUseYulFunctionCollector::createFunction(string const& _name, function<string ()> const& _creator)
 {
+	if (!m_functionsBeingCreated.empty())
+		m_functionsBeingCreated.back().second.push_back(_name);
 	if (!m_requestedFunctions.count(_name))
 	{
-		string fun = _creator();
-		solAssert(!fun.empty(), "");
-		solAssert(fun.find("function " + _name) != string::npos, "Function not properly named.");
-		m_requestedFunctions[_name] = std::move(fun);
+		YulFunctionLibrary::Function const* function = m_library ? m_library->find(m_evmVersion, _name) : nullptr;
+		if (function)
+			addFromLibrary(_name, *function);
+		else
+		{
+			m_functionsBeingCreated.emplace_back(_name, vector<string>{});
+			string fun = _creator();
+			vector<string> dependencies = std::move(m_functionsBeingCreated.back().second);
+			m_functionsBeingCreated.pop_back();
+			solAssert(!fun.empty(), "");
+			solAssert(fun.find("function " + _name) != string::npos, "Function not properly named.");
+			if (m_library)
+				m_library->add(m_evmVersion, _name, YulFunctionLibrary::Function{fun, std::move(dependencies)});
+			m_requestedFunctions[_name] = std::move(fun);
+		}
 	}
 	return _name;
 }
+
+void MultiUseYulFunctionCollector::addFromLibrary(string const& _name, YulFunctionLibrary::Function const& _function)
+{
+	solAssert(m_library, "");
+	m_requestedFunctions[_name] = _function.code;
+	for (string const& dependency: _function.dependencies)
+		if (!m_requestedFunctions.count(dependency))
+			addFromLibrary(dependency, m_library->dependency(m_evmVersion, dependency));
+}
+
+YulFunctionLibrary::Function const* YulFunctionLibrary::find(langutil::EVMVersion _evmVersion, string const& _name)
+{
+	auto it = m_functions.find(make_pair(_evmVersion, _name));
+	if (it == m_functions.end())
+	{
+		++m_misses;
+		return nullptr;
+	}
+	++m_hits;
+	return &it->second;
+}
+
+YulFunctionLibrary::Function const& YulFunctionLibrary::dependency(langutil::EVMVersion _evmVersion, string const& _name) const
+{
+	auto it = m_functions.find(make_pair(_evmVersion, _name));
+	solAssert(it != m_functions.end(), "Dependency of cached Yul function not found.");
+	return it->second;
+}
+
+void YulFunctionLibrary::add(langutil::EVMVersion _evmVersion, string const& _name, Function _function)
+{
+	m_functions[make_pair(_evmVersion, _name)] = std::move(_function);
+}
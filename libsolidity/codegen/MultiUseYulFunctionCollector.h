@@ -21,22 +21,76 @@
 
 #pragma once
 
+#include <liblangutil/EVMVersion.h>
+
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace dev
 {
 namespace solidity
 {
 
+/**
+ * Cache of generated multi-use Yul functions that can be shared between several
+ * MultiUseYulFunctionCollectors, e.g. those of all contracts compiled by a CompilerStack.
+ *
+ * For a given EVM version, the name of such a function determines its code, so the code
+ * is stored together with the names of the functions it requires, keyed by EVM version
+ * and name. Since type names contain AST IDs, a library must not be used across
+ * different sets of source units.
+ */
+class YulFunctionLibrary
+{
+public:
+	struct Function
+	{
+		std::string code;
+		/// Names of the multi-use functions that are called by this function.
+		std::vector<std::string> dependencies;
+	};
+
+	/// @returns the function stored under @a _name or nullptr if there is none.
+	/// Counts as a hit or a miss, respectively.
+	Function const* find(langutil::EVMVersion _evmVersion, std::string const& _name);
+	/// @returns the function stored under @a _name, which has to exist.
+	/// Used for dependencies and thus not counted.
+	Function const& dependency(langutil::EVMVersion _evmVersion, std::string const& _name) const;
+	void add(langutil::EVMVersion _evmVersion, std::string const& _name, Function _function);
+
+	/// @returns the number of functions requested by code generation that were taken from the library.
+	/// Functions pulled in as dependencies are not counted.
+	size_t hits() const { return m_hits; }
+	/// @returns the number of functions requested by code generation that had to be generated.
+	size_t misses() const { return m_misses; }
+	size_t size() const { return m_functions.size(); }
+
+private:
+	std::map<std::pair<langutil::EVMVersion, std::string>, Function> m_functions;
+	size_t m_hits = 0;
+	size_t m_misses = 0;
+};
+
 /**
  * Container of (unparsed) Yul functions identified by name which are meant to be generated
  * only once.
+ *
+ * If a YulFunctionLibrary is provided, functions are taken from the library instead of
+ * being generated whenever possible, and newly generated functions are added to it.
  */
 class MultiUseYulFunctionCollector
 {
 public:
+	MultiUseYulFunctionCollector() = default;
+	MultiUseYulFunctionCollector(std::shared_ptr<YulFunctionLibrary> _library, langutil::EVMVersion _evmVersion):
+		m_library(std::move(_library)),
+		m_evmVersion(_evmVersion)
+	{}
+
 	/// Helper function that uses @a _creator to create a function and add it to
 	/// @a m_requestedFunctions if it has not been created yet and returns @a _name in both
 	/// cases.
@@ -48,8 +102,16 @@ public:
 	std::string requestedFunctions();
 
 private:
+	/// Adds @a _function, stored under @a _name, and all functions it depends on from the library.
+	void addFromLibrary(std::string const& _name, YulFunctionLibrary::Function const& _function);
+
 	/// Map from function name to code for a multi-use function.
 	std::map<std::string, std::string> m_requestedFunctions;
+	std::shared_ptr<YulFunctionLibrary> m_library;
+	langutil::EVMVersion m_evmVersion;
+	/// Functions whose creator is currently running (innermost last), together with
+	/// the names of the functions they requested so far.
+	std::vector<std::pair<std::string, std::vector<std::string>>> m_functionsBeingCreated;
 };
 
 }
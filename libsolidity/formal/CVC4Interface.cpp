@@ -33,6 +33,7 @@ CVC4Interface::CVC4Interface():
 void CVC4Interface::reset()
 {
 	m_variables.clear();
+	m_translations.clear();
 	m_solver.reset();
 	m_solver.setOption("produce-models", true);
 	m_solver.setTimeLimit(queryTimeout);
@@ -114,21 +115,36 @@ pair<CheckResult, vector<string>> CVC4Interface::check(vector<Expression> const&
 	return make_pair(result, values);
 }
 
+void CVC4Interface::interrupt()
+{
+	m_solver.interrupt();
+}
+
 CVC4::Expr CVC4Interface::toCVC4Expr(Expression const& _expr)
+{
+	auto it = m_translations.find(_expr);
+	if (it != m_translations.end())
+		return it->second;
+	CVC4::Expr translation = newCVC4Expr(_expr);
+	m_translations.emplace(_expr, translation);
+	return translation;
+}
+
+CVC4::Expr CVC4Interface::newCVC4Expr(Expression const& _expr)
 {
 	// Variable
-	if (_expr.arguments.empty() && m_variables.count(_expr.name))
-		return m_variables.at(_expr.name);
+	if (_expr.arguments().empty() && m_variables.count(_expr.name()))
+		return m_variables.at(_expr.name());
 
 	vector<CVC4::Expr> arguments;
-	for (auto const& arg: _expr.arguments)
+	for (auto const& arg: _expr.arguments())
 		arguments.push_back(toCVC4Expr(arg));
 
 	try
 	{
-		string const& n = _expr.name;
+		string const& n = _expr.name();
 		// Function application
-		if (!arguments.empty() && m_variables.count(_expr.name))
+		if (!arguments.empty() && m_variables.count(_expr.name()))
 			return m_context.mkExpr(CVC4::kind::APPLY_UF, m_variables.at(n), arguments);
 		// Literal
 		else if (arguments.empty())
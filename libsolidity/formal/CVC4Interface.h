@@ -33,6 +33,8 @@
 #undef _GLIBCXX_PERMIT_BACKWARD_HASH
 #endif
 
+#include <unordered_map>
+
 namespace dev
 {
 namespace solidity
@@ -54,15 +56,19 @@ public:
 
 	void addAssertion(Expression const& _expr) override;
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
+	void interrupt() override;
 
 private:
+	/// @returns the translation of @a _expr, memoised per expression node.
 	CVC4::Expr toCVC4Expr(Expression const& _expr);
+	CVC4::Expr newCVC4Expr(Expression const& _expr);
 	CVC4::Type cvc4Sort(smt::Sort const& _sort);
 	std::vector<CVC4::Type> cvc4Sort(std::vector<smt::SortPointer> const& _sorts);
 
 	CVC4::ExprManager m_context;
 	CVC4::SmtEngine m_solver;
 	std::map<std::string, CVC4::Expr> m_variables;
+	std::unordered_map<Expression, CVC4::Expr, Expression::IdentityHash, Expression::IdentityEqual> m_translations;
 };
 
 }
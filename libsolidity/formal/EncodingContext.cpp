@@ -19,6 +19,8 @@
 
 #include <libsolidity/formal/SymbolicTypes.h>
 
+#include <libdevcore/CommonData.h>
+
 using namespace std;
 using namespace dev;
 using namespace dev::solidity::smt;
@@ -213,10 +215,11 @@ void EncodingContext::transfer(Expression _from, Expression _to, Expression _val
 
 /// Solver.
 
-Expression EncodingContext::assertions()
+vector<Expression> const& EncodingContext::assertions()
 {
+	static vector<Expression> const noAssertions;
 	if (m_assertions.empty())
-		return Expression(true);
+		return noAssertions;
 
 	return m_assertions.back();
 }
@@ -235,9 +238,8 @@ void EncodingContext::popSolver()
 void EncodingContext::addAssertion(Expression const& _expr)
 {
 	if (m_assertions.empty())
-		m_assertions.push_back(_expr);
-	else
-		m_assertions.back() = _expr && move(m_assertions.back());
+		m_assertions.emplace_back();
+	m_assertions.back() += Expression::conjuncts(_expr);
 }
 
 /// Private helpers.
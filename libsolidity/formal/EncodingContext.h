@@ -116,8 +116,8 @@ public:
 
 	/// Solver.
 	//@{
-	/// @returns conjunction of all added assertions.
-	Expression assertions();
+	/// @returns all added assertions, split into their conjuncts.
+	std::vector<Expression> const& assertions();
 	void pushSolver();
 	void popSolver();
 	void addAssertion(Expression const& _e);
@@ -152,8 +152,8 @@ private:
 	/// Solver can be SMT solver or Horn solver in the future.
 	std::shared_ptr<SolverInterface> m_solver;
 
-	/// Assertion stack.
-	std::vector<Expression> m_assertions;
+	/// Assertion stack, every level holds the conjuncts of the assertions.
+	std::vector<std::vector<Expression>> m_assertions;
 	//@}
 };
 
@@ -21,6 +21,7 @@
 #include <libsolidity/formal/SMTPortfolio.h>
 #include <libsolidity/formal/SymbolicTypes.h>
 
+#include <libdevcore/CommonData.h>
 #include <libdevcore/StringUtils.h>
 
 #include <boost/range/adaptor/map.hpp>
@@ -33,8 +34,12 @@ using namespace dev;
 using namespace langutil;
 using namespace dev::solidity;
 
-SMTChecker::SMTChecker(ErrorReporter& _errorReporter, map<h256, string> const& _smtlib2Responses):
-	m_interface(make_shared<smt::SMTPortfolio>(_smtlib2Responses)),
+SMTChecker::SMTChecker(
+	ErrorReporter& _errorReporter,
+	map<h256, string> const& _smtlib2Responses,
+	shared_ptr<smt::QueryCache> _queryCache
+):
+	m_interface(make_shared<smt::SMTPortfolio>(_smtlib2Responses, std::move(_queryCache))),
 	m_errorReporterReference(_errorReporter),
 	m_errorReporter(m_smtErrors),
 	m_context(m_interface)
@@ -1393,13 +1398,13 @@ SMTChecker::VariableIndices SMTChecker::visitBranch(ASTNode const* _statement, s
 
 /// Verification targets.
 
-void SMTChecker::checkVerificationTargets(smt::Expression const& _constraints)
+void SMTChecker::checkVerificationTargets(vector<smt::Expression> const& _constraints)
 {
 	for (auto& target: m_verificationTargets)
 		checkVerificationTarget(target, _constraints);
 }
 
-void SMTChecker::checkVerificationTarget(VerificationTarget& _target, smt::Expression const& _constraints)
+void SMTChecker::checkVerificationTarget(VerificationTarget& _target, vector<smt::Expression> const& _constraints)
 {
 	switch (_target.type)
 	{
@@ -1441,7 +1446,7 @@ void SMTChecker::checkConstantCondition(VerificationTarget& _target)
 	);
 }
 
-void SMTChecker::checkUnderflow(VerificationTarget& _target, smt::Expression const& _constraints)
+void SMTChecker::checkUnderflow(VerificationTarget& _target, vector<smt::Expression> const& _constraints)
 {
 	solAssert(
 		_target.type == VerificationTarget::Type::Underflow ||
@@ -1451,7 +1456,8 @@ void SMTChecker::checkUnderflow(VerificationTarget& _target, smt::Expression con
 	auto intType = dynamic_cast<IntegerType const*>(_target.expression->annotation().type);
 	solAssert(intType, "");
 	checkCondition(
-		_target.constraints && _constraints && _target.value < smt::minValue(*intType),
+		_constraints + _target.constraints,
+		_target.value < smt::minValue(*intType),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -1461,7 +1467,7 @@ void SMTChecker::checkUnderflow(VerificationTarget& _target, smt::Expression con
 	);
 }
 
-void SMTChecker::checkOverflow(VerificationTarget& _target, smt::Expression const& _constraints)
+void SMTChecker::checkOverflow(VerificationTarget& _target, vector<smt::Expression> const& _constraints)
 {
 	solAssert(
 		_target.type == VerificationTarget::Type::Overflow ||
@@ -1471,7 +1477,8 @@ void SMTChecker::checkOverflow(VerificationTarget& _target, smt::Expression cons
 	auto intType = dynamic_cast<IntegerType const*>(_target.expression->annotation().type);
 	solAssert(intType, "");
 	checkCondition(
-		_target.constraints && _constraints && _target.value > smt::maxValue(*intType),
+		_constraints + _target.constraints,
+		_target.value > smt::maxValue(*intType),
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -1485,7 +1492,8 @@ void SMTChecker::checkDivByZero(VerificationTarget& _target)
 {
 	solAssert(_target.type == VerificationTarget::Type::DivByZero, "");
 	checkCondition(
-		_target.constraints && (_target.value == 0),
+		_target.constraints,
+		_target.value == 0,
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -1499,7 +1507,8 @@ void SMTChecker::checkBalance(VerificationTarget& _target)
 {
 	solAssert(_target.type == VerificationTarget::Type::Balance, "");
 	checkCondition(
-		_target.constraints && _target.value,
+		_target.constraints,
+		_target.value,
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -1512,7 +1521,8 @@ void SMTChecker::checkAssert(VerificationTarget& _target)
 {
 	solAssert(_target.type == VerificationTarget::Type::Assert, "");
 	checkCondition(
-		_target.constraints && !_target.value,
+		_target.constraints,
+		!_target.value,
 		_target.callStack,
 		_target.modelExpressions,
 		_target.expression->location(),
@@ -1529,7 +1539,7 @@ void SMTChecker::addVerificationTarget(
 	VerificationTarget target{
 		_type,
 		_value,
-		currentPathConditions() && m_context.assertions(),
+		m_context.assertions() + smt::Expression::conjuncts(currentPathConditions()),
 		_expression,
 		m_callStack,
 		modelExpressions()
@@ -1578,6 +1588,7 @@ pair<vector<smt::Expression>, vector<string>> SMTChecker::modelExpressions()
 }
 
 void SMTChecker::checkCondition(
+	vector<smt::Expression> const& _constraints,
 	smt::Expression const& _condition,
 	vector<CallStackEntry> const& callStack,
 	pair<vector<smt::Expression>, vector<string>> const& _modelExpressions,
@@ -1588,6 +1599,9 @@ void SMTChecker::checkCondition(
 )
 {
 	m_interface->push();
+	for (auto const& constraint: _constraints)
+		m_interface->addAssertion(constraint);
+	m_interface->push();
 	m_interface->addAssertion(_condition);
 
 	vector<smt::Expression> expressionsToEvaluate;
@@ -1637,7 +1651,7 @@ void SMTChecker::checkCondition(
 			solAssert(values.size() == expressionNames.size(), "");
 			map<string, string> sortedModel;
 			for (size_t i = 0; i < values.size(); ++i)
-				if (expressionsToEvaluate.at(i).name != values.at(i))
+				if (expressionsToEvaluate.at(i).name() != values.at(i))
 					sortedModel[expressionNames.at(i)] = values.at(i);
 
 			for (auto const& eval: sortedModel)
@@ -1671,11 +1685,12 @@ void SMTChecker::checkCondition(
 	}
 
 	m_interface->pop();
+	m_interface->pop();
 }
 
 void SMTChecker::checkBooleanNotConstant(
 	Expression const& _condition,
-	smt::Expression const& _constraints,
+	vector<smt::Expression> const& _constraints,
 	smt::Expression const& _value,
 	vector<CallStackEntry> const& _callStack,
 	string const& _description
@@ -1686,15 +1701,21 @@ void SMTChecker::checkBooleanNotConstant(
 		return;
 
 	m_interface->push();
-	m_interface->addAssertion(_constraints && _value);
+	for (auto const& constraint: _constraints)
+		m_interface->addAssertion(constraint);
+
+	m_interface->push();
+	m_interface->addAssertion(_value);
 	auto positiveResult = checkSatisfiable();
 	m_interface->pop();
 
 	m_interface->push();
-	m_interface->addAssertion(_constraints && !_value);
+	m_interface->addAssertion(!_value);
 	auto negatedResult = checkSatisfiable();
 	m_interface->pop();
 
+	m_interface->pop();
+
 	if (positiveResult == smt::CheckResult::ERROR || negatedResult == smt::CheckResult::ERROR)
 		m_errorReporter.warning(_condition.location(), "Error trying to invoke SMT solver.");
 	else if (positiveResult == smt::CheckResult::CONFLICTING || negatedResult == smt::CheckResult::CONFLICTING)
@@ -46,7 +46,11 @@ namespace solidity
 class SMTChecker: private ASTConstVisitor
 {
 public:
-	SMTChecker(langutil::ErrorReporter& _errorReporter, std::map<h256, std::string> const& _smtlib2Responses);
+	SMTChecker(
+		langutil::ErrorReporter& _errorReporter,
+		std::map<h256, std::string> const& _smtlib2Responses,
+		std::shared_ptr<smt::QueryCache> _queryCache = nullptr
+	);
 
 	void analyze(SourceUnit const& _sources, std::shared_ptr<langutil::Scanner> const& _scanner);
 
@@ -171,17 +175,18 @@ private:
 	{
 		enum class Type { ConstantCondition, Underflow, Overflow, UnderOverflow, DivByZero, Balance, Assert } type;
 		smt::Expression value;
-		smt::Expression constraints;
+		/// Conjuncts of the program constraints, including control-flow.
+		std::vector<smt::Expression> constraints;
 		Expression const* expression;
 		std::vector<CallStackEntry> callStack;
 		std::pair<std::vector<smt::Expression>, std::vector<std::string>> modelExpressions;
 	};
 
-	void checkVerificationTargets(smt::Expression const& _constraints);
-	void checkVerificationTarget(VerificationTarget& _target, smt::Expression const& _constraints = smt::Expression(true));
+	void checkVerificationTargets(std::vector<smt::Expression> const& _constraints);
+	void checkVerificationTarget(VerificationTarget& _target, std::vector<smt::Expression> const& _constraints = {});
 	void checkConstantCondition(VerificationTarget& _target);
-	void checkUnderflow(VerificationTarget& _target, smt::Expression const& _constraints);
-	void checkOverflow(VerificationTarget& _target, smt::Expression const& _constraints);
+	void checkUnderflow(VerificationTarget& _target, std::vector<smt::Expression> const& _constraints);
+	void checkOverflow(VerificationTarget& _target, std::vector<smt::Expression> const& _constraints);
 	void checkDivByZero(VerificationTarget& _target);
 	void checkBalance(VerificationTarget& _target);
 	void checkAssert(VerificationTarget& _target);
@@ -196,8 +201,10 @@ private:
 	//@{
 
 	std::pair<std::vector<smt::Expression>, std::vector<std::string>> modelExpressions();
-	/// Check that a condition can be satisfied.
+	/// Check that a condition can be satisfied under the given constraints.
+	/// The constraints are asserted one by one so that the solver can slice the query.
 	void checkCondition(
+		std::vector<smt::Expression> const& _constraints,
 		smt::Expression const& _condition,
 		std::vector<CallStackEntry> const& callStack,
 		std::pair<std::vector<smt::Expression>, std::vector<std::string>> const& _modelExpressions,
@@ -209,13 +216,13 @@ private:
 	/// Checks whether a Boolean condition is constant.
 	/// Do not warn if the expression is a literal constant.
 	/// @param _condition the Solidity expression, used to check whether it is a Literal and for location.
-	/// @param _constraints the program constraints, including control-flow.
+	/// @param _constraints the conjuncts of the program constraints, including control-flow.
 	/// @param _value the Boolean term to be checked.
 	/// @param _callStack the callStack to be shown with the model if applicable.
 	/// @param _description the warning string, $VALUE will be replaced by the constant value.
 	void checkBooleanNotConstant(
 		Expression const& _condition,
-		smt::Expression const& _constraints,
+		std::vector<smt::Expression> const& _constraints,
 		smt::Expression const& _value,
 		std::vector<CallStackEntry> const& _callStack,
 		std::string const& _description
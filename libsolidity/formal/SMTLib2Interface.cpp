@@ -70,7 +70,7 @@ void SMTLib2Interface::declareVariable(string const& _name, Sort const& _sort)
 	else if (!m_variables.count(_name))
 	{
 		m_variables.insert(_name);
-		write("(declare-fun |" + _name + "| () " + toSmtLibSort(_sort) + ')');
+		writeDeclaration("(declare-fun |" + _name + "| () " + toSmtLibSort(_sort) + ')');
 	}
 }
 
@@ -84,7 +84,7 @@ void SMTLib2Interface::declareFunction(string const& _name, Sort const& _sort)
 		string domain = toSmtLibSort(fSort.domain);
 		string codomain = toSmtLibSort(*fSort.codomain);
 		m_variables.insert(_name);
-		write(
+		writeDeclaration(
 			"(declare-fun |" +
 			_name +
 			"| " +
@@ -103,10 +103,7 @@ void SMTLib2Interface::addAssertion(Expression const& _expr)
 
 pair<CheckResult, vector<string>> SMTLib2Interface::check(vector<Expression> const& _expressionsToEvaluate)
 {
-	string response = querySolver(
-		boost::algorithm::join(m_accumulatedOutput, "\n") +
-		checkSatAndGetValuesCommand(_expressionsToEvaluate)
-	);
+	string response = querySolver(query(_expressionsToEvaluate));
 
 	CheckResult result;
 	// TODO proper parsing
@@ -125,12 +122,17 @@ pair<CheckResult, vector<string>> SMTLib2Interface::check(vector<Expression> con
 	return make_pair(result, values);
 }
 
+string SMTLib2Interface::query(vector<Expression> const& _expressionsToEvaluate)
+{
+	return boost::algorithm::join(m_accumulatedOutput, "\n") + checkSatAndGetValuesCommand(_expressionsToEvaluate);
+}
+
 string SMTLib2Interface::toSExpr(Expression const& _expr)
 {
-	if (_expr.arguments.empty())
-		return _expr.name;
-	std::string sexpr = "(" + _expr.name;
-	for (auto const& arg: _expr.arguments)
+	if (_expr.arguments().empty())
+		return _expr.name();
+	std::string sexpr = "(" + _expr.name();
+	for (auto const& arg: _expr.arguments())
 		sexpr += " " + toSExpr(arg);
 	sexpr += ")";
 	return sexpr;
@@ -169,6 +171,12 @@ void SMTLib2Interface::write(string _data)
 	m_accumulatedOutput.back() += move(_data) + "\n";
 }
 
+void SMTLib2Interface::writeDeclaration(string _data)
+{
+	solAssert(!m_accumulatedOutput.empty(), "");
+	m_accumulatedOutput.front() += move(_data) + "\n";
+}
+
 string SMTLib2Interface::checkSatAndGetValuesCommand(vector<Expression> const& _expressionsToEvaluate)
 {
 	string command;
@@ -180,8 +188,8 @@ string SMTLib2Interface::checkSatAndGetValuesCommand(vector<Expression> const& _
 		for (size_t i = 0; i < _expressionsToEvaluate.size(); i++)
 		{
 			auto const& e = _expressionsToEvaluate.at(i);
-			solAssert(e.sort->kind == Kind::Int || e.sort->kind == Kind::Bool, "Invalid sort for expression to evaluate.");
-			command += "(declare-const |EVALEXPR_" + to_string(i) + "| " + (e.sort->kind == Kind::Int ? "Int" : "Bool") + ")\n";
+			solAssert(e.sort()->kind == Kind::Int || e.sort()->kind == Kind::Bool, "Invalid sort for expression to evaluate.");
+			command += "(declare-const |EVALEXPR_" + to_string(i) + "| " + (e.sort()->kind == Kind::Int ? "Int" : "Bool") + ")\n";
 			command += "(assert (= |EVALEXPR_" + to_string(i) + "| " + toSExpr(e) + "))\n";
 		}
 		command += "(check-sat)\n";
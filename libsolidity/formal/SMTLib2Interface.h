@@ -55,6 +55,9 @@ public:
 
 	std::vector<std::string> unhandledQueries() override { return m_unhandledQueries; }
 
+	/// @returns the SMT-LIB2 script that check() sends to the solver for the current assertions.
+	std::string query(std::vector<Expression> const& _expressionsToEvaluate);
+
 private:
 	void declareFunction(std::string const&, Sort const&);
 
@@ -63,6 +66,8 @@ private:
 	std::string toSmtLibSort(std::vector<SortPointer> const& _sort);
 
 	void write(std::string _data);
+	/// Writes to the base level, since declarations, like m_variables, are not undone by pop().
+	void writeDeclaration(std::string _data);
 
 	std::string checkSatAndGetValuesCommand(std::vector<Expression> const& _expressionsToEvaluate);
 	std::vector<std::string> parseValues(std::string::const_iterator _start, std::string::const_iterator _end);
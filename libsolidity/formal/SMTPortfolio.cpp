@@ -25,12 +25,32 @@
 #endif
 #include <libsolidity/formal/SMTLib2Interface.h>
 
+#include <libdevcore/CommonData.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+
 using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 using namespace dev::solidity::smt;
 
-SMTPortfolio::SMTPortfolio(map<h256, string> const& _smtlib2Responses)
+namespace
+{
+/// Interval in which interrupts are repeated until the interrupted solvers return.
+chrono::milliseconds const interruptRepetitionInterval{10};
+
+/// State of a solver during a call to SMTPortfolio::checkAll.
+enum class SolverState { NotStarted, Running, Finished, Cancelled };
+}
+
+SMTPortfolio::SMTPortfolio(map<h256, string> const& _smtlib2Responses, shared_ptr<QueryCache> _queryCache):
+	m_queryCache(std::move(_queryCache))
 {
 	m_solvers.emplace_back(make_unique<smt::SMTLib2Interface>(_smtlib2Responses));
 #ifdef HAVE_Z3
@@ -39,36 +59,183 @@ SMTPortfolio::SMTPortfolio(map<h256, string> const& _smtlib2Responses)
 #ifdef HAVE_CVC4
 	m_solvers.emplace_back(make_unique<smt::CVC4Interface>());
 #endif
+	m_assertions.emplace_back();
+}
+
+SMTPortfolio::SMTPortfolio(vector<unique_ptr<SolverInterface>> _solvers, shared_ptr<QueryCache> _queryCache):
+	m_solvers(std::move(_solvers)),
+	m_queryCache(std::move(_queryCache))
+{
+	solAssert(!m_solvers.empty(), "");
+	m_assertions.emplace_back();
 }
 
 void SMTPortfolio::reset()
 {
 	for (auto const& s: m_solvers)
 		s->reset();
+	m_assertions.clear();
+	m_assertions.emplace_back();
+	m_solverAssertions.clear();
+	m_declaredNames.clear();
+	m_symbols.clear();
+	m_componentResults.clear();
 }
 
 void SMTPortfolio::push()
 {
-	for (auto const& s: m_solvers)
-		s->push();
+	m_assertions.emplace_back();
 }
 
 void SMTPortfolio::pop()
 {
-	for (auto const& s: m_solvers)
-		s->pop();
+	solAssert(m_assertions.size() > 1, "");
+	m_assertions.pop_back();
 }
 
 void SMTPortfolio::declareVariable(string const& _name, Sort const& _sort)
 {
+	m_declaredNames.insert(_name);
 	for (auto const& s: m_solvers)
 		s->declareVariable(_name, _sort);
 }
 
 void SMTPortfolio::addAssertion(Expression const& _expr)
 {
+	m_assertions.back().push_back(_expr);
+}
+
+pair<CheckResult, vector<string>> SMTPortfolio::check(vector<Expression> const& _expressionsToEvaluate)
+{
+	vector<Expression> assertions;
+	for (auto const& level: m_assertions)
+		assertions += level;
+	// Without a push, there is no distinguished condition to slice for.
+	if (m_assertions.size() == 1)
+		return checkAssertions(assertions, _expressionsToEvaluate);
+
+	map<string, vector<size_t>> occurrences;
+	for (size_t i = 0; i < assertions.size(); ++i)
+		for (auto const& symbol: symbols(assertions[i]))
+			occurrences[symbol].push_back(i);
+
+	// Assign every assertion to a connected component, where component 0 is the cone of
+	// influence of the innermost push level.
+	vector<size_t> component(assertions.size(), numeric_limits<size_t>::max());
+	auto addToComponent = [&](size_t _assertion, size_t _component) {
+		vector<size_t> stack;
+		if (component[_assertion] == numeric_limits<size_t>::max())
+		{
+			component[_assertion] = _component;
+			stack.push_back(_assertion);
+		}
+		while (!stack.empty())
+		{
+			size_t current = stack.back();
+			stack.pop_back();
+			for (auto const& symbol: symbols(assertions[current]))
+				for (size_t other: occurrences[symbol])
+					if (component[other] == numeric_limits<size_t>::max())
+					{
+						component[other] = _component;
+						stack.push_back(other);
+					}
+		}
+	};
+	size_t innermostLevelStart = assertions.size() - m_assertions.back().size();
+	for (size_t i = 0; i < assertions.size(); ++i)
+		if (i >= innermostLevelStart || symbols(assertions[i]).empty())
+			addToComponent(i, 0);
+	// Component 1 is the rest of the cone of influence of the expressions to evaluate.
+	for (auto const& expression: _expressionsToEvaluate)
+		for (auto const& symbol: symbols(expression))
+			for (size_t i: occurrences[symbol])
+				addToComponent(i, 1);
+	size_t components = 2;
+	for (size_t i = 0; i < assertions.size(); ++i)
+		if (component[i] == numeric_limits<size_t>::max())
+			addToComponent(i, components++);
+
+	vector<vector<Expression>> slices(components);
+	for (size_t i = 0; i < assertions.size(); ++i)
+		slices[component[i]].push_back(assertions[i]);
+
+	// The expressions to evaluate usually reach most of the assertions, but they are
+	// only needed for a model. If the innermost level alone is unsatisfiable, so is the query.
+	if (!slices[1].empty())
+	{
+		auto result = checkAssertions(slices[0], {});
+		if (result.first == CheckResult::UNSATISFIABLE)
+			return result;
+		slices[0].clear();
+		for (size_t i = 0; i < assertions.size(); ++i)
+			if (component[i] <= 1)
+				slices[0].push_back(assertions[i]);
+	}
+
+	auto result = checkAssertions(slices[0], _expressionsToEvaluate);
+	if (result.first != CheckResult::SATISFIABLE && result.first != CheckResult::UNKNOWN)
+		return result;
+
+	// The components do not share any symbols, so the conjunction of all assertions is
+	// satisfiable if and only if every component is.
+	bool allSatisfiable = true;
+	for (size_t i = 2; i < slices.size(); ++i)
+	{
+		auto it = m_componentResults.find(slices[i]);
+		if (it == m_componentResults.end())
+			it = m_componentResults.emplace(slices[i], checkAssertions(slices[i], {}).first).first;
+		if (it->second == CheckResult::UNSATISFIABLE)
+			return make_pair(CheckResult::UNSATISFIABLE, vector<string>{});
+		allSatisfiable = allSatisfiable && it->second == CheckResult::SATISFIABLE;
+	}
+	if (!allSatisfiable)
+		return checkAssertions(assertions, _expressionsToEvaluate);
+	return result;
+}
+
+pair<CheckResult, vector<string>> SMTPortfolio::checkAssertions(
+	vector<Expression> const& _assertions,
+	vector<Expression> const& _expressionsToEvaluate
+)
+{
+	// Every assertion passed to the solvers has its own push level, so that only the
+	// assertions that differ from the previous query have to be replaced.
+	size_t common = 0;
+	while (
+		common < min(m_solverAssertions.size(), _assertions.size()) &&
+		Expression::IdentityEqual{}(m_solverAssertions[common], _assertions[common])
+	)
+		++common;
 	for (auto const& s: m_solvers)
-		s->addAssertion(_expr);
+	{
+		for (size_t i = common; i < m_solverAssertions.size(); ++i)
+			s->pop();
+		for (size_t i = common; i < _assertions.size(); ++i)
+		{
+			s->push();
+			s->addAssertion(_assertions[i]);
+		}
+	}
+	m_solverAssertions = _assertions;
+	return checkCached(_expressionsToEvaluate);
+}
+
+pair<CheckResult, vector<string>> SMTPortfolio::checkCached(vector<Expression> const& _expressionsToEvaluate)
+{
+	if (!m_queryCache)
+		return checkAll(_expressionsToEvaluate);
+
+	// This code assumes that the constructor guarantees that
+	// SmtLib2Interface is in position 0.
+	auto smtlib2 = dynamic_cast<smt::SMTLib2Interface*>(m_solvers.front().get());
+	solAssert(smtlib2, "");
+	string query = smtlib2->query(_expressionsToEvaluate);
+	if (auto answer = m_queryCache->lookup(query))
+		return *answer;
+	auto answer = checkAll(_expressionsToEvaluate);
+	m_queryCache->store(query, answer);
+	return answer;
 }
 
 /*
@@ -76,57 +243,156 @@ void SMTPortfolio::addAssertion(Expression const& _expr)
  * This comment explains how this result is decided.
  *
  * When a solver is queried, there are four possible answers:
- *   SATISFIABLE (SAT), UNSATISFIABLE (UNSAT), UNKNOWN, CONFLICTING, ERROR
+ *   SATISFIABLE (SAT), UNSATISFIABLE (UNSAT), UNKNOWN, ERROR
  * We say that a solver _answered_ the query if it returns either:
  *   SAT or UNSAT
  * A solver did not answer the query if it returns either:
  *   UNKNOWN (it tried but couldn't solve it) or ERROR (crash, internal error, API error, etc).
  *
- * Ideally all solvers answer the query and agree on what the answer is
- * (all say SAT or all say UNSAT).
+ * The solvers run concurrently, each in its own thread, and have a fixed priority
+ * given by their order in m_solvers. The result does not depend on the timing of
+ * the solvers:
  *
- * The actual logic as as follows:
- * 1) If at least one solver answers the query, all the non-answer results are ignored.
+ * 1) The verdict and the values are those of the solver with the highest priority
+ *   that answers the query. Solvers with a higher priority than that are always
+ *   run to completion. As soon as a solver answers, the solvers with a lower
+ *   priority are no longer needed: Those that are still running are interrupted,
+ *   those that have not started yet are not started at all, and their results
+ *   are ignored.
  *   Here SAT/UNSAT is preferred over UNKNOWN since it's an actual answer, and over ERROR
  *   because one buggy solver/integration shouldn't break the portfolio.
+ *   Whether a solver with a lower priority would have given a different answer
+ *   depends on whether it finishes before it is interrupted, so conflicting answers
+ *   are not reported.
  *
- * 2) If at least one solver answers SAT and at least one answers UNSAT, at least one of them is buggy
- * and the result is CONFLICTING.
- *   In the future if we have more than 2 solvers enabled we could go with the majority.
- *
- * 3) If NO solver answers the query:
+ * 2) If NO solver answers the query:
  *   If at least one solver returned UNKNOWN (where the rest returned ERROR), the result is UNKNOWN.
  *   This is preferred over ERROR since the SMTChecker might decide to abstract the query
  *   when it is told that this is a hard query to solve.
  *
  *   If all solvers return ERROR, the result is ERROR.
+ *
+ * A solver cannot be interrupted before it actually started to search, so interrupts
+ * are repeated until the solver returns. Interrupts are only sent to solvers that are
+ * running, under the same lock that is taken when a solver finishes.
 */
-pair<CheckResult, vector<string>> SMTPortfolio::check(vector<Expression> const& _expressionsToEvaluate)
+pair<CheckResult, vector<string>> SMTPortfolio::checkAll(vector<Expression> const& _expressionsToEvaluate)
 {
-	CheckResult lastResult = CheckResult::ERROR;
-	vector<string> finalValues;
-	for (auto const& s: m_solvers)
-	{
-		CheckResult result;
-		vector<string> values;
-		tie(result, values) = s->check(_expressionsToEvaluate);
-		if (solverAnswered(result))
-		{
-			if (!solverAnswered(lastResult))
+	if (m_solvers.size() == 1)
+		return m_solvers.front()->check(_expressionsToEvaluate);
+
+	vector<pair<CheckResult, vector<string>>> results(m_solvers.size(), {CheckResult::ERROR, {}});
+	vector<SolverState> states(m_solvers.size(), SolverState::NotStarted);
+	vector<exception_ptr> exceptions(m_solvers.size());
+	// Index of the solver with the highest priority that answered the query so far.
+	size_t firstAnswer = m_solvers.size();
+	mutex stateMutex;
+	condition_variable solverFinished;
+
+	vector<thread> workers;
+	for (size_t i = 0; i < m_solvers.size(); ++i)
+		workers.emplace_back([&, i]() {
 			{
-				lastResult = result;
-				finalValues = std::move(values);
+				lock_guard<mutex> lock(stateMutex);
+				if (states[i] == SolverState::Cancelled)
+					return;
+				states[i] = SolverState::Running;
 			}
-			else if (lastResult != result)
+			pair<CheckResult, vector<string>> result{CheckResult::ERROR, {}};
+			exception_ptr exception;
+			try
 			{
-				lastResult = CheckResult::CONFLICTING;
-				break;
+				result = m_solvers[i]->check(_expressionsToEvaluate);
 			}
+			catch (...)
+			{
+				exception = current_exception();
+			}
+			lock_guard<mutex> lock(stateMutex);
+			states[i] = SolverState::Finished;
+			exceptions[i] = exception;
+			if (solverAnswered(result.first) && i < firstAnswer)
+				firstAnswer = i;
+			results[i] = std::move(result);
+			solverFinished.notify_all();
+		});
+
+	{
+		unique_lock<mutex> lock(stateMutex);
+		// The solvers with a lower priority than the best answer so far are not needed.
+		auto cancelUnneeded = [&]() {
+			bool running = false;
+			for (size_t i = firstAnswer + 1; i < m_solvers.size(); ++i)
+				if (states[i] == SolverState::NotStarted)
+					states[i] = SolverState::Cancelled;
+				else if (states[i] == SolverState::Running)
+				{
+					m_solvers[i]->interrupt();
+					running = true;
+				}
+			return running;
+		};
+		auto done = [&]() {
+			for (size_t i = 0; i < m_solvers.size(); ++i)
+				if (states[i] == SolverState::NotStarted || states[i] == SolverState::Running)
+					return false;
+			return true;
+		};
+		// Cancelling the solvers that have not started yet can already finish the query,
+		// and the cancelled workers do not notify.
+		while (true)
+		{
+			bool interrupting = cancelUnneeded();
+			if (done())
+				break;
+			if (interrupting)
+				solverFinished.wait_for(lock, interruptRepetitionInterval);
+			else
+				solverFinished.wait(lock);
 		}
-		else if (result == CheckResult::UNKNOWN && lastResult == CheckResult::ERROR)
-			lastResult = result;
 	}
-	return make_pair(lastResult, finalValues);
+	for (auto& worker: workers)
+		worker.join();
+	for (size_t i = 0; i < m_solvers.size() && i <= firstAnswer; ++i)
+		if (exceptions[i])
+			rethrow_exception(exceptions[i]);
+
+	if (firstAnswer < m_solvers.size())
+		return std::move(results[firstAnswer]);
+	CheckResult result = CheckResult::ERROR;
+	for (auto const& solverResult: results)
+		if (solverResult.first == CheckResult::UNKNOWN)
+			result = CheckResult::UNKNOWN;
+	return make_pair(result, vector<string>{});
+}
+
+void SMTPortfolio::interrupt()
+{
+	for (auto const& s: m_solvers)
+		s->interrupt();
+}
+
+vector<string> const& SMTPortfolio::symbols(Expression const& _expr)
+{
+	auto it = m_symbols.find(_expr);
+	if (it != m_symbols.end())
+		return it->second;
+
+	vector<string> result;
+	if (m_declaredNames.count(_expr.name()))
+		result.push_back(_expr.name());
+	for (auto const& argument: _expr.arguments())
+	{
+		vector<string> const& argumentSymbols = symbols(argument);
+		vector<string> merged;
+		set_union(
+			result.begin(), result.end(),
+			argumentSymbols.begin(), argumentSymbols.end(),
+			back_inserter(merged)
+		);
+		result = std::move(merged);
+	}
+	return m_symbols.emplace(_expr, std::move(result)).first->second;
 }
 
 vector<string> SMTPortfolio::unhandledQueries()
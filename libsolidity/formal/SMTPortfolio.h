@@ -18,12 +18,17 @@
 #pragma once
 
 
+#include <libsolidity/formal/SMTQueryCache.h>
 #include <libsolidity/formal/SolverInterface.h>
 #include <libsolidity/interface/ReadFile.h>
 #include <libdevcore/FixedHash.h>
 
 #include <boost/noncopyable.hpp>
+#include <algorithm>
 #include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace dev
@@ -36,13 +41,35 @@ namespace smt
 /**
  * The SMTPortfolio wraps all available solvers within a single interface,
  * propagating the functionalities to all solvers.
- * It also checks whether different solvers give conflicting answers
- * to SMT queries.
+ * Queries are sent to all solvers concurrently. The answer of the first solver
+ * (in the order of the solvers) that answers is used, the solvers after it
+ * are interrupted.
+ * If a query cache is given, answers are looked up there before asking the solvers.
+ *
+ * Assertions are collected by the portfolio and only passed to the solvers when a
+ * query is checked. The query is sliced to the cone of influence of the assertions
+ * added since the last push(), i.e. to the assertions that are transitively connected
+ * to them by shared symbols. If that slice is satisfiable, it is extended by the cone
+ * of influence of the expressions to evaluate, which are needed for the model.
+ * The remaining assertions are checked separately per connected component (with
+ * memoised results), so that the answer is the same as for the complete query.
+ * The solvers keep the assertions of the last query, one per push level, and the next
+ * query only replaces those after the longest common prefix, so that the solvers can
+ * solve incrementally.
  */
 class SMTPortfolio: public SolverInterface, public boost::noncopyable
 {
 public:
-	SMTPortfolio(std::map<h256, std::string> const& _smtlib2Responses);
+	SMTPortfolio(
+		std::map<h256, std::string> const& _smtlib2Responses,
+		std::shared_ptr<QueryCache> _queryCache = nullptr
+	);
+	/// Uses @a _solvers instead of the available solvers. Intended for testing.
+	/// A query cache can only be used if the first solver is an SMTLib2Interface.
+	SMTPortfolio(
+		std::vector<std::unique_ptr<SolverInterface>> _solvers,
+		std::shared_ptr<QueryCache> _queryCache = nullptr
+	);
 
 	void reset() override;
 
@@ -54,15 +81,46 @@ public:
 	void addAssertion(Expression const& _expr) override;
 
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
+	void interrupt() override;
 
 	std::vector<std::string> unhandledQueries() override;
 	unsigned solvers() override { return m_solvers.size(); }
 private:
+	struct IdentityLexicographicalLess
+	{
+		bool operator()(std::vector<Expression> const& _a, std::vector<Expression> const& _b) const
+		{
+			return std::lexicographical_compare(_a.begin(), _a.end(), _b.begin(), _b.end(), Expression::IdentityLess{});
+		}
+	};
+
 	static bool solverAnswered(CheckResult result);
 
+	/// Checks the conjunction of @a _assertions using all solvers.
+	/// The assertions are left on the solvers for the next query.
+	std::pair<CheckResult, std::vector<std::string>> checkAssertions(
+		std::vector<Expression> const& _assertions,
+		std::vector<Expression> const& _expressionsToEvaluate
+	);
+	/// Checks the assertions currently passed to the solvers, consulting the query cache.
+	std::pair<CheckResult, std::vector<std::string>> checkCached(std::vector<Expression> const& _expressionsToEvaluate);
+	std::pair<CheckResult, std::vector<std::string>> checkAll(std::vector<Expression> const& _expressionsToEvaluate);
+
+	/// @returns the sorted names of the declared variables and functions occurring in @a _expr.
+	std::vector<std::string> const& symbols(Expression const& _expr);
+
 	std::vector<std::unique_ptr<smt::SolverInterface>> m_solvers;
 
-	std::vector<Expression> m_assertions;
+	/// Assertions per push level, starting with the base level.
+	std::vector<std::vector<Expression>> m_assertions;
+	/// Assertions currently passed to the solvers, each in its own push level.
+	std::vector<Expression> m_solverAssertions;
+	std::set<std::string> m_declaredNames;
+	std::unordered_map<Expression, std::vector<std::string>, Expression::IdentityHash, Expression::IdentityEqual> m_symbols;
+	/// Results of checking independent sets of assertions, i.e. components outside the cone of influence.
+	std::map<std::vector<Expression>, CheckResult, IdentityLexicographicalLess> m_componentResults;
+
+	std::shared_ptr<QueryCache> m_queryCache;
 };
 
 }
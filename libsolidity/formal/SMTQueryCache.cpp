@@ -0,0 +1,242 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/SMTQueryCache.h>
+
+#include <libdevcore/CommonData.h>
+#include <libdevcore/JSON.h>
+#include <libdevcore/Keccak256.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+using namespace dev::solidity::smt;
+
+namespace
+{
+
+/// Version of the file format, stored in and checked against the cache file.
+int const cacheFormatVersion = 1;
+
+string resultName(CheckResult _result)
+{
+	return _result == CheckResult::SATISFIABLE ? "sat" : "unsat";
+}
+
+/// Splits an SMT-LIB2 script into parentheses, quoted symbols and other tokens,
+/// skipping whitespace and comments.
+vector<string> tokenize(string const& _query)
+{
+	vector<string> tokens;
+	size_t i = 0;
+	while (i < _query.size())
+	{
+		char c = _query[i];
+		if (isspace(static_cast<unsigned char>(c)))
+			++i;
+		else if (c == ';')
+			while (i < _query.size() && _query[i] != '\n')
+				++i;
+		else if (c == '(' || c == ')')
+		{
+			tokens.emplace_back(1, c);
+			++i;
+		}
+		else if (c == '|' || c == '"')
+		{
+			size_t end = _query.find(c, i + 1);
+			end = (end == string::npos) ? _query.size() : end + 1;
+			tokens.emplace_back(_query.substr(i, end - i));
+			i = end;
+		}
+		else
+		{
+			size_t start = i;
+			while (i < _query.size() && !isspace(static_cast<unsigned char>(_query[i])) && _query[i] != '(' && _query[i] != ')' && _query[i] != ';')
+				++i;
+			tokens.emplace_back(_query.substr(start, i - start));
+		}
+	}
+	return tokens;
+}
+
+string unquote(string const& _symbol)
+{
+	if (_symbol.size() >= 2 && _symbol.front() == '|' && _symbol.back() == '|')
+		return _symbol.substr(1, _symbol.size() - 2);
+	return _symbol;
+}
+
+}
+
+QueryCache::QueryCache(string _path, size_t _maxEntries):
+	m_path(std::move(_path)),
+	m_maxEntries(_maxEntries)
+{
+	if (m_path.empty() || !boost::filesystem::exists(m_path))
+		return;
+
+	Json::Value cache;
+	string errors;
+	try
+	{
+		if (!jsonParseFile(m_path, cache, &errors) || !cache.isObject())
+		{
+			m_warnings.emplace_back("Ignoring invalid SMT query cache " + m_path + ": " + errors);
+			return;
+		}
+		if (cache["version"] != cacheFormatVersion)
+			return;
+
+		m_previousHits = cache["statistics"]["hits"].asUInt64();
+		m_previousMisses = cache["statistics"]["misses"].asUInt64();
+		for (auto const& hash: cache["entries"].getMemberNames())
+		{
+			Json::Value const& entry = cache["entries"][hash];
+			Entry& cached = m_entries[h256(hash)];
+			cached.answer.first = entry["result"] == "sat" ? CheckResult::SATISFIABLE : CheckResult::UNSATISFIABLE;
+			for (auto const& value: entry["values"])
+				cached.answer.second.emplace_back(value.asString());
+			cached.lastUse = entry["lastUse"].asUInt64();
+			m_useCounter = max(m_useCounter, cached.lastUse);
+		}
+	}
+	catch (...)
+	{
+		m_entries.clear();
+		m_useCounter = 0;
+		m_previousHits = 0;
+		m_previousMisses = 0;
+		m_warnings.emplace_back("Ignoring invalid SMT query cache " + m_path + ".");
+	}
+}
+
+boost::optional<QueryCache::Answer> QueryCache::lookup(string const& _query)
+{
+	h256 hash = key(_query);
+	lock_guard<mutex> lock(m_mutex);
+	auto it = m_entries.find(hash);
+	if (it == m_entries.end())
+	{
+		++m_misses;
+		return boost::none;
+	}
+	++m_hits;
+	it->second.lastUse = ++m_useCounter;
+	return it->second.answer;
+}
+
+void QueryCache::store(string const& _query, Answer const& _answer)
+{
+	if (_answer.first != CheckResult::SATISFIABLE && _answer.first != CheckResult::UNSATISFIABLE)
+		return;
+	h256 hash = key(_query);
+	lock_guard<mutex> lock(m_mutex);
+	m_entries[hash] = Entry{_answer, ++m_useCounter};
+}
+
+void QueryCache::save()
+{
+	lock_guard<mutex> lock(m_mutex);
+	if (m_entries.size() > m_maxEntries)
+	{
+		vector<uint64_t> uses;
+		for (auto const& entry: m_entries)
+			uses.push_back(entry.second.lastUse);
+		size_t toEvict = m_entries.size() - m_maxEntries;
+		nth_element(uses.begin(), uses.begin() + toEvict - 1, uses.end());
+		uint64_t threshold = uses[toEvict - 1];
+		for (auto it = m_entries.begin(); it != m_entries.end();)
+			if (it->second.lastUse <= threshold)
+				it = m_entries.erase(it);
+			else
+				++it;
+	}
+
+	if (m_path.empty())
+		return;
+
+	Json::Value cache(Json::objectValue);
+	cache["version"] = cacheFormatVersion;
+	cache["statistics"]["hits"] = Json::UInt64(m_previousHits + m_hits);
+	cache["statistics"]["misses"] = Json::UInt64(m_previousMisses + m_misses);
+	cache["entries"] = Json::objectValue;
+	for (auto const& entry: m_entries)
+	{
+		Json::Value& output = cache["entries"][entry.first.hex()];
+		output["result"] = resultName(entry.second.answer.first);
+		output["values"] = Json::arrayValue;
+		for (auto const& value: entry.second.answer.second)
+			output["values"].append(value);
+		output["lastUse"] = Json::UInt64(entry.second.lastUse);
+	}
+
+	// Write to a temporary file and rename it, so that concurrent compiler runs and
+	// crashes cannot leave a partially written cache behind.
+	boost::filesystem::path temporary = m_path + boost::filesystem::unique_path(".%%%%-%%%%-%%%%.tmp").string();
+	try
+	{
+		{
+			ofstream file(temporary.string(), ios::trunc);
+			file << jsonCompactPrint(cache);
+			if (!file)
+				BOOST_THROW_EXCEPTION(SolverError());
+		}
+		boost::filesystem::rename(temporary, m_path);
+	}
+	catch (...)
+	{
+		boost::system::error_code ignored;
+		boost::filesystem::remove(temporary, ignored);
+		m_warnings.emplace_back("Could not write SMT query cache to " + m_path + ".");
+	}
+}
+
+string QueryCache::normalise(string const& _query)
+{
+	vector<string> tokens = tokenize(_query);
+
+	map<string, string> renamed;
+	for (size_t i = 0; i + 2 < tokens.size(); ++i)
+		if (tokens[i] == "(" && (tokens[i + 1] == "declare-fun" || tokens[i + 1] == "declare-const"))
+		{
+			string name = unquote(tokens[i + 2]);
+			if (!renamed.count(name))
+				renamed[name] = "@v" + to_string(renamed.size());
+		}
+
+	string normalised;
+	for (auto const& token: tokens)
+	{
+		auto it = renamed.find(unquote(token));
+		if (!normalised.empty() && token != ")" && normalised.back() != '(')
+			normalised += ' ';
+		normalised += it == renamed.end() ? token : it->second;
+	}
+	return normalised;
+}
+
+h256 QueryCache::key(string const& _query)
+{
+	return keccak256(normalise(_query));
+}
@@ -0,0 +1,105 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libsolidity/formal/SolverInterface.h>
+#include <libdevcore/FixedHash.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+namespace smt
+{
+
+/**
+ * Cache of decisive (SAT or UNSAT) answers to SMT queries that can be stored in a file
+ * and re-used by later compiler runs.
+ *
+ * Queries are identified by the hash of their normalised SMT-LIB2 representation
+ * (see normalise()). If the cache holds more than a given number of entries, the
+ * least recently used ones are dropped when it is saved.
+ */
+class QueryCache: public boost::noncopyable
+{
+public:
+	using Answer = std::pair<CheckResult, std::vector<std::string>>;
+
+	/// Creates a cache backed by the file @a _path, loading its contents if it exists.
+	/// An empty path creates a cache that only lives in memory.
+	/// If the file cannot be read or is not a valid cache, the cache starts out empty
+	/// and a warning is recorded.
+	explicit QueryCache(std::string _path = {}, size_t _maxEntries = 10000);
+
+	/// @returns the answer for the given SMT-LIB2 query if it is known.
+	boost::optional<Answer> lookup(std::string const& _query);
+	/// Stores the answer to the given SMT-LIB2 query. Answers that are neither SAT
+	/// nor UNSAT are ignored, since they may depend on timeouts or the available solvers.
+	void store(std::string const& _query, Answer const& _answer);
+
+	/// Evicts entries if needed and writes the cache to its file, if it has one.
+	/// The file is replaced atomically. If it cannot be written, a warning is recorded.
+	void save();
+
+	/// @returns the problems encountered while loading or saving the cache.
+	std::vector<std::string> const& warnings() const { return m_warnings; }
+
+	size_t hits() const { return m_hits; }
+	size_t misses() const { return m_misses; }
+	size_t size() const { return m_entries.size(); }
+
+	/// @returns @a _query with comments removed, whitespace collapsed and all
+	/// declared symbols renamed in the order of their declaration, so that
+	/// queries only differing in variable names (which contain AST IDs) are equal.
+	static std::string normalise(std::string const& _query);
+
+private:
+	struct Entry
+	{
+		Answer answer;
+		/// Value of m_useCounter at the time of the last use.
+		uint64_t lastUse = 0;
+	};
+
+	static h256 key(std::string const& _query);
+
+	std::string m_path;
+	size_t m_maxEntries;
+	std::map<h256, Entry> m_entries;
+	uint64_t m_useCounter = 0;
+	size_t m_hits = 0;
+	size_t m_misses = 0;
+	/// Hits and misses of previous runs, loaded from the file.
+	size_t m_previousHits = 0;
+	size_t m_previousMisses = 0;
+	std::vector<std::string> m_warnings;
+	std::mutex m_mutex;
+};
+
+}
+}
+}
@@ -0,0 +1,121 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/formal/SolverInterface.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity::smt;
+
+namespace
+{
+
+/// Table of all live expression nodes, indexed by their hash.
+/// Holds weak references only, expired entries are removed lazily.
+class ExpressionNodeTable
+{
+public:
+	static ExpressionNodeTable& instance()
+	{
+		static ExpressionNodeTable table;
+		return table;
+	}
+
+	shared_ptr<ExpressionNode const> intern(string _name, vector<Expression> _arguments, SortPointer _sort)
+	{
+		solAssert(_sort, "");
+		size_t hash = 0;
+		boost::hash_combine(hash, _name);
+		boost::hash_combine(hash, static_cast<int>(_sort->kind));
+		for (auto const& argument: _arguments)
+			boost::hash_combine(hash, Expression::IdentityHash{}(argument));
+
+		lock_guard<mutex> lock(m_mutex);
+		auto range = m_nodes.equal_range(hash);
+		for (auto it = range.first; it != range.second;)
+			if (shared_ptr<ExpressionNode const> node = it->second.lock())
+			{
+				if (
+					node->name == _name &&
+					equalArguments(node->arguments, _arguments) &&
+					(node->sort == _sort || *node->sort == *_sort)
+				)
+					return node;
+				++it;
+			}
+			else
+				it = m_nodes.erase(it);
+
+		auto node = make_shared<ExpressionNode const>(ExpressionNode{std::move(_name), std::move(_arguments), std::move(_sort)});
+		m_nodes.emplace(hash, node);
+		if (m_nodes.size() > 2 * m_sizeAfterCleanup)
+			removeExpired();
+		return node;
+	}
+
+private:
+	static bool equalArguments(vector<Expression> const& _a, vector<Expression> const& _b)
+	{
+		return _a.size() == _b.size() && equal(_a.begin(), _a.end(), _b.begin(), Expression::IdentityEqual{});
+	}
+
+	void removeExpired()
+	{
+		for (auto it = m_nodes.begin(); it != m_nodes.end();)
+			if (it->second.expired())
+				it = m_nodes.erase(it);
+			else
+				++it;
+		m_sizeAfterCleanup = max<size_t>(m_nodes.size(), 1024);
+	}
+
+	unordered_multimap<size_t, weak_ptr<ExpressionNode const>> m_nodes;
+	size_t m_sizeAfterCleanup = 1024;
+	mutex m_mutex;
+};
+
+}
+
+Expression::Expression(string _name, vector<Expression> _arguments, SortPointer _sort):
+	m_node(ExpressionNodeTable::instance().intern(std::move(_name), std::move(_arguments), std::move(_sort)))
+{
+}
+
+vector<Expression> Expression::conjuncts(Expression const& _expr)
+{
+	vector<Expression> result;
+	// Conjunctions built incrementally are deeply nested, so do not recurse.
+	vector<Expression> stack{_expr};
+	while (!stack.empty())
+	{
+		Expression current = std::move(stack.back());
+		stack.pop_back();
+		if (current.name() == "and" && current.arguments().size() == 2)
+		{
+			stack.push_back(current.arguments()[1]);
+			stack.push_back(current.arguments()[0]);
+		}
+		else if (!(current.name() == "true" && current.arguments().empty()))
+			result.push_back(std::move(current));
+	}
+	return result;
+}
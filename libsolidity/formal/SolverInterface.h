@@ -24,7 +24,9 @@
 
 #include <boost/noncopyable.hpp>
 #include <cstdio>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -110,11 +112,32 @@ struct ArraySort: public Sort
 	SortPointer range;
 };
 
+struct ExpressionNode;
+
 /// C++ representation of an SMTLIB2 expression.
+/// Expressions are immutable and hash-consed: structurally identical expressions
+/// share the same node, so copying an expression or using it as the argument
+/// of another one does not copy the subtree.
 class Expression
 {
 	friend class SolverInterface;
 public:
+	/// Hash and equality functors that identify expressions by their node, to be used
+	/// for memoising the translation of expressions. Since expressions are hash-consed,
+	/// this is equivalent to structural equality.
+	struct IdentityHash
+	{
+		size_t operator()(Expression const& _expr) const { return std::hash<ExpressionNode const*>{}(_expr.m_node.get()); }
+	};
+	struct IdentityEqual
+	{
+		bool operator()(Expression const& _a, Expression const& _b) const { return _a.m_node == _b.m_node; }
+	};
+	struct IdentityLess
+	{
+		bool operator()(Expression const& _a, Expression const& _b) const { return std::less<ExpressionNode const*>{}(_a.m_node.get(), _b.m_node.get()); }
+	};
+
 	explicit Expression(bool _v): Expression(_v ? "true" : "false", Kind::Bool) {}
 	Expression(size_t _number): Expression(std::to_string(_number), Kind::Int) {}
 	Expression(u256 const& _number): Expression(_number.str(), Kind::Int) {}
@@ -126,6 +149,10 @@ public:
 	Expression& operator=(Expression const&) = default;
 	Expression& operator=(Expression&&) = default;
 
+	std::string const& name() const;
+	std::vector<Expression> const& arguments() const;
+	SortPointer const& sort() const;
+
 	bool hasCorrectArity() const
 	{
 		static std::map<std::string, unsigned> const operatorsArity{
@@ -147,13 +174,13 @@ public:
 			{"select", 2},
 			{"store", 3}
 		};
-		return operatorsArity.count(name) && operatorsArity.at(name) == arguments.size();
+		return operatorsArity.count(name()) && operatorsArity.at(name()) == arguments().size();
 	}
 
 	static Expression ite(Expression _condition, Expression _trueValue, Expression _falseValue)
 	{
-		solAssert(*_trueValue.sort == *_falseValue.sort, "");
-		SortPointer sort = _trueValue.sort;
+		solAssert(*_trueValue.sort() == *_falseValue.sort(), "");
+		SortPointer sort = _trueValue.sort();
 		return Expression("ite", std::vector<Expression>{
 			std::move(_condition), std::move(_trueValue), std::move(_falseValue)
 		}, std::move(sort));
@@ -169,14 +196,18 @@ public:
 		);
 	}
 
+	/// @returns the operands of the possibly nested conjunction @a _expr from left to right,
+	/// leaving out the literal `true`.
+	static std::vector<Expression> conjuncts(Expression const& _expr);
+
 	/// select is the SMT representation of an array index access.
 	static Expression select(Expression _array, Expression _index)
 	{
-		solAssert(_array.sort->kind == Kind::Array, "");
-		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort);
+		solAssert(_array.sort()->kind == Kind::Array, "");
+		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort());
 		solAssert(arraySort, "");
-		solAssert(_index.sort, "");
-		solAssert(*arraySort->domain == *_index.sort, "");
+		solAssert(_index.sort(), "");
+		solAssert(*arraySort->domain == *_index.sort(), "");
 		return Expression(
 			"select",
 			std::vector<Expression>{std::move(_array), std::move(_index)},
@@ -188,13 +219,13 @@ public:
 	/// The function is pure and returns the modified array.
 	static Expression store(Expression _array, Expression _index, Expression _element)
 	{
-		solAssert(_array.sort->kind == Kind::Array, "");
-		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort);
+		solAssert(_array.sort()->kind == Kind::Array, "");
+		std::shared_ptr<ArraySort> arraySort = std::dynamic_pointer_cast<ArraySort>(_array.sort());
 		solAssert(arraySort, "");
-		solAssert(_index.sort, "");
-		solAssert(_element.sort, "");
-		solAssert(*arraySort->domain == *_index.sort, "");
-		solAssert(*arraySort->range == *_element.sort, "");
+		solAssert(_index.sort(), "");
+		solAssert(_element.sort(), "");
+		solAssert(*arraySort->domain == *_index.sort(), "");
+		solAssert(*arraySort->range == *_element.sort(), "");
 		return Expression(
 			"store",
 			std::vector<Expression>{std::move(_array), std::move(_index), std::move(_element)},
@@ -261,22 +292,17 @@ public:
 	Expression operator()(std::vector<Expression> _arguments) const
 	{
 		solAssert(
-			sort->kind == Kind::Function,
+			sort()->kind == Kind::Function,
 			"Attempted function application to non-function."
 		);
-		auto fSort = dynamic_cast<FunctionSort const*>(sort.get());
+		auto fSort = dynamic_cast<FunctionSort const*>(sort().get());
 		solAssert(fSort, "");
-		return Expression(name, std::move(_arguments), fSort->codomain);
+		return Expression(name(), std::move(_arguments), fSort->codomain);
 	}
 
-	std::string name;
-	std::vector<Expression> arguments;
-	SortPointer sort;
-
 private:
 	/// Manual constructors, should only be used by SolverInterface and this class itself.
-	Expression(std::string _name, std::vector<Expression> _arguments, SortPointer _sort):
-		name(std::move(_name)), arguments(std::move(_arguments)), sort(std::move(_sort)) {}
+	Expression(std::string _name, std::vector<Expression> _arguments, SortPointer _sort);
 	Expression(std::string _name, std::vector<Expression> _arguments, Kind _kind):
 		Expression(std::move(_name), std::move(_arguments), std::make_shared<Sort>(_kind)) {}
 
@@ -286,8 +312,24 @@ private:
 		Expression(std::move(_name), std::vector<Expression>{std::move(_arg)}, _kind) {}
 	Expression(std::string _name, Expression _arg1, Expression _arg2, Kind _kind):
 		Expression(std::move(_name), std::vector<Expression>{std::move(_arg1), std::move(_arg2)}, _kind) {}
+
+	std::shared_ptr<ExpressionNode const> m_node;
+};
+
+/// Node of the expression DAG. Nodes are only created through Expression, which
+/// ensures that there is at most one live node for each name, argument list and sort.
+struct ExpressionNode
+{
+	std::string name;
+	std::vector<Expression> arguments;
+	SortPointer sort;
 };
 
+inline std::string const& Expression::name() const { return m_node->name; }
+inline std::vector<Expression> const& Expression::arguments() const { return m_node->arguments; }
+inline SortPointer const& Expression::sort() const { return m_node->sort; }
+
+
 DEV_SIMPLE_EXCEPTION(SolverError);
 
 class SolverInterface
@@ -315,6 +357,11 @@ public:
 	virtual std::pair<CheckResult, std::vector<std::string>>
 	check(std::vector<Expression> const& _expressionsToEvaluate) = 0;
 
+	/// Asks a call to check() that is running concurrently in another thread to
+	/// return as soon as possible, with an answer that is neither SAT nor UNSAT.
+	/// Has to be thread-safe and must not affect later calls to check().
+	virtual void interrupt() {}
+
 	/// @returns a list of queries that the system was not able to respond to.
 	virtual std::vector<std::string> unhandledQueries() { return {}; }
 
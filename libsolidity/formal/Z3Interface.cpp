@@ -37,6 +37,7 @@ void Z3Interface::reset()
 {
 	m_constants.clear();
 	m_functions.clear();
+	m_translations.clear();
 	m_solver.reset();
 }
 
@@ -108,17 +109,34 @@ pair<CheckResult, vector<string>> Z3Interface::check(vector<Expression> const& _
 	return make_pair(result, values);
 }
 
+void Z3Interface::interrupt()
+{
+	// Interrupting the context would leave it cancelled, so that the next push fails.
+	// The solver-local interrupt only stops a check that is in progress.
+	Z3_solver_interrupt(m_context, m_solver);
+}
+
 z3::expr Z3Interface::toZ3Expr(Expression const& _expr)
 {
-	if (_expr.arguments.empty() && m_constants.count(_expr.name))
-		return m_constants.at(_expr.name);
+	auto it = m_translations.find(_expr);
+	if (it != m_translations.end())
+		return it->second;
+	z3::expr translation = newZ3Expr(_expr);
+	m_translations.emplace(_expr, translation);
+	return translation;
+}
+
+z3::expr Z3Interface::newZ3Expr(Expression const& _expr)
+{
+	if (_expr.arguments().empty() && m_constants.count(_expr.name()))
+		return m_constants.at(_expr.name());
 	z3::expr_vector arguments(m_context);
-	for (auto const& arg: _expr.arguments)
+	for (auto const& arg: _expr.arguments())
 		arguments.push_back(toZ3Expr(arg));
 
 	try
 	{
-		string const& n = _expr.name;
+		string const& n = _expr.name();
 		if (m_functions.count(n))
 			return m_functions.at(n)(arguments);
 		else if (m_constants.count(n))
@@ -21,6 +21,8 @@
 #include <boost/noncopyable.hpp>
 #include <z3++.h>
 
+#include <unordered_map>
+
 namespace dev
 {
 namespace solidity
@@ -42,11 +44,14 @@ public:
 
 	void addAssertion(Expression const& _expr) override;
 	std::pair<CheckResult, std::vector<std::string>> check(std::vector<Expression> const& _expressionsToEvaluate) override;
+	void interrupt() override;
 
 private:
 	void declareFunction(std::string const& _name, Sort const& _sort);
 
+	/// @returns the translation of @a _expr, memoised per expression node.
 	z3::expr toZ3Expr(Expression const& _expr);
+	z3::expr newZ3Expr(Expression const& _expr);
 	z3::sort z3Sort(smt::Sort const& _sort);
 	z3::sort_vector z3Sort(std::vector<smt::SortPointer> const& _sorts);
 
@@ -54,6 +59,7 @@ private:
 	z3::solver m_solver;
 	std::map<std::string, z3::expr> m_constants;
 	std::map<std::string, z3::func_decl> m_functions;
+	std::unordered_map<Expression, z3::expr, Expression::IdentityHash, Expression::IdentityEqual> m_translations;
 };
 
 }
@@ -186,6 +186,7 @@ void CompilerStack::reset(bool _keepSettings)
 	m_scopes.clear();
 	m_sourceOrder.clear();
 	m_contracts.clear();
+	m_functionLibrary.reset();
 	m_errorReporter.clear();
 	TypeProvider::reset();
 }
@@ -196,7 +197,7 @@ void CompilerStack::setSources(StringMap _sources)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Cannot change sources once set."));
 	if (m_stackState != Empty)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must set sources before parsing."));
-	for (auto source: _sources)
+	for (auto& source: _sources)
 		m_sources[source.first].scanner = make_shared<Scanner>(CharStream(/*content*/std::move(source.second), /*name*/source.first));
 	m_stackState = SourcesSet;
 }
@@ -231,11 +232,10 @@ bool CompilerStack::parse()
 		else
 		{
 			source.ast->annotation().path = path;
-			for (auto const& newSource: loadMissingSources(*source.ast, path))
+			for (auto& newSource: loadMissingSources(*source.ast, path))
 			{
 				string const& newPath = newSource.first;
-				string const& newContents = newSource.second;
-				m_sources[newPath].scanner = make_shared<Scanner>(CharStream(newContents, newPath));
+				m_sources[newPath].scanner = make_shared<Scanner>(CharStream(std::move(newSource.second), newPath));
 				sourcesToParse.push_back(newPath);
 			}
 		}
@@ -371,7 +371,7 @@ bool CompilerStack::analyze()
 
 		if (noErrors)
 		{
-			SMTChecker smtChecker(m_errorReporter, m_smtlib2Responses);
+			SMTChecker smtChecker(m_errorReporter, m_smtlib2Responses, m_smtQueryCache);
 			for (Source const* source: m_sourceOrder)
 				smtChecker.analyze(*source->ast, source->scanner);
 			m_unhandledSMTLib2Queries += smtChecker.unhandledQueries();
@@ -558,6 +558,14 @@ string const& CompilerStack::eWasm(string const& _contractName) const
 	return contract(_contractName).eWasm;
 }
 
+eth::LinkerObject const& CompilerStack::eWasmObject(string const& _contractName) const
+{
+	if (m_stackState != CompilationSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+
+	return contract(_contractName).eWasmObject;
+}
+
 eth::LinkerObject const& CompilerStack::object(string const& _contractName) const
 {
 	if (m_stackState != CompilationSuccessful)
@@ -575,31 +583,39 @@ eth::LinkerObject const& CompilerStack::runtimeObject(string const& _contractNam
 }
 
 /// TODO: cache this string
-string CompilerStack::assemblyString(string const& _contractName, StringMap _sourceCodes) const
+string CompilerStack::assemblyString(string const& _contractName) const
 {
 	if (m_stackState != CompilationSuccessful)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
 
 	Contract const& currentContract = contract(_contractName);
 	if (currentContract.compiler)
-		return currentContract.compiler->assemblyString(_sourceCodes);
+		return currentContract.compiler->assemblyString(sourceCodes());
 	else
 		return string();
 }
 
 /// TODO: cache the JSON
-Json::Value CompilerStack::assemblyJSON(string const& _contractName, StringMap const& _sourceCodes) const
+Json::Value CompilerStack::assemblyJSON(string const& _contractName) const
 {
 	if (m_stackState != CompilationSuccessful)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
 
 	Contract const& currentContract = contract(_contractName);
 	if (currentContract.compiler)
-		return currentContract.compiler->assemblyJSON(_sourceCodes);
+		return currentContract.compiler->assemblyJSON(sourceCodes());
 	else
 		return Json::Value();
 }
 
+SharedSourceMap CompilerStack::sourceCodes() const
+{
+	SharedSourceMap sourceCodes;
+	for (auto const& source: m_sources)
+		sourceCodes[source.first] = source.second.scanner->charStream()->sharedSource();
+	return sourceCodes;
+}
+
 vector<string> CompilerStack::sourceNames() const
 {
 	vector<string> names;
@@ -819,7 +835,7 @@ StringMap CompilerStack::loadMissingSources(SourceUnit const& _ast, std::string
 				result = m_readFile(importPath);
 
 			if (result.success)
-				newSources[importPath] = result.responseOrErrorMessage;
+				newSources[importPath] = std::move(result.responseOrErrorMessage);
 			else
 			{
 				m_errorReporter.parserError(
@@ -930,7 +946,9 @@ void CompilerStack::compileContract(
 
 	Contract& compiledContract = m_contracts.at(_contract.fullyQualifiedName());
 
-	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_evmVersion, m_optimiserSettings);
+	if (!m_functionLibrary)
+		m_functionLibrary = make_shared<YulFunctionLibrary>();
+	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_evmVersion, m_optimiserSettings, m_functionLibrary);
 	compiledContract.compiler = compiler;
 
 	bytes cborEncodedMetadata = createCBORMetadata(
@@ -1015,8 +1033,11 @@ void CompilerStack::generateEWasm(ContractDefinition const& _contract)
 
 	//cout << yul::AsmPrinter{}(*ewasmStack.parserResult()->code) << endl;
 
-	// Turn into eWasm text representation.
-	compiledContract.eWasm = ewasmStack.assemble(yul::AssemblyStack::Machine::eWasm).assembly;
+	// Turn into eWasm text and binary representation.
+	yul::MachineAssemblyObject object = ewasmStack.assemble(yul::AssemblyStack::Machine::eWasm);
+	compiledContract.eWasm = move(object.assembly);
+	solAssert(object.bytecode, "");
+	compiledContract.eWasmObject = move(*object.bytecode);
 }
 
 CompilerStack::Contract const& CompilerStack::contract(string const& _contractName) const
@@ -1093,11 +1114,14 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 	static_assert(sizeof(m_optimiserSettings.expectedExecutionsPerDeployment) <= sizeof(Json::LargestUInt), "Invalid word size.");
 	solAssert(static_cast<Json::LargestUInt>(m_optimiserSettings.expectedExecutionsPerDeployment) < std::numeric_limits<Json::LargestUInt>::max(), "");
 	meta["settings"]["optimizer"]["runs"] = Json::Value(Json::LargestUInt(m_optimiserSettings.expectedExecutionsPerDeployment));
+	if (m_optimiserSettings.executionProfile)
+		meta["settings"]["optimizer"]["profile"] = m_optimiserSettings.executionProfile->toJson();
 
 	/// Backwards compatibility: If set to one of the default settings, do not provide details.
 	OptimiserSettings settingsWithoutRuns = m_optimiserSettings;
 	// reset to default
 	settingsWithoutRuns.expectedExecutionsPerDeployment = OptimiserSettings::minimal().expectedExecutionsPerDeployment;
+	settingsWithoutRuns.executionProfile = nullptr;
 	if (settingsWithoutRuns == OptimiserSettings::minimal())
 		meta["settings"]["optimizer"]["enabled"] = false;
 	else if (settingsWithoutRuns == OptimiserSettings::standard())
@@ -1361,18 +1385,19 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 	{
 		/// External functions
 		ContractDefinition const& contract = contractDefinition(_contractName);
+		auto const& tagTables = this->contract(_contractName).compiler->runtimeAssemblyPtr()->tagTables();
 		Json::Value externalFunctions(Json::objectValue);
 		for (auto it: contract.interfaceFunctions())
 		{
 			string sig = it.second->externalSignature();
-			externalFunctions[sig] = gasToJson(gasEstimator.functionalEstimation(*items, sig));
+			externalFunctions[sig] = gasToJson(gasEstimator.functionalEstimation(*items, sig, tagTables));
 		}
 
 		if (contract.fallbackFunction())
 			/// This needs to be set to an invalid signature in order to trigger the fallback,
 			/// without the shortcut (of CALLDATSIZE == 0), and therefore to receive the upper bound.
 			/// An empty string ("") would work to trigger the shortcut only.
-			externalFunctions[""] = gasToJson(gasEstimator.functionalEstimation(*items, "INVALID"));
+			externalFunctions[""] = gasToJson(gasEstimator.functionalEstimation(*items, "INVALID", tagTables));
 
 		if (!externalFunctions.empty())
 			output["external"] = externalFunctions;
@@ -63,6 +63,11 @@ using AssemblyItems = std::vector<AssemblyItem>;
 namespace solidity
 {
 
+namespace smt
+{
+class QueryCache;
+}
+
 // forward declarations
 class ASTNode;
 class ContractDefinition;
@@ -72,6 +77,7 @@ class Compiler;
 class GlobalContext;
 class Natspec;
 class DeclarationContainer;
+class YulFunctionLibrary;
 
 /**
  * Easy to use and self-contained Solidity compiler with as few header dependencies as possible.
@@ -168,6 +174,10 @@ public:
 	/// Must be set before parsing.
 	void addSMTLib2Response(h256 const& _hash, std::string const& _response);
 
+	/// Sets a cache the SMTChecker consults before querying the solvers and fills
+	/// with new answers. The cache is kept on reset. Must be set before analysis.
+	void setSMTQueryCache(std::shared_ptr<smt::QueryCache> _queryCache) { m_smtQueryCache = std::move(_queryCache); }
+
 	/// Parses all source units that were added
 	/// @returns false on error.
 	bool parse();
@@ -225,6 +235,9 @@ public:
 	/// @returns the eWasm (text) representation of a contract.
 	std::string const& eWasm(std::string const& _contractName) const;
 
+	/// @returns the eWasm (binary) representation of a contract.
+	eth::LinkerObject const& eWasmObject(std::string const& _contractName) const;
+
 	/// @returns the assembled object for a contract.
 	eth::LinkerObject const& object(std::string const& _contractName) const;
 
@@ -245,15 +258,13 @@ public:
 	/// if the contract does not (yet) have bytecode.
 	std::string const* runtimeSourceMapping(std::string const& _contractName) const;
 
-	/// @return a verbose text representation of the assembly.
-	/// @arg _sourceCodes is the map of input files to source code strings
+	/// @return a verbose text representation of the assembly, annotated with the source code.
 	/// Prerequisite: Successful compilation.
-	std::string assemblyString(std::string const& _contractName, StringMap _sourceCodes = StringMap()) const;
+	std::string assemblyString(std::string const& _contractName) const;
 
 	/// @returns a JSON representation of the assembly.
-	/// @arg _sourceCodes is the map of input files to source code strings
 	/// Prerequisite: Successful compilation.
-	Json::Value assemblyJSON(std::string const& _contractName, StringMap const& _sourceCodes = StringMap()) const;
+	Json::Value assemblyJSON(std::string const& _contractName) const;
 
 	/// @returns a JSON representing the contract ABI.
 	/// Prerequisite: Successful call to parse or compile.
@@ -276,6 +287,10 @@ public:
 	/// @returns a JSON representing the estimated gas usage for contract creation, internal and external functions
 	Json::Value gasEstimates(std::string const& _contractName) const;
 
+	/// @returns the library of ABI functions shared between the contracts of the last compilation.
+	/// Used for testing and to report how often generated functions are reused.
+	YulFunctionLibrary const* functionLibrary() const { return m_functionLibrary.get(); }
+
 	/// Overwrites the release/prerelease flag. Should only be used for testing.
 	void overwriteReleaseFlag(bool release) { m_release = release; }
 private:
@@ -303,6 +318,7 @@ private:
 		std::string yulIR; ///< Experimental Yul IR code.
 		std::string yulIROptimized; ///< Optimized experimental Yul IR code.
 		std::string eWasm; ///< Experimental eWasm code (text representation).
+		eth::LinkerObject eWasmObject; ///< Experimental eWasm code (binary representation).
 		mutable std::unique_ptr<std::string const> metadata; ///< The metadata json that will be hashed into the chain.
 		mutable std::unique_ptr<Json::Value const> abi;
 		mutable std::unique_ptr<Json::Value const> userDocumentation;
@@ -315,6 +331,8 @@ private:
 	/// @a m_readFile and stores the absolute paths of all imports in the AST annotations.
 	/// @returns the newly loaded sources.
 	StringMap loadMissingSources(SourceUnit const& _ast, std::string const& _path);
+	/// @returns the source code of all sources, sharing the buffers of their scanners.
+	langutil::SharedSourceMap sourceCodes() const;
 	std::string applyRemapping(std::string const& _path, std::string const& _context);
 	void resolveImports();
 
@@ -397,11 +415,15 @@ private:
 	std::map<std::string const, Source> m_sources;
 	std::vector<std::string> m_unhandledSMTLib2Queries;
 	std::map<h256, std::string> m_smtlib2Responses;
+	std::shared_ptr<smt::QueryCache> m_smtQueryCache;
 	std::shared_ptr<GlobalContext> m_globalContext;
 	std::vector<Source const*> m_sourceOrder;
 	/// This is updated during compilation.
 	std::map<ASTNode const*, std::shared_ptr<DeclarationContainer>> m_scopes;
 	std::map<std::string const, Contract> m_contracts;
+	/// Generated ABI functions shared between the contracts of one compilation.
+	/// Names of these functions contain AST IDs, so it is cleared together with the sources.
+	std::shared_ptr<YulFunctionLibrary> m_functionLibrary;
 	langutil::ErrorList m_errorList;
 	langutil::ErrorReporter m_errorReporter;
 	bool m_metadataLiteralSources = false;
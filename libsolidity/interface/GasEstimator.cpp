@@ -130,7 +130,8 @@ map<ASTNode const*, GasMeter::GasConsumption> GasEstimator::breakToStatementLeve
 
 GasEstimator::GasConsumption GasEstimator::functionalEstimation(
 	AssemblyItems const& _items,
-	string const& _signature
+	string const& _signature,
+	map<h256, vector<size_t>> const& _tagTables
 ) const
 {
 	auto state = make_shared<KnownState>();
@@ -164,7 +165,7 @@ GasEstimator::GasConsumption GasEstimator::functionalEstimation(
 		);
 	}
 
-	return PathGasMeter::estimateMax(_items, m_evmVersion, 0, state);
+	return PathGasMeter::estimateMax(_items, m_evmVersion, 0, state, _tagTables);
 }
 
 GasEstimator::GasConsumption GasEstimator::functionalEstimation(
@@ -67,9 +67,12 @@ public:
 
 	/// @returns the estimated gas consumption by the (public or external) function with the
 	/// given signature. If no signature is given, estimates the maximum gas usage.
+	/// @param _tagTables the tag tables of the assembly, used to follow the jumps of a
+	/// jump table function dispatcher.
 	GasConsumption functionalEstimation(
 		eth::AssemblyItems const& _items,
-		std::string const& _signature = ""
+		std::string const& _signature = "",
+		std::map<h256, std::vector<size_t>> const& _tagTables = {}
 	) const;
 
 	/// @returns the estimated gas consumption by the given function which starts at the given
@@ -22,7 +22,12 @@
 
 #pragma once
 
+#include <libevmasm/ExecutionProfile.h>
+
+#include <liblangutil/SourceLocation.h>
+
 #include <cstddef>
+#include <memory>
 
 namespace dev
 {
@@ -80,7 +85,20 @@ struct OptimiserSettings
 			runConstantOptimiser == _other.runConstantOptimiser &&
 			optimizeStackAllocation == _other.optimizeStackAllocation &&
 			runYulOptimiser == _other.runYulOptimiser &&
-			expectedExecutionsPerDeployment == _other.expectedExecutionsPerDeployment;
+			expectedExecutionsPerDeployment == _other.expectedExecutionsPerDeployment &&
+			(executionProfile && _other.executionProfile ?
+				*executionProfile == *_other.executionProfile :
+				executionProfile == _other.executionProfile
+			);
+	}
+
+	/// @returns the expected number of executions of the code at @a _location according
+	/// to the execution profile, or expectedExecutionsPerDeployment if it is not covered.
+	size_t expectedExecutions(langutil::SourceLocation const& _location) const
+	{
+		if (!executionProfile)
+			return expectedExecutionsPerDeployment;
+		return executionProfile->executions(_location, expectedExecutionsPerDeployment);
 	}
 
 	/// Move literals to the right of commutative binary operators during code generation.
@@ -104,6 +122,13 @@ struct OptimiserSettings
 	/// This specifies an estimate on how often each opcode in this assembly will be executed,
 	/// i.e. use a small value to optimise for size and a large value to optimise for runtime gas usage.
 	size_t expectedExecutionsPerDeployment = 200;
+	/// Recorded execution counts of parts of the runtime code, which override
+	/// expectedExecutionsPerDeployment for these parts. Can be nullptr.
+	std::shared_ptr<eth::ExecutionProfile const> executionProfile;
+	/// Maximum number of threads used to optimise functions and to optimise and compile
+	/// Yul sub-objects concurrently.
+	/// Does not influence the result and is thus not part of the comparison above.
+	size_t yulThreads = 1;
 };
 
 }
@@ -22,6 +22,7 @@
 
 #include <libsolidity/interface/StandardCompiler.h>
 
+#include <libsolidity/ast/ASTCBORConverter.h>
 #include <libsolidity/ast/ASTJsonConverter.h>
 #include <libyul/AssemblyStack.h>
 #include <liblangutil/SourceReferenceFormatter.h>
@@ -31,6 +32,8 @@
 
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/stream.hpp>
 #include <boost/optional.hpp>
 #include <algorithm>
 
@@ -70,6 +73,38 @@ Json::Value formatFatalError(string const& _type, string const& _message)
 	return output;
 }
 
+/// @returns the output reporting the exception that is currently being handled.
+Json::Value formatCurrentException()
+{
+	try
+	{
+		throw;
+	}
+	catch (Json::LogicError const& _exception)
+	{
+		return formatFatalError("InternalCompilerError", string("JSON logic exception: ") + _exception.what());
+	}
+	catch (Json::RuntimeError const& _exception)
+	{
+		return formatFatalError("InternalCompilerError", string("JSON runtime exception: ") + _exception.what());
+	}
+	catch (Exception const& _exception)
+	{
+		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compile: " + boost::diagnostic_information(_exception));
+	}
+	catch (...)
+	{
+		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compile");
+	}
+}
+
+/// Passes the members of @a _object to @a _output.
+void writeMembers(Json::Value const& _object, function<void(vector<string> const&, Json::Value)> const& _output)
+{
+	for (string const& key: _object.getMemberNames())
+		_output({key}, _object[key]);
+}
+
 Json::Value formatErrorWithException(
 	Exception const& _exception,
 	bool const& _warning,
@@ -131,14 +166,14 @@ bool hashMatchesContent(string const& _hash, string const& _content)
 
 bool isArtifactRequested(Json::Value const& _outputSelection, string const& _artifact, bool _wildcardMatchesExperimental)
 {
-	static set<string> experimental{"ir", "irOptimized", "wast", "ewasm", "ewasm.wast"};
+	static set<string> experimental{"ir", "irOptimized", "wast", "ewasm", "ewasm.wast", "ewasm.wasm"};
 	for (auto const& artifact: _outputSelection)
 		/// @TODO support sub-matching, e.g "evm" matches "evm.assembly"
 		if (artifact == _artifact)
 			return true;
 		else if (artifact == "*")
 		{
-			// "ir", "irOptimized", "wast" and "ewasm.wast" can only be matched by "*" if activated.
+			// "ir", "irOptimized", "wast", "ewasm.wast" and "ewasm.wasm" can only be matched by "*" if activated.
 			if (experimental.count(_artifact) == 0 || _wildcardMatchesExperimental)
 				return true;
 		}
@@ -218,7 +253,7 @@ bool isBinaryRequested(Json::Value const& _outputSelection)
 }
 
 /// @returns true if any eWasm code was requested. Note that as an exception, '*' does not
-/// yet match "ewasm.wast" or "ewasm"
+/// yet match "ewasm.wast", "ewasm.wasm" or "ewasm"
 bool isEWasmRequested(Json::Value const& _outputSelection)
 {
 	if (!_outputSelection.isObject())
@@ -227,7 +262,7 @@ bool isEWasmRequested(Json::Value const& _outputSelection)
 	for (auto const& fileRequests: _outputSelection)
 		for (auto const& requests: fileRequests)
 			for (auto const& request: requests)
-				if (request == "ewasm" || request == "ewasm.wast")
+				if (request == "ewasm" || request == "ewasm.wast" || request == "ewasm.wasm")
 					return true;
 
 	return false;
@@ -321,13 +356,13 @@ boost::optional<Json::Value> checkAuxiliaryInputKeys(Json::Value const& _input)
 
 boost::optional<Json::Value> checkSettingsKeys(Json::Value const& _input)
 {
-	static set<string> keys{"parserErrorRecovery", "evmVersion", "libraries", "metadata", "optimizer", "outputSelection", "remappings"};
+	static set<string> keys{"parserErrorRecovery", "evmVersion", "libraries", "metadata", "optimizer", "outputSelection", "remappings", "threads"};
 	return checkKeys(_input, keys, "settings");
 }
 
 boost::optional<Json::Value> checkOptimizerKeys(Json::Value const& _input)
 {
-	static set<string> keys{"details", "enabled", "runs"};
+	static set<string> keys{"details", "enabled", "profile", "runs"};
 	return checkKeys(_input, keys, "settings.optimizer");
 }
 
@@ -424,6 +459,18 @@ boost::variant<OptimiserSettings, Json::Value> parseOptimizerSettings(Json::Valu
 		settings.expectedExecutionsPerDeployment = _jsonInput["runs"].asUInt();
 	}
 
+	if (_jsonInput.isMember("profile"))
+	{
+		try
+		{
+			settings.executionProfile = make_shared<eth::ExecutionProfile>(eth::ExecutionProfile::fromJson(_jsonInput["profile"]));
+		}
+		catch (eth::InvalidExecutionProfile const& _exception)
+		{
+			return formatFatalError("JSONError", *boost::get_error_info<errinfo_comment>(_exception));
+		}
+	}
+
 	if (_jsonInput.isMember("details"))
 	{
 		Json::Value const& details = _jsonInput["details"];
@@ -505,7 +552,7 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 					"Mismatch between content and supplied hash for \"" + sourceName + "\""
 				));
 			else
-				ret.sources[sourceName] = content;
+				ret.sources[sourceName] = std::move(content);
 		}
 		else if (sources[sourceName]["urls"].isArray())
 		{
@@ -635,6 +682,13 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 			ret.optimiserSettings = boost::get<OptimiserSettings>(std::move(optimiserSettings));
 	}
 
+	if (settings.isMember("threads"))
+	{
+		if (!settings["threads"].isUInt() || settings["threads"].asUInt() == 0)
+			return formatFatalError("JSONError", "\"settings.threads\" must be a positive integer.");
+		ret.optimiserSettings.yulThreads = settings["threads"].asUInt();
+	}
+
 	Json::Value jsonLibraries = settings.get("libraries", Json::Value(Json::objectValue));
 	if (!jsonLibraries.isObject())
 		return formatFatalError("JSONError", "\"libraries\" is not a JSON object.");
@@ -693,12 +747,11 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 	return { std::move(ret) };
 }
 
-Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSettings _inputsAndSettings)
+void StandardCompiler::compileSolidity(StandardCompiler::InputsAndSettings _inputsAndSettings, OutputWriter const& _output)
 {
 	CompilerStack compilerStack(m_readFile);
 
-	StringMap sourceList = std::move(_inputsAndSettings.sources);
-	compilerStack.setSources(sourceList);
+	compilerStack.setSources(std::move(_inputsAndSettings.sources));
 	for (auto const& smtLib2Response: _inputsAndSettings.smtLib2Responses)
 		compilerStack.addSMTLib2Response(smtLib2Response.first, smtLib2Response.second);
 	compilerStack.setEVMVersion(_inputsAndSettings.evmVersion);
@@ -821,39 +874,39 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 
 	/// Inconsistent state - stop here to receive error reports from users
 	if (((binariesRequested && !compilationSuccess) || !analysisSuccess) && errors.empty())
-		return formatFatalError("InternalCompilerError", "No error reported, but compilation failed.");
-
-	Json::Value output = Json::objectValue;
-
-	if (errors.size() > 0)
-		output["errors"] = std::move(errors);
+	{
+		writeMembers(formatFatalError("InternalCompilerError", "No error reported, but compilation failed."), _output);
+		return;
+	}
 
+	// The members are written in the order of their keys, so that the output can be streamed.
 	if (!compilerStack.unhandledSMTLib2Queries().empty())
+	{
+		Json::Value queries = Json::objectValue;
 		for (string const& query: compilerStack.unhandledSMTLib2Queries())
-			output["auxiliaryInputRequested"]["smtlib2queries"]["0x" + keccak256(query).hex()] = query;
+			queries["0x" + keccak256(query).hex()] = query;
+		_output({"auxiliaryInputRequested", "smtlib2queries"}, std::move(queries));
+	}
 
 	bool const wildcardMatchesExperimental = false;
 
-	output["sources"] = Json::objectValue;
-	unsigned sourceIndex = 0;
-	for (string const& sourceName: analysisSuccess ? compilerStack.sourceNames() : vector<string>())
-	{
-		Json::Value sourceResult = Json::objectValue;
-		sourceResult["id"] = sourceIndex++;
-		if (isArtifactRequested(_inputsAndSettings.outputSelection, sourceName, "", "ast", wildcardMatchesExperimental))
-			sourceResult["ast"] = ASTJsonConverter(false, compilerStack.sourceIndices()).toJson(compilerStack.ast(sourceName));
-		if (isArtifactRequested(_inputsAndSettings.outputSelection, sourceName, "", "legacyAST", wildcardMatchesExperimental))
-			sourceResult["legacyAST"] = ASTJsonConverter(true, compilerStack.sourceIndices()).toJson(compilerStack.ast(sourceName));
-		output["sources"][sourceName] = sourceResult;
-	}
-
-	Json::Value contractsOutput = Json::objectValue;
-	for (string const& contractName: analysisSuccess ? compilerStack.contractNames() : vector<string>())
+	// The output is ordered by file and then by contract name, which differs from the order
+	// of the qualified contract names if a file name is a prefix of another one.
+	auto fileAndName = [](string const& _contractName)
 	{
-		size_t colon = contractName.rfind(':');
+		size_t colon = _contractName.rfind(':');
 		solAssert(colon != string::npos, "");
-		string file = contractName.substr(0, colon);
-		string name = contractName.substr(colon + 1);
+		return make_pair(_contractName.substr(0, colon), _contractName.substr(colon + 1));
+	};
+	vector<string> contractNames = analysisSuccess ? compilerStack.contractNames() : vector<string>();
+	sort(contractNames.begin(), contractNames.end(), [&](string const& _a, string const& _b) {
+		return fileAndName(_a) < fileAndName(_b);
+	});
+	for (string const& contractName: contractNames)
+	{
+		string file;
+		string name;
+		tie(file, name) = fileAndName(contractName);
 
 		// ABI, documentation and metadata
 		Json::Value contractData(Json::objectValue);
@@ -875,13 +928,15 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 		// eWasm
 		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "ewasm.wast", wildcardMatchesExperimental))
 			contractData["ewasm"]["wast"] = compilerStack.eWasm(contractName);
+		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "ewasm.wasm", wildcardMatchesExperimental))
+			contractData["ewasm"]["wasm"] = compilerStack.eWasmObject(contractName).toHex();
 
 		// EVM
 		Json::Value evmData(Json::objectValue);
 		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.assembly", wildcardMatchesExperimental))
-			evmData["assembly"] = compilerStack.assemblyString(contractName, sourceList);
+			evmData["assembly"] = compilerStack.assemblyString(contractName);
 		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.legacyAssembly", wildcardMatchesExperimental))
-			evmData["legacyAssembly"] = compilerStack.assemblyJSON(contractName, sourceList);
+			evmData["legacyAssembly"] = compilerStack.assemblyJSON(contractName);
 		if (isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.methodIdentifiers", wildcardMatchesExperimental))
 			evmData["methodIdentifiers"] = compilerStack.methodIdentifiers(contractName);
 		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.gasEstimates", wildcardMatchesExperimental))
@@ -915,16 +970,28 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 			contractData["evm"] = evmData;
 
 		if (!contractData.empty())
-		{
-			if (!contractsOutput.isMember(file))
-				contractsOutput[file] = Json::objectValue;
-			contractsOutput[file][name] = contractData;
-		}
+			_output({"contracts", file, name}, std::move(contractData));
 	}
-	if (!contractsOutput.empty())
-		output["contracts"] = contractsOutput;
 
-	return output;
+	if (errors.size() > 0)
+		_output({"errors"}, std::move(errors));
+
+	vector<string> sourceNames = analysisSuccess ? compilerStack.sourceNames() : vector<string>();
+	if (sourceNames.empty())
+		_output({"sources"}, Json::objectValue);
+	unsigned sourceIndex = 0;
+	for (string const& sourceName: sourceNames)
+	{
+		Json::Value sourceResult = Json::objectValue;
+		sourceResult["id"] = sourceIndex++;
+		if (isArtifactRequested(_inputsAndSettings.outputSelection, sourceName, "", "ast", wildcardMatchesExperimental))
+			sourceResult["ast"] = ASTJsonConverter(false, compilerStack.sourceIndices()).toJson(compilerStack.ast(sourceName));
+		if (isArtifactRequested(_inputsAndSettings.outputSelection, sourceName, "", "legacyAST", wildcardMatchesExperimental))
+			sourceResult["legacyAST"] = ASTJsonConverter(true, compilerStack.sourceIndices()).toJson(compilerStack.ast(sourceName));
+		if (isArtifactRequested(_inputsAndSettings.outputSelection, sourceName, "", "astCBOR", wildcardMatchesExperimental))
+			sourceResult["astCBOR"] = toBase64(ASTCBORConverter(compilerStack.sourceIndices()).toCBOR(compilerStack.ast(sourceName)));
+		_output({"sources", sourceName}, std::move(sourceResult));
+	}
 }
 
 
@@ -1006,63 +1073,103 @@ Json::Value StandardCompiler::compileYul(InputsAndSettings _inputsAndSettings)
 
 Json::Value StandardCompiler::compile(Json::Value const& _input) noexcept
 {
-	YulStringRepository::reset();
-
 	try
 	{
-		auto parsed = parseInput(_input);
-		if (parsed.type() == typeid(Json::Value))
-			return boost::get<Json::Value>(std::move(parsed));
-		InputsAndSettings settings = boost::get<InputsAndSettings>(std::move(parsed));
-		if (settings.language == "Solidity")
-			return compileSolidity(std::move(settings));
-		else if (settings.language == "Yul")
-			return compileYul(std::move(settings));
-		else
-			return formatFatalError("JSONError", "Only \"Solidity\" or \"Yul\" is supported as a language.");
-	}
-	catch (Json::LogicError const& _exception)
-	{
-		return formatFatalError("InternalCompilerError", string("JSON logic exception: ") + _exception.what());
-	}
-	catch (Json::RuntimeError const& _exception)
-	{
-		return formatFatalError("InternalCompilerError", string("JSON runtime exception: ") + _exception.what());
-	}
-	catch (Exception const& _exception)
-	{
-		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compile: " + boost::diagnostic_information(_exception));
+		Json::Value output = Json::objectValue;
+		compile(_input, [&](vector<string> const& _path, Json::Value _value) {
+			Json::Value* member = &output;
+			for (string const& key: _path)
+				member = &(*member)[key];
+			*member = std::move(_value);
+		});
+		return output;
 	}
 	catch (...)
 	{
-		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compile");
+		return formatCurrentException();
 	}
 }
 
 string StandardCompiler::compile(string const& _input) noexcept
+{
+	string output;
+	{
+		boost::iostreams::stream<boost::iostreams::back_insert_device<string>> stream(output);
+		compile(_input, stream);
+	}
+	return output;
+}
+
+void StandardCompiler::compile(string const& _input, ostream& _output) noexcept
 {
 	Json::Value input;
 	string errors;
 	try
 	{
 		if (!jsonParseStrict(_input, input, &errors))
-			return jsonCompactPrint(formatFatalError("JSONError", errors));
+		{
+			jsonCompactPrint(formatFatalError("JSONError", errors), _output);
+			return;
+		}
 	}
 	catch (...)
 	{
-		return "{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Error parsing input JSON.\"}]}";
+		_output << "{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Error parsing input JSON.\"}]}";
+		return;
 	}
 
-	// cout << "Input: " << input.toStyledString() << endl;
-	Json::Value output = compile(input);
-	// cout << "Output: " << output.toStyledString() << endl;
+	streamOutput([&](OutputWriter const& _writer) { compile(input, _writer); }, _output);
+}
 
+void StandardCompiler::streamOutput(function<void(OutputWriter const&)> const& _produce, ostream& _output) noexcept
+{
+	JsonStreamWriter writer(_output);
+	// The members from "errors" on are held back until everything has been produced,
+	// so that an exception can still be reported together with the other errors.
+	Json::Value heldBack = Json::objectValue;
 	try
 	{
-		return jsonCompactPrint(output);
+		_produce([&](vector<string> const& _path, Json::Value _value) {
+			if (_path.front() < "errors")
+				writer.write(_path, _value);
+			else
+			{
+				Json::Value* member = &heldBack;
+				for (string const& key: _path)
+					member = &(*member)[key];
+				*member = std::move(_value);
+			}
+		});
 	}
 	catch (...)
 	{
-		return "{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Error writing output JSON.\"}]}";
+		// The output held back is incomplete, so only the errors are kept.
+		Json::Value errors = heldBack.isMember("errors") ? heldBack["errors"] : Json::Value(Json::arrayValue);
+		Json::Value exceptionOutput = formatCurrentException();
+		for (auto const& error: exceptionOutput["errors"])
+			errors.append(error);
+		heldBack = Json::objectValue;
+		heldBack["errors"] = std::move(errors);
 	}
+	writer.writeMembers(heldBack);
+	writer.finish();
+}
+
+void StandardCompiler::compile(Json::Value const& _input, OutputWriter const& _output)
+{
+	YulStringRepository::reset();
+
+	auto parsed = parseInput(_input);
+	if (parsed.type() == typeid(Json::Value))
+	{
+		writeMembers(boost::get<Json::Value>(parsed), _output);
+		return;
+	}
+	InputsAndSettings settings = boost::get<InputsAndSettings>(std::move(parsed));
+	if (settings.language == "Solidity")
+		compileSolidity(std::move(settings), _output);
+	else if (settings.language == "Yul")
+		writeMembers(compileYul(std::move(settings)), _output);
+	else
+		writeMembers(formatFatalError("JSONError", "Only \"Solidity\" or \"Yul\" is supported as a language."), _output);
 }
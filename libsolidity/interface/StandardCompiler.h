@@ -27,6 +27,9 @@
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
 
+#include <functional>
+#include <ostream>
+
 namespace dev
 {
 
@@ -54,8 +57,20 @@ public:
 	/// Parses input as JSON and peforms the above processing steps, returning a serialized JSON
 	/// output. Parsing errors are returned as regular errors.
 	std::string compile(std::string const& _input) noexcept;
+	/// Same as above, but writes the serialized output to @a _output as soon as the artifacts
+	/// of a contract are produced, instead of building the complete output first.
+	void compile(std::string const& _input, std::ostream& _output) noexcept;
+
+	/// Receives the members of the output, identified by their path of keys, in the order of their paths.
+	using OutputWriter = std::function<void(std::vector<std::string> const& _path, Json::Value _value)>;
+
+	/// Writes the members that @a _produce passes to its writer to @a _output. The members before
+	/// "errors" are written immediately, the others only after @a _produce has returned. If it throws,
+	/// the exception is reported in "errors" and the members after "errors" are dropped.
+	static void streamOutput(std::function<void(OutputWriter const&)> const& _produce, std::ostream& _output) noexcept;
 
 private:
+
 	struct InputsAndSettings
 	{
 		std::string language;
@@ -75,7 +90,11 @@ private:
 	/// it in condensed form or an error as a json object.
 	boost::variant<InputsAndSettings, Json::Value> parseInput(Json::Value const& _input);
 
-	Json::Value compileSolidity(InputsAndSettings _inputsAndSettings);
+	/// Performs the compilation according to @a _input and passes the output to @a _output.
+	/// Exceptions are not caught.
+	void compile(Json::Value const& _input, OutputWriter const& _output);
+
+	void compileSolidity(InputsAndSettings _inputsAndSettings, OutputWriter const& _output);
 	Json::Value compileYul(InputsAndSettings _inputsAndSettings);
 
 	ReadCallback::Callback m_readFile;
@@ -43,8 +43,13 @@
 #include <libevmasm/Assembly.h>
 #include <liblangutil/Scanner.h>
 
+#include <libdevcore/Parallel.h>
+
+#include <functional>
+
 using namespace std;
 using namespace langutil;
+using namespace dev;
 using namespace yul;
 
 namespace
@@ -135,28 +140,42 @@ void AssemblyStack::compileEVM(AbstractAssembly& _assembly, bool _evm15, bool _o
 	else
 		solAssert(false, "Invalid language.");
 
-	EVMObjectCompiler::compile(*m_parserResult, _assembly, *dialect, _evm15, _optimize);
+	EVMObjectCompiler::compile(*m_parserResult, _assembly, *dialect, _evm15, _optimize, m_optimiserSettings.yulThreads);
 }
 
 void AssemblyStack::optimize(Object& _object, bool _isCreation)
 {
-	solAssert(_object.code, "");
-	solAssert(_object.analysisInfo, "");
-	for (auto& subNode: _object.subObjects)
-		if (auto subObject = dynamic_cast<Object*>(subNode.get()))
-			optimize(*subObject, false);
-
+	// The objects are optimised independently of each other, so they can be
+	// processed concurrently.
+	vector<pair<Object*, bool>> objects;
+	function<void(Object&, bool)> collect = [&](Object& _current, bool _creation) {
+		solAssert(_current.code, "");
+		solAssert(_current.analysisInfo, "");
+		for (auto& subNode: _current.subObjects)
+			if (auto subObject = dynamic_cast<Object*>(subNode.get()))
+				collect(*subObject, false);
+		objects.emplace_back(&_current, _creation);
+	};
+	collect(_object, _isCreation);
+
+	size_t threads = m_optimiserSettings.yulThreads;
+	size_t threadsPerObject = objects.size() > 1 ? 1 : threads;
 	Dialect const& dialect = languageToDialect(m_language, m_evmVersion);
-	unique_ptr<GasMeter> meter;
-	if (EVMDialect const* evmDialect = dynamic_cast<EVMDialect const*>(&dialect))
-		meter = make_unique<GasMeter>(*evmDialect, _isCreation, m_optimiserSettings.expectedExecutionsPerDeployment);
-	OptimiserSuite::run(
-		dialect,
-		meter.get(),
-		*_object.code,
-		*_object.analysisInfo,
-		m_optimiserSettings.optimizeStackAllocation
-	);
+	parallelFor(objects.size(), threads, [&](size_t _index) {
+		Object& object = *objects[_index].first;
+		unique_ptr<GasMeter> meter;
+		if (EVMDialect const* evmDialect = dynamic_cast<EVMDialect const*>(&dialect))
+			meter = make_unique<GasMeter>(*evmDialect, objects[_index].second, m_optimiserSettings.expectedExecutionsPerDeployment);
+		OptimiserSuite::run(
+			dialect,
+			meter.get(),
+			*object.code,
+			*object.analysisInfo,
+			m_optimiserSettings.optimizeStackAllocation,
+			{},
+			threadsPerObject
+		);
+	});
 }
 
 MachineAssemblyObject AssemblyStack::assemble(Machine _machine) const
@@ -193,7 +212,10 @@ MachineAssemblyObject AssemblyStack::assemble(Machine _machine) const
 		Dialect const& dialect = languageToDialect(m_language, EVMVersion{});
 
 		MachineAssemblyObject object;
-		object.assembly = EWasmObjectCompiler::compile(*m_parserResult, dialect);
+		auto result = EWasmObjectCompiler::compile(*m_parserResult, dialect);
+		object.assembly = std::move(result.first);
+		object.bytecode = make_shared<dev::eth::LinkerObject>();
+		object.bytecode->bytecode = std::move(result.second);
 		return object;
 	}
 	}
@@ -22,8 +22,12 @@
 
 #include <boost/noncopyable.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <functional>
@@ -35,6 +39,8 @@ namespace yul
 /// Owns the string data for all YulStrings, which can be referenced by a Handle.
 /// A Handle consists of an ID (that depends on the insertion order of YulStrings and is potentially
 /// non-deterministic) and a deterministic string hash.
+/// Creating and looking up strings is thread-safe, resetting the repository is not.
+/// Looking up strings does not lock, so it does not serialise concurrent users.
 class YulStringRepository
 {
 public:
@@ -55,17 +61,25 @@ public:
 		if (_string.empty())
 			return { 0, emptyHash() };
 		std::uint64_t h = hash(_string);
+		std::lock_guard<std::mutex> lock(mutex());
 		auto range = m_hashToID.equal_range(h);
 		for (auto it = range.first; it != range.second; ++it)
-			if (*m_strings[it->second] == _string)
+			if (idToString(it->second) == _string)
 				return Handle{it->second, h};
-		m_strings.emplace_back(std::make_shared<std::string>(_string));
-		size_t id = m_strings.size() - 1;
+		size_t id = m_size;
+		newString() = _string;
 		m_hashToID.emplace_hint(range.second, std::make_pair(h, id));
 
 		return Handle{id, h};
 	}
-	std::string const& idToString(size_t _id) const	{ return *m_strings.at(_id); }
+	/// Strings never move once they are added and the string of a handle was added
+	/// before the handle was handed out, so this does not need to lock.
+	std::string const& idToString(size_t _id) const
+	{
+		ChunkTable const& chunks = *m_chunks.load();
+		Chunk const* chunk = chunks.at(_id / c_chunkSize).load();
+		return (*chunk)[_id % c_chunkSize];
+	}
 
 	static std::uint64_t hash(std::string const& v)
 	{
@@ -88,7 +102,32 @@ public:
 	{
 		for (auto const& cb: resetCallbacks())
 			cb();
-		instance() = YulStringRepository{};
+		instance().clear();
+	}
+	/// @returns a marker for the current contents of the repository that can be passed
+	/// to rollback() to discard all strings added after this point.
+	static size_t checkpoint() { return instance().m_size; }
+	/// Removes all strings that were added after @a _checkpoint was taken.
+	/// Strings (and everything referencing them, e.g. cached dialects) that existed at
+	/// the checkpoint stay valid and the reset callbacks are not invoked.
+	/// Use with care - there cannot be any dangling references to the removed strings.
+	static void rollback(size_t _checkpoint)
+	{
+		YulStringRepository& repository = instance();
+		while (repository.m_size > std::max<size_t>(_checkpoint, 1))
+		{
+			size_t id = repository.m_size - 1;
+			std::string& removed = repository.ownedString(id);
+			auto range = repository.m_hashToID.equal_range(hash(removed));
+			for (auto it = range.first; it != range.second; ++it)
+				if (it->second == id)
+				{
+					repository.m_hashToID.erase(it);
+					break;
+				}
+			std::string().swap(removed);
+			--repository.m_size;
+		}
 	}
 	/// Struct that registers a reset callback as a side-effect of its construction.
 	/// Useful as static local variable to register a reset callback once.
@@ -101,20 +140,69 @@ public:
 	};
 
 private:
-	YulStringRepository() = default;
+	static constexpr size_t c_chunkSize = 1024;
+	using Chunk = std::array<std::string, c_chunkSize>;
+	/// Pointers to the chunks of strings. Tables are never resized, a full table
+	/// is replaced by a larger copy.
+	using ChunkTable = std::vector<std::atomic<Chunk*>>;
+
+	YulStringRepository() { clear(); }
 	YulStringRepository(YulStringRepository const&) = delete;
-	YulStringRepository(YulStringRepository&&) = default;
 	YulStringRepository& operator=(YulStringRepository const& _rhs) = delete;
-	YulStringRepository& operator=(YulStringRepository&& _rhs) = default;
 
 	static std::vector<std::function<void()>>& resetCallbacks()
 	{
 		static std::vector<std::function<void()>> callbacks;
 		return callbacks;
 	}
+	static std::mutex& mutex()
+	{
+		static std::mutex m;
+		return m;
+	}
+
+	/// Removes all strings but the empty string.
+	void clear()
+	{
+		m_ownedChunks.clear();
+		m_chunkTables.clear();
+		m_chunks = nullptr;
+		m_size = 0;
+		newString();
+		m_hashToID = {{emptyHash(), 0}};
+	}
+
+	/// @returns a reference to the (empty) string with the next free ID and increments the size.
+	/// Requires the mutex to be held (apart from during clear).
+	std::string& newString()
+	{
+		size_t chunkIndex = m_size / c_chunkSize;
+		if (chunkIndex == m_ownedChunks.size())
+		{
+			m_ownedChunks.emplace_back(new Chunk());
+			if (m_chunkTables.empty() || chunkIndex == m_chunkTables.back()->size())
+			{
+				// Lookups might still use the old table, so it is kept alive.
+				auto table = std::make_unique<ChunkTable>(std::max<size_t>(2 * chunkIndex, 16));
+				for (size_t i = 0; i < chunkIndex; ++i)
+					(*table)[i] = (*m_chunkTables.back())[i].load();
+				m_chunkTables.emplace_back(std::move(table));
+			}
+			(*m_chunkTables.back())[chunkIndex] = m_ownedChunks.back().get();
+			m_chunks = m_chunkTables.back().get();
+		}
+		return ownedString(m_size++);
+	}
+	/// @returns a modifiable reference to the string with ID @a _id.
+	/// Requires the mutex to be held or the repository to not be used concurrently.
+	std::string& ownedString(size_t _id) { return (*m_ownedChunks.at(_id / c_chunkSize))[_id % c_chunkSize]; }
 
-	std::vector<std::shared_ptr<std::string>> m_strings = {std::make_shared<std::string>()};
-	std::unordered_multimap<std::uint64_t, size_t> m_hashToID = {{emptyHash(), 0}};
+	std::vector<std::unique_ptr<Chunk>> m_ownedChunks;
+	std::vector<std::unique_ptr<ChunkTable>> m_chunkTables;
+	/// The most recent chunk table, used for lookups.
+	std::atomic<ChunkTable const*> m_chunks{nullptr};
+	size_t m_size = 0;
+	std::unordered_multimap<std::uint64_t, size_t> m_hashToID;
 };
 
 /// Wrapper around handles into the YulString repository.
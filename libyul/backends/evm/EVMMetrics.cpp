@@ -45,6 +45,11 @@ size_t GasMeter::instructionCosts(eth::Instruction _instruction) const
 	return combineCosts(GasMeterVisitor::instructionCosts(_instruction, m_dialect, m_isCreation));
 }
 
+size_t GasMeter::codeCosts(size_t _bytes) const
+{
+	return _bytes * (m_isCreation ? dev::eth::GasCosts::txDataNonZeroGas : dev::eth::GasCosts::createDataGas);
+}
+
 size_t GasMeter::combineCosts(std::pair<size_t, size_t> _costs) const
 {
 	return _costs.first * m_runs + _costs.second;
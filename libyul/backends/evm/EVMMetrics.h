@@ -50,6 +50,8 @@ public:
 	/// @returns the combined costs of deploying and running the instruction, not including
 	/// the costs for its arguments.
 	size_t instructionCosts(dev::eth::Instruction _instruction) const;
+	/// @returns the costs of deploying @a _bytes bytes of code that are not executed.
+	size_t codeCosts(size_t _bytes) const;
 
 private:
 	size_t combineCosts(std::pair<size_t, size_t> _costs) const;
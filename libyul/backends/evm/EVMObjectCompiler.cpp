@@ -26,12 +26,26 @@
 #include <libyul/Object.h>
 #include <libyul/Exceptions.h>
 
+#include <libdevcore/Parallel.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace dev;
 using namespace yul;
 using namespace std;
 
-void EVMObjectCompiler::compile(Object& _object, AbstractAssembly& _assembly, EVMDialect const& _dialect, bool _evm15, bool _optimize)
+void EVMObjectCompiler::compile(
+	Object& _object,
+	AbstractAssembly& _assembly,
+	EVMDialect const& _dialect,
+	bool _evm15,
+	bool _optimize,
+	size_t _threads
+)
 {
-	EVMObjectCompiler compiler(_assembly, _dialect, _evm15);
+	EVMObjectCompiler compiler(_assembly, _dialect, _evm15, _threads);
 	compiler.run(_object, _optimize);
 }
 
@@ -40,18 +54,24 @@ void EVMObjectCompiler::run(Object& _object, bool _optimize)
 	BuiltinContext context;
 	context.currentObject = &_object;
 
+	// Sub-assemblies are created in order, so their IDs do not depend on the number of threads.
+	vector<pair<Object*, shared_ptr<AbstractAssembly>>> subAssemblies;
 	for (auto& subNode: _object.subObjects)
 		if (Object* subObject = dynamic_cast<Object*>(subNode.get()))
 		{
 			auto subAssemblyAndID = m_assembly.createSubAssembly();
 			context.subIDs[subObject->name] = subAssemblyAndID.second;
-			compile(*subObject, *subAssemblyAndID.first, m_dialect, m_evm15, _optimize);
+			subAssemblies.emplace_back(subObject, subAssemblyAndID.first);
 		}
 		else
 		{
 			Data const& data = dynamic_cast<Data const&>(*subNode);
 			context.subIDs[data.name] = m_assembly.appendData(data.data);
 		}
+	size_t threadsPerSubObject = subAssemblies.size() > 1 ? 1 : m_threads;
+	parallelFor(subAssemblies.size(), m_threads, [&](size_t _index) {
+		compile(*subAssemblies[_index].first, *subAssemblies[_index].second, m_dialect, m_evm15, _optimize, threadsPerSubObject);
+	});
 
 	yulAssert(_object.analysisInfo, "No analysis info.");
 	yulAssert(_object.code, "No code.");
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace yul
 {
 struct Object;
@@ -29,10 +31,20 @@ struct EVMDialect;
 class EVMObjectCompiler
 {
 public:
-	static void compile(Object& _object, AbstractAssembly& _assembly, EVMDialect const& _dialect, bool _evm15, bool _optimize);
+	/// Compiles @a _object and its sub-objects. Sub-objects are compiled into their own
+	/// sub-assemblies, using up to @a _threads threads. The result does not depend on the
+	/// number of threads.
+	static void compile(
+		Object& _object,
+		AbstractAssembly& _assembly,
+		EVMDialect const& _dialect,
+		bool _evm15,
+		bool _optimize,
+		size_t _threads = 1
+	);
 private:
-	EVMObjectCompiler(AbstractAssembly& _assembly, EVMDialect const& _dialect, bool _evm15):
-		m_assembly(_assembly), m_dialect(_dialect), m_evm15(_evm15)
+	EVMObjectCompiler(AbstractAssembly& _assembly, EVMDialect const& _dialect, bool _evm15, size_t _threads):
+		m_assembly(_assembly), m_dialect(_dialect), m_evm15(_evm15), m_threads(_threads)
 	{}
 
 	void run(Object& _object, bool _optimize);
@@ -40,6 +52,7 @@ private:
 	AbstractAssembly& m_assembly;
 	EVMDialect const& m_dialect;
 	bool m_evm15 = false;
+	size_t m_threads = 1;
 };
 
 }
@@ -27,6 +27,7 @@
 #include <libyul/optimiser/MainFunction.h>
 #include <libyul/optimiser/FunctionHoister.h>
 #include <libyul/optimiser/Disambiguator.h>
+#include <libyul/optimiser/NameCollector.h>
 #include <libyul/optimiser/NameDisplacer.h>
 
 #include <libyul/AsmParser.h>
@@ -310,12 +311,65 @@ function invalid() {
 }
 })"};
 
+/// The parsed and analysed polyfill, shared by all translations.
+struct Polyfill
+{
+	shared_ptr<Block> code;
+	/// Polyfill functions called (directly) by each polyfill function.
+	map<YulString, set<YulString>> callees;
+};
+
+unique_ptr<Polyfill const> parsePolyfill()
+{
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	shared_ptr<Scanner> scanner{make_shared<Scanner>(CharStream(polyfill, ""))};
+	auto ret = make_unique<Polyfill>();
+	ret->code = Parser(errorReporter, WasmDialect::instance()).parse(scanner, false);
+	if (ret->code)
+	{
+		AsmAnalysisInfo analysisInfo;
+		AsmAnalyzer(analysisInfo, errorReporter, boost::none, WasmDialect::instance()).analyze(*ret->code);
+	}
+	if (!errors.empty())
+	{
+		string message;
+		for (auto const& err: errors)
+			message += langutil::SourceReferenceFormatter::formatErrorInformation(*err);
+		yulAssert(false, message);
+	}
+
+	for (auto const& statement: ret->code->statements)
+		ret->callees[boost::get<FunctionDefinition>(statement).name];
+	for (auto const& statement: ret->code->statements)
+	{
+		FunctionDefinition const& function = boost::get<FunctionDefinition>(statement);
+		for (auto const& reference: ReferencesCounter::countReferences(function.body))
+			if (ret->callees.count(reference.first))
+				ret->callees[function.name].insert(reference.first);
+	}
+	return ret;
+}
+
+/// @returns the polyfill, which is parsed only once per process (or until
+/// the YulStringRepository is reset).
+Polyfill const& sharedPolyfill()
+{
+	static unique_ptr<Polyfill const> instance;
+	static YulStringRepository::ResetCallback callback{[&] { instance.reset(); }};
+	if (!instance)
+		instance = parsePolyfill();
+	return *instance;
+}
+
 }
 
 Object EVMToEWasmTranslator::run(Object const& _object)
 {
-	if (!m_polyfill)
-		parsePolyfill();
+	Polyfill const& library = sharedPolyfill();
+	set<YulString> polyfillFunctions;
+	for (auto const& function: library.callees)
+		polyfillFunctions.insert(function.first);
 
 	Block ast = boost::get<Block>(Disambiguator(m_dialect, *_object.analysisInfo)(*_object.code));
 	NameDispenser nameDispenser{m_dialect, ast};
@@ -325,11 +379,27 @@ Object EVMToEWasmTranslator::run(Object const& _object)
 	ExpressionSplitter{m_dialect, nameDispenser}(ast);
 	WordSizeTransform::run(m_dialect, ast, nameDispenser);
 
-	NameDisplacer{nameDispenser, m_polyfillFunctions}(ast);
-	for (auto const& st: m_polyfill->statements)
-		ast.statements.emplace_back(ASTCopier{}.translate(st));
+	NameDisplacer{nameDispenser, polyfillFunctions}(ast);
+
+	// Only include the polyfill functions that are (transitively) called.
+	set<YulString> usedFunctions;
+	vector<YulString> toVisit;
+	for (auto const& reference: ReferencesCounter::countReferences(ast))
+		if (polyfillFunctions.count(reference.first))
+			toVisit.emplace_back(reference.first);
+	while (!toVisit.empty())
+	{
+		YulString function = toVisit.back();
+		toVisit.pop_back();
+		if (usedFunctions.insert(function).second)
+			toVisit += library.callees.at(function);
+	}
+	for (auto const& statement: library.code->statements)
+		if (usedFunctions.count(boost::get<FunctionDefinition>(statement).name))
+			ast.statements.emplace_back(ASTCopier{}.translate(statement));
 
 	Object ret;
+	ret.name = _object.name;
 	ret.code = make_shared<Block>(move(ast));
 	ret.analysisInfo = make_shared<AsmAnalysisInfo>();
 
@@ -354,23 +424,3 @@ Object EVMToEWasmTranslator::run(Object const& _object)
 
 	return ret;
 }
-
-void EVMToEWasmTranslator::parsePolyfill()
-{
-	ErrorList errors;
-	ErrorReporter errorReporter(errors);
-	shared_ptr<Scanner> scanner{make_shared<Scanner>(CharStream(polyfill, ""))};
-	m_polyfill = Parser(errorReporter, WasmDialect::instance()).parse(scanner, false);
-	if (!errors.empty())
-	{
-		string message;
-		for (auto const& err: errors)
-			message += langutil::SourceReferenceFormatter::formatErrorInformation(*err);
-		yulAssert(false, message);
-	}
-
-	m_polyfillFunctions.clear();
-	for (auto const& statement: m_polyfill->statements)
-		m_polyfillFunctions.insert(boost::get<FunctionDefinition>(statement).name);
-}
-
@@ -28,6 +28,11 @@ namespace yul
 {
 struct Object;
 
+/**
+ * Translates EVM dialect objects into eWasm dialect objects. The EVM builtins are
+ * implemented by a library of polyfill functions, of which only the ones
+ * (transitively) called by the translated code are included.
+ */
 class EVMToEWasmTranslator: public ASTModifier
 {
 public:
@@ -35,12 +40,7 @@ public:
 	Object run(Object const& _object);
 
 private:
-	void parsePolyfill();
-
 	Dialect const& m_dialect;
-
-	std::shared_ptr<Block> m_polyfill;
-	std::set<YulString> m_polyfillFunctions;
 };
 
 }
@@ -21,6 +21,8 @@
 #pragma once
 
 #include <boost/variant.hpp>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -80,6 +82,16 @@ struct FunctionDefinition
 	std::vector<Expression> body;
 };
 
+/**
+ * Abstract representation of a wasm module.
+ */
+struct Module
+{
+	std::vector<GlobalVariableDeclaration> globals;
+	std::vector<FunctionDefinition> functions;
+	/// Modules of the sub-objects, referenced by datasize and dataoffset.
+	std::map<std::string, Module> subModules;
+};
 
 }
 }
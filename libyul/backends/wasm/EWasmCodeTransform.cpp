@@ -20,7 +20,6 @@
 
 #include <libyul/backends/wasm/EWasmCodeTransform.h>
 
-#include <libyul/backends/wasm/EWasmToText.h>
 #include <libyul/optimiser/NameCollector.h>
 
 #include <libyul/AsmData.h>
@@ -37,10 +36,28 @@ using namespace std;
 using namespace dev;
 using namespace yul;
 
-string EWasmCodeTransform::run(Dialect const& _dialect, yul::Block const& _ast)
+namespace
+{
+
+/// @returns true if the builtin @a _name produces an i32 in wasm.
+bool isComparison(string const& _name)
+{
+	return
+		_name == "i64.eqz" ||
+		_name == "i64.eq" ||
+		_name == "i64.ne" ||
+		_name == "i64.lt_u" ||
+		_name == "i64.gt_u" ||
+		_name == "i64.le_u" ||
+		_name == "i64.ge_u";
+}
+
+}
+
+wasm::Module EWasmCodeTransform::run(Dialect const& _dialect, yul::Block const& _ast)
 {
 	EWasmCodeTransform transform(_dialect, _ast);
-	vector<wasm::FunctionDefinition> functions;
+	wasm::Module module;
 
 	for (auto const& statement: _ast.statements)
 	{
@@ -49,10 +66,11 @@ string EWasmCodeTransform::run(Dialect const& _dialect, yul::Block const& _ast)
 			"Expected only function definitions at the highest level."
 		);
 		if (statement.type() == typeid(yul::FunctionDefinition))
-			functions.emplace_back(transform.translateFunction(boost::get<yul::FunctionDefinition>(statement)));
+			module.functions.emplace_back(transform.translateFunction(boost::get<yul::FunctionDefinition>(statement)));
 	}
+	module.globals = move(transform.m_globalVariables);
 
-	return EWasmToText{}.run(transform.m_globalVariables, functions);
+	return module;
 }
 
 wasm::Expression EWasmCodeTransform::generateMultiAssignment(
@@ -135,8 +153,17 @@ wasm::Expression EWasmCodeTransform::operator()(FunctionCall const& _call)
 				literals.emplace_back(wasm::StringLiteral{boost::get<Literal>(arg).value.str()});
 			return wasm::BuiltinCall{_call.functionName.name.str(), std::move(literals)};
 		}
-		else
-			return wasm::BuiltinCall{_call.functionName.name.str(), visit(_call.arguments)};
+		string name = _call.functionName.name.str();
+		wasm::BuiltinCall call{name, visit(_call.arguments)};
+		// All values are i64 in Yul, so convert from and to the i32 that wasm uses
+		// for memory addresses and the results of comparisons.
+		if (name == "i64.load" || name == "i64.store")
+			call.arguments.front() = wasm::BuiltinCall{"i32.wrap_i64", make_vector<wasm::Expression>(
+				std::move(call.arguments.front())
+			)};
+		if (isComparison(name))
+			return wasm::BuiltinCall{"i64.extend_i32_u", make_vector<wasm::Expression>(std::move(call))};
+		return { std::move(call) };
 	}
 	else
 		// If this function returns multiple values, then the first one will
@@ -166,7 +193,11 @@ wasm::Expression EWasmCodeTransform::operator()(yul::Instruction const&)
 
 wasm::Expression EWasmCodeTransform::operator()(If const& _if)
 {
-	return wasm::If{visit(*_if.condition), visit(_if.body.statements), {}};
+	return wasm::If{
+		make_unique<wasm::Expression>(visitCondition(*_if.condition)),
+		visit(_if.body.statements),
+		{}
+	};
 }
 
 wasm::Expression EWasmCodeTransform::operator()(Switch const& _switch)
@@ -222,17 +253,20 @@ wasm::Expression EWasmCodeTransform::operator()(ForLoop const& _for)
 	m_breakContinueLabelNames.push({breakLabel, continueLabel});
 
 	wasm::Loop loop;
-	loop.statements = visit(_for.pre.statements);
+	loop.labelName = newLabel();
 	loop.statements.emplace_back(wasm::BuiltinCall{"br_if", make_vector<wasm::Expression>(
 		wasm::Label{breakLabel},
-		wasm::BuiltinCall{"i64.eqz", make_vector<wasm::Expression>(
-			visitReturnByValue(*_for.condition)
-		)}
+		visitCondition(*_for.condition, true)
 	)});
 	loop.statements.emplace_back(wasm::Block{continueLabel, visit(_for.body.statements)});
 	loop.statements += visit(_for.post.statements);
+	// Branching to a loop jumps to its start.
+	loop.statements.emplace_back(wasm::Continue{wasm::Label{loop.labelName}});
 
-	return { wasm::Block{breakLabel, make_vector<wasm::Expression>(move(loop))} };
+	// The pre block is only executed once, so it precedes the loop.
+	vector<wasm::Expression> statements = visit(_for.pre.statements);
+	statements.emplace_back(std::move(loop));
+	return { wasm::Block{breakLabel, std::move(statements)} };
 }
 
 wasm::Expression EWasmCodeTransform::operator()(Break const&)
@@ -260,6 +294,27 @@ wasm::Expression EWasmCodeTransform::visitReturnByValue(yul::Expression const& _
 	return boost::apply_visitor(*this, _expression);
 }
 
+wasm::Expression EWasmCodeTransform::visitCondition(yul::Expression const& _expression, bool _negated)
+{
+	wasm::Expression condition = visitReturnByValue(_expression);
+	if (condition.type() == typeid(wasm::BuiltinCall))
+	{
+		wasm::BuiltinCall& builtinCall = boost::get<wasm::BuiltinCall>(condition);
+		// Use the i32 result of comparisons directly.
+		if (builtinCall.functionName == "i64.extend_i32_u")
+		{
+			wasm::Expression comparison = std::move(builtinCall.arguments.front());
+			if (!_negated)
+				return comparison;
+			return wasm::BuiltinCall{"i32.eqz", make_vector<wasm::Expression>(std::move(comparison))};
+		}
+	}
+	wasm::BuiltinCall isZero{"i64.eqz", make_vector<wasm::Expression>(std::move(condition))};
+	if (_negated)
+		return { std::move(isZero) };
+	return wasm::BuiltinCall{"i32.eqz", make_vector<wasm::Expression>(std::move(isZero))};
+}
+
 vector<wasm::Expression> EWasmCodeTransform::visit(vector<yul::Expression> const& _expressions)
 {
 	vector<wasm::Expression> ret;
@@ -34,7 +34,7 @@ struct AsmAnalysisInfo;
 class EWasmCodeTransform: public boost::static_visitor<wasm::Expression>
 {
 public:
-	static std::string run(Dialect const& _dialect, yul::Block const& _ast);
+	static wasm::Module run(Dialect const& _dialect, yul::Block const& _ast);
 
 public:
 	wasm::Expression operator()(yul::Instruction const& _instruction);
@@ -66,6 +66,9 @@ private:
 
 	std::unique_ptr<wasm::Expression> visit(yul::Expression const& _expression);
 	wasm::Expression visitReturnByValue(yul::Expression const& _expression);
+	/// @returns an i32 expression that is non-zero if and only if @a _expression is non-zero,
+	/// or zero if @a _negated is true.
+	wasm::Expression visitCondition(yul::Expression const& _expression, bool _negated = false);
 	std::vector<wasm::Expression> visit(std::vector<yul::Expression> const& _expressions);
 	wasm::Expression visit(yul::Statement const& _statement);
 	std::vector<wasm::Expression> visit(std::vector<yul::Statement> const& _statements);
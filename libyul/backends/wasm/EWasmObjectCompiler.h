@@ -15,28 +15,36 @@
 	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
 */
 /**
- * Compiler that transforms Yul Objects to EWasm text representation.
+ * Compiler that transforms Yul Objects to EWasm text and binary representation.
  */
 
 #pragma once
 
+#include <libdevcore/Common.h>
+
 #include <string>
+#include <utility>
 
 namespace yul
 {
 struct Object;
 struct Dialect;
+namespace wasm
+{
+struct Module;
+}
 
 class EWasmObjectCompiler
 {
 public:
-	static std::string compile(Object& _object, Dialect const& _dialect);
+	/// @returns the text and the binary representation of @a _object.
+	static std::pair<std::string, dev::bytes> compile(Object& _object, Dialect const& _dialect);
 private:
 	EWasmObjectCompiler(Dialect const& _dialect):
 		m_dialect(_dialect)
 	{}
 
-	std::string run(Object& _object);
+	wasm::Module run(Object& _object);
 
 	Dialect const& m_dialect;
 };
@@ -0,0 +1,415 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Component that transforms internal EWasm representation to binary.
+ */
+
+#include <libyul/backends/wasm/EWasmToBinary.h>
+
+#include <libyul/Exceptions.h>
+
+#include <libdevcore/CommonData.h>
+
+using namespace std;
+using namespace dev;
+using namespace yul;
+
+namespace
+{
+
+enum class Section: uint8_t
+{
+	Custom = 0x00,
+	Type = 0x01,
+	Function = 0x03,
+	Memory = 0x05,
+	Global = 0x06,
+	Export = 0x07,
+	Code = 0x0a
+};
+
+enum class Opcode: uint8_t
+{
+	Block = 0x02,
+	Loop = 0x03,
+	If = 0x04,
+	Else = 0x05,
+	End = 0x0b,
+	Br = 0x0c,
+	BrIf = 0x0d,
+	Call = 0x10,
+	LocalGet = 0x20,
+	LocalSet = 0x21,
+	GlobalGet = 0x23,
+	GlobalSet = 0x24,
+	I64Const = 0x42
+};
+
+uint8_t const functionType = 0x60;
+uint8_t const i64Type = 0x7e;
+uint8_t const emptyBlockType = 0x40;
+uint8_t const exportFunction = 0x00;
+uint8_t const exportMemory = 0x02;
+/// Alignment exponent of i64 memory accesses (the default of the text format).
+uint8_t const i64Alignment = 3;
+
+map<string, uint8_t> const builtinOpcodes{
+	{"unreachable", 0x00},
+	{"nop", 0x01},
+	{"drop", 0x1a},
+	{"i64.load", 0x29},
+	{"i64.store", 0x37},
+	{"i32.eqz", 0x45},
+	{"i64.eqz", 0x50},
+	{"i64.eq", 0x51},
+	{"i64.ne", 0x52},
+	{"i64.lt_u", 0x54},
+	{"i64.gt_u", 0x56},
+	{"i64.le_u", 0x58},
+	{"i64.ge_u", 0x5a},
+	{"i64.add", 0x7c},
+	{"i64.sub", 0x7d},
+	{"i64.mul", 0x7e},
+	{"i64.div_u", 0x80},
+	{"i64.rem_u", 0x82},
+	{"i64.and", 0x83},
+	{"i64.or", 0x84},
+	{"i64.xor", 0x85},
+	{"i64.shl", 0x86},
+	{"i64.shr_u", 0x88},
+	{"i32.wrap_i64", 0xa7},
+	{"i64.extend_i32_u", 0xad}
+};
+
+bytes toBytes(Opcode _opcode)
+{
+	return bytes{uint8_t(_opcode)};
+}
+
+bytes toBytes(Section _section)
+{
+	return bytes{uint8_t(_section)};
+}
+
+bytes lebEncode(uint64_t _value)
+{
+	bytes encoded;
+	do
+	{
+		uint8_t byte = _value & 0x7f;
+		_value >>= 7;
+		if (_value != 0)
+			byte |= 0x80;
+		encoded.push_back(byte);
+	}
+	while (_value != 0);
+	return encoded;
+}
+
+bytes lebEncodeSigned(int64_t _value)
+{
+	bytes encoded;
+	while (true)
+	{
+		uint8_t byte = _value & 0x7f;
+		// Arithmetic shift, keeps the sign.
+		_value = _value >= 0 ? _value >> 7 : ~(~_value >> 7);
+		bool signBit = byte & 0x40;
+		if ((_value == 0 && !signBit) || (_value == -1 && signBit))
+		{
+			encoded.push_back(byte);
+			return encoded;
+		}
+		encoded.push_back(byte | 0x80);
+	}
+}
+
+bytes prefixSize(bytes _data)
+{
+	return lebEncode(_data.size()) + _data;
+}
+
+bytes encodeName(string const& _name)
+{
+	return prefixSize(asBytes(_name));
+}
+
+bytes makeSection(Section _section, bytes _data)
+{
+	return toBytes(_section) + prefixSize(move(_data));
+}
+
+bytes i64Const(uint64_t _value)
+{
+	return toBytes(Opcode::I64Const) + lebEncodeSigned(int64_t(_value));
+}
+
+}
+
+bytes EWasmToBinary::run(wasm::Module const& _module)
+{
+	bytes ret{0x00, 'a', 's', 'm', 0x01, 0x00, 0x00, 0x00};
+
+	// Sub-modules come first, so that their position is known when generating the code.
+	map<string, pair<size_t, size_t>> subModulePositions;
+	for (auto const& subModule: _module.subModules)
+	{
+		bytes name = encodeName(subModule.first);
+		bytes binary = run(subModule.second);
+		bytes contents = name + binary;
+		ret += toBytes(Section::Custom) + lebEncode(contents.size());
+		subModulePositions[subModule.first] = {ret.size() + name.size(), binary.size()};
+		ret += contents;
+	}
+
+	map<string, size_t> globals;
+	for (size_t i = 0; i < _module.globals.size(); ++i)
+		globals[_module.globals[i].variableName] = i;
+
+	map<string, size_t> functions;
+	map<pair<size_t, bool>, size_t> types;
+	bytes typeSection;
+	bytes functionSection;
+	for (size_t i = 0; i < _module.functions.size(); ++i)
+	{
+		wasm::FunctionDefinition const& function = _module.functions[i];
+		yulAssert(!functions.count(function.name), "Duplicate function " + function.name);
+		functions[function.name] = i;
+
+		pair<size_t, bool> signature{function.parameterNames.size(), function.returns};
+		if (!types.count(signature))
+		{
+			typeSection += bytes{functionType} + lebEncode(signature.first) + bytes(signature.first, i64Type);
+			typeSection += signature.second ? bytes{0x01, i64Type} : bytes{0x00};
+			size_t index = types.size();
+			types[signature] = index;
+		}
+		functionSection += lebEncode(types[signature]);
+	}
+	if (!_module.functions.empty())
+	{
+		ret += makeSection(Section::Type, lebEncode(types.size()) + typeSection);
+		ret += makeSection(Section::Function, lebEncode(_module.functions.size()) + functionSection);
+	}
+
+	// One page of memory without maximum.
+	ret += makeSection(Section::Memory, bytes{0x01, 0x00, 0x01});
+
+	if (!_module.globals.empty())
+	{
+		bytes globalSection = lebEncode(_module.globals.size());
+		for (size_t i = 0; i < _module.globals.size(); ++i)
+			globalSection += bytes{i64Type, 0x01} + i64Const(0) + toBytes(Opcode::End);
+		ret += makeSection(Section::Global, move(globalSection));
+	}
+
+	bytes exports = encodeName("memory") + bytes{exportMemory, 0x00};
+	size_t exportCount = 1;
+	if (functions.count("main"))
+	{
+		exports += encodeName("main") + bytes{exportFunction} + lebEncode(functions.at("main"));
+		++exportCount;
+	}
+	ret += makeSection(Section::Export, lebEncode(exportCount) + exports);
+
+	if (!_module.functions.empty())
+	{
+		EWasmToBinary transform(move(globals), move(functions), move(subModulePositions));
+		bytes codeSection = lebEncode(_module.functions.size());
+		for (auto const& function: _module.functions)
+			codeSection += transform.transform(function);
+		ret += makeSection(Section::Code, move(codeSection));
+	}
+
+	return ret;
+}
+
+bytes EWasmToBinary::operator()(wasm::Literal const& _literal)
+{
+	return i64Const(_literal.value);
+}
+
+bytes EWasmToBinary::operator()(wasm::StringLiteral const&)
+{
+	yulAssert(false, "String literals are only allowed as arguments to datasize and dataoffset.");
+	return {};
+}
+
+bytes EWasmToBinary::operator()(wasm::LocalVariable const& _identifier)
+{
+	yulAssert(m_locals.count(_identifier.name), "Unknown local variable " + _identifier.name);
+	return toBytes(Opcode::LocalGet) + lebEncode(m_locals.at(_identifier.name));
+}
+
+bytes EWasmToBinary::operator()(wasm::GlobalVariable const& _identifier)
+{
+	yulAssert(m_globals.count(_identifier.name), "Unknown global variable " + _identifier.name);
+	return toBytes(Opcode::GlobalGet) + lebEncode(m_globals.at(_identifier.name));
+}
+
+bytes EWasmToBinary::operator()(wasm::Label const&)
+{
+	yulAssert(false, "Labels are only allowed as arguments to br_if.");
+	return {};
+}
+
+bytes EWasmToBinary::operator()(wasm::BuiltinCall const& _builtinCall)
+{
+	if (_builtinCall.functionName == "br_if")
+	{
+		yulAssert(_builtinCall.arguments.size() == 2, "");
+		return
+			visit(_builtinCall.arguments.at(1)) +
+			toBytes(Opcode::BrIf) +
+			labelDepth(boost::get<wasm::Label>(_builtinCall.arguments.at(0)).name);
+	}
+	else if (_builtinCall.functionName == "datasize" || _builtinCall.functionName == "dataoffset")
+	{
+		yulAssert(_builtinCall.arguments.size() == 1, "");
+		string const& name = boost::get<wasm::StringLiteral>(_builtinCall.arguments.at(0)).value;
+		yulAssert(m_subModulePositions.count(name), "Unknown sub-object " + name);
+		pair<size_t, size_t> position = m_subModulePositions.at(name);
+		uint64_t value = _builtinCall.functionName == "datasize" ? position.second : position.first;
+		// The result consists of four 64 bit words, most significant first. As for other
+		// functions with multiple return values, the first word is returned directly and
+		// the others are stored in the first three globals.
+		yulAssert(m_globals.size() >= 3, "");
+		return
+			i64Const(0) + toBytes(Opcode::GlobalSet) + lebEncode(0) +
+			i64Const(0) + toBytes(Opcode::GlobalSet) + lebEncode(1) +
+			i64Const(value) + toBytes(Opcode::GlobalSet) + lebEncode(2) +
+			i64Const(0);
+	}
+
+	auto opcode = builtinOpcodes.find(_builtinCall.functionName);
+	yulAssert(opcode != builtinOpcodes.end(), "Unknown builtin " + _builtinCall.functionName);
+	bytes ret = visit(_builtinCall.arguments) + bytes{opcode->second};
+	if (_builtinCall.functionName == "i64.load" || _builtinCall.functionName == "i64.store")
+		// Memory immediate: alignment and offset.
+		ret += bytes{i64Alignment, 0x00};
+	return ret;
+}
+
+bytes EWasmToBinary::operator()(wasm::FunctionCall const& _functionCall)
+{
+	yulAssert(m_functions.count(_functionCall.functionName), "Unknown function " + _functionCall.functionName);
+	return
+		visit(_functionCall.arguments) +
+		toBytes(Opcode::Call) +
+		lebEncode(m_functions.at(_functionCall.functionName));
+}
+
+bytes EWasmToBinary::operator()(wasm::LocalAssignment const& _assignment)
+{
+	yulAssert(m_locals.count(_assignment.variableName), "Unknown local variable " + _assignment.variableName);
+	return
+		visit(*_assignment.value) +
+		toBytes(Opcode::LocalSet) +
+		lebEncode(m_locals.at(_assignment.variableName));
+}
+
+bytes EWasmToBinary::operator()(wasm::GlobalAssignment const& _assignment)
+{
+	yulAssert(m_globals.count(_assignment.variableName), "Unknown global variable " + _assignment.variableName);
+	return
+		visit(*_assignment.value) +
+		toBytes(Opcode::GlobalSet) +
+		lebEncode(m_globals.at(_assignment.variableName));
+}
+
+bytes EWasmToBinary::operator()(wasm::If const& _if)
+{
+	bytes ret = visit(*_if.condition) + toBytes(Opcode::If) + bytes{emptyBlockType};
+	m_labels.emplace_back();
+	ret += visit(_if.statements);
+	if (_if.elseStatements)
+		ret += toBytes(Opcode::Else) + visit(*_if.elseStatements);
+	m_labels.pop_back();
+	return ret + toBytes(Opcode::End);
+}
+
+bytes EWasmToBinary::operator()(wasm::Loop const& _loop)
+{
+	return toBytes(Opcode::Loop) + visitNested(_loop.labelName, _loop.statements);
+}
+
+bytes EWasmToBinary::operator()(wasm::Break const& _break)
+{
+	return toBytes(Opcode::Br) + labelDepth(_break.label.name);
+}
+
+bytes EWasmToBinary::operator()(wasm::Continue const& _continue)
+{
+	return toBytes(Opcode::Br) + labelDepth(_continue.label.name);
+}
+
+bytes EWasmToBinary::operator()(wasm::Block const& _block)
+{
+	return toBytes(Opcode::Block) + visitNested(_block.labelName, _block.statements);
+}
+
+bytes EWasmToBinary::transform(wasm::FunctionDefinition const& _function)
+{
+	m_locals.clear();
+	size_t index = 0;
+	for (auto const& param: _function.parameterNames)
+		m_locals[param] = index++;
+	for (auto const& local: _function.locals)
+		m_locals[local.variableName] = index++;
+
+	// All locals are of type i64 and thus declared in a single group.
+	bytes ret;
+	if (_function.locals.empty())
+		ret = lebEncode(0);
+	else
+		ret = lebEncode(1) + lebEncode(_function.locals.size()) + bytes{i64Type};
+
+	yulAssert(m_labels.empty(), "");
+	ret += visit(_function.body) + toBytes(Opcode::End);
+	return prefixSize(move(ret));
+}
+
+bytes EWasmToBinary::visit(wasm::Expression const& _expression)
+{
+	return boost::apply_visitor(*this, _expression);
+}
+
+bytes EWasmToBinary::visit(vector<wasm::Expression> const& _expressions)
+{
+	bytes ret;
+	for (auto const& expression: _expressions)
+		ret += visit(expression);
+	return ret;
+}
+
+bytes EWasmToBinary::visitNested(string const& _label, vector<wasm::Expression> const& _statements)
+{
+	m_labels.emplace_back(_label);
+	bytes ret = bytes{emptyBlockType} + visit(_statements) + toBytes(Opcode::End);
+	m_labels.pop_back();
+	return ret;
+}
+
+bytes EWasmToBinary::labelDepth(string const& _label) const
+{
+	yulAssert(!_label.empty(), "");
+	for (size_t depth = 0; depth < m_labels.size(); ++depth)
+		if (m_labels.at(m_labels.size() - depth - 1) == _label)
+			return lebEncode(depth);
+	yulAssert(false, "Label " + _label + " not found.");
+	return {};
+}
@@ -0,0 +1,96 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Component that transforms internal EWasm representation to binary.
+ */
+
+#pragma once
+
+#include <libyul/backends/wasm/EWasmAST.h>
+
+#include <libdevcore/Common.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace yul
+{
+
+/**
+ * Encodes a wasm module in the binary format.
+ *
+ * Sub-modules are embedded in custom sections (named after the sub-object) that
+ * precede all other sections. ``dataoffset`` and ``datasize`` evaluate to the position
+ * and size of the embedded sub-module inside the binary of the enclosing module.
+ *
+ * The module has to be well-typed, i.e. the conversions between the 64 bit values of
+ * the eWasm dialect and the 32 bit integers of comparisons, conditions and memory
+ * addresses are explicit builtin calls (see EWasmCodeTransform).
+ */
+class EWasmToBinary: public boost::static_visitor<dev::bytes>
+{
+public:
+	static dev::bytes run(wasm::Module const& _module);
+
+	dev::bytes operator()(wasm::Literal const& _literal);
+	dev::bytes operator()(wasm::StringLiteral const& _literal);
+	dev::bytes operator()(wasm::LocalVariable const& _identifier);
+	dev::bytes operator()(wasm::GlobalVariable const& _identifier);
+	dev::bytes operator()(wasm::Label const& _label);
+	dev::bytes operator()(wasm::BuiltinCall const& _builtinCall);
+	dev::bytes operator()(wasm::FunctionCall const& _functionCall);
+	dev::bytes operator()(wasm::LocalAssignment const& _assignment);
+	dev::bytes operator()(wasm::GlobalAssignment const& _assignment);
+	dev::bytes operator()(wasm::If const& _if);
+	dev::bytes operator()(wasm::Loop const& _loop);
+	dev::bytes operator()(wasm::Break const& _break);
+	dev::bytes operator()(wasm::Continue const& _continue);
+	dev::bytes operator()(wasm::Block const& _block);
+
+private:
+	EWasmToBinary(
+		std::map<std::string, size_t> _globals,
+		std::map<std::string, size_t> _functions,
+		std::map<std::string, std::pair<size_t, size_t>> _subModulePositions
+	):
+		m_globals(std::move(_globals)),
+		m_functions(std::move(_functions)),
+		m_subModulePositions(std::move(_subModulePositions))
+	{}
+
+	/// @returns the code section entry (size-prefixed locals and body) of the function.
+	dev::bytes transform(wasm::FunctionDefinition const& _function);
+
+	dev::bytes visit(wasm::Expression const& _expression);
+	dev::bytes visit(std::vector<wasm::Expression> const& _expressions);
+	/// @returns the encoded statements enclosed in a structured instruction with the given label.
+	dev::bytes visitNested(std::string const& _label, std::vector<wasm::Expression> const& _statements);
+
+	/// @returns the relative depth of the innermost structured instruction with the given label.
+	dev::bytes labelDepth(std::string const& _label) const;
+
+	std::map<std::string, size_t> const m_globals;
+	std::map<std::string, size_t> const m_functions;
+	/// Offset and size of the sub-modules inside the binary of the module.
+	std::map<std::string, std::pair<size_t, size_t>> const m_subModulePositions;
+	std::map<std::string, size_t> m_locals;
+	/// Labels of the enclosing structured instructions, innermost last.
+	std::vector<std::string> m_labels;
+};
+
+}
@@ -29,12 +29,13 @@
 using namespace std;
 using namespace yul;
 
-string EWasmToText::run(
-	vector<wasm::GlobalVariableDeclaration> const& _globals,
-	vector<wasm::FunctionDefinition> const& _functions
-)
+string EWasmToText::run(wasm::Module const& _module)
 {
-	string ret = "(module\n";
+	string ret;
+	for (auto const& subModule: _module.subModules)
+		ret += run(subModule.second);
+
+	ret += "(module\n";
 	// TODO Add all the interface functions:
 	// ret += "    (import \"ethereum\" \"getBalance\"  (func $getBalance (param i32 i32)))\n";
 
@@ -43,10 +44,10 @@ string EWasmToText::run(
 	// export the main function
 	ret += "    (export \"main\" (func $main))\n";
 
-	for (auto const& g: _globals)
+	for (auto const& g: _module.globals)
 		ret += "    (global $" + g.variableName + " (mut i64) (i64.const 0))\n";
 	ret += "\n";
-	for (auto const& f: _functions)
+	for (auto const& f: _module.functions)
 		ret += transform(f) + "\n";
 	return move(ret) + ")\n";
 }
@@ -31,10 +31,8 @@ struct AsmAnalysisInfo;
 class EWasmToText: public boost::static_visitor<std::string>
 {
 public:
-	std::string run(
-		std::vector<wasm::GlobalVariableDeclaration> const& _globals,
-		std::vector<wasm::FunctionDefinition> const& _functions
-	);
+	/// @returns the text representation of @a _module, preceded by the ones of its sub-modules.
+	std::string run(wasm::Module const& _module);
 
 public:
 	std::string operator()(wasm::Literal const& _literal);
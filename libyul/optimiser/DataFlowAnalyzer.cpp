@@ -104,12 +104,12 @@ void DataFlowAnalyzer::operator()(VariableDeclaration& _varDecl)
 void DataFlowAnalyzer::operator()(If& _if)
 {
 	clearKnowledgeIfInvalidated(*_if.condition);
-	InvertibleMap<YulString, YulString> storage = m_storage;
-	InvertibleMap<YulString, YulString> memory = m_memory;
+	size_t storageCheckpoint = m_storage.checkpoint();
+	size_t memoryCheckpoint = m_memory.checkpoint();
 
 	ASTModifier::operator()(_if);
 
-	joinKnowledge(storage, memory);
+	joinKnowledge(storageCheckpoint, memoryCheckpoint);
 
 	Assignments assignments;
 	assignments(_if.body);
@@ -123,10 +123,10 @@ void DataFlowAnalyzer::operator()(Switch& _switch)
 	set<YulString> assignedVariables;
 	for (auto& _case: _switch.cases)
 	{
-		InvertibleMap<YulString, YulString> storage = m_storage;
-		InvertibleMap<YulString, YulString> memory = m_memory;
+		size_t storageCheckpoint = m_storage.checkpoint();
+		size_t memoryCheckpoint = m_memory.checkpoint();
 		(*this)(_case.body);
-		joinKnowledge(storage, memory);
+		joinKnowledge(storageCheckpoint, memoryCheckpoint);
 
 		Assignments assignments;
 		assignments(_case.body);
@@ -315,33 +315,14 @@ void DataFlowAnalyzer::clearKnowledgeIfInvalidated(Expression const& _expr)
 		m_memory.clear();
 }
 
-void DataFlowAnalyzer::joinKnowledge(
-	InvertibleMap<YulString, YulString> const& _olderStorage,
-	InvertibleMap<YulString, YulString> const& _olderMemory
-)
+void DataFlowAnalyzer::joinKnowledge(size_t _storageCheckpoint, size_t _memoryCheckpoint)
 {
-	joinKnowledgeHelper(m_storage, _olderStorage);
-	joinKnowledgeHelper(m_memory, _olderMemory);
-}
-
-void DataFlowAnalyzer::joinKnowledgeHelper(
-	InvertibleMap<YulString, YulString>& _this,
-	InvertibleMap<YulString, YulString> const& _older
-)
-{
-	// We clear if the key does not exist in the older map or if the value is different.
-	// This also works for memory because _older is an "older version"
+	// We clear if the key did not exist at the checkpoint or if the value is different.
+	// This also works for memory because the state at the checkpoint is an "older version"
 	// of m_memory and thus any overlapping write would have cleared the keys
 	// that are not known to be different inside m_memory already.
-	set<YulString> keysToErase;
-	for (auto const& item: _this.values)
-	{
-		auto it = _older.values.find(item.first);
-		if (it == _older.values.end() || it->second != item.second)
-			keysToErase.insert(item.first);
-	}
-	for (auto const& key: keysToErase)
-		_this.eraseKey(key);
+	m_storage.joinWithCheckpoint(_storageCheckpoint);
+	m_memory.joinWithCheckpoint(_memoryCheckpoint);
 }
 
 bool DataFlowAnalyzer::inScope(YulString _variableName) const
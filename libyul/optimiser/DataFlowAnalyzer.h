@@ -58,6 +58,8 @@ struct Dialect;
  *
  * For forward-joining control flow, storage/memory information from the branches is combined.
  * If the keys or values are different or non-existent in one branch, the key is deleted.
+ * Instead of copying the knowledge at the start of a branch, only the changes made inside
+ * the branch are recorded (see InvertibleMap::checkpoint) and inspected at the join.
  * This works also for memory (where addresses overlap) because one branch is always an
  * older version of the other and thus overlapping contents would have been deleted already
  * at the point of assignment.
@@ -102,18 +104,11 @@ protected:
 	/// Clears knowledge about storage or memory if they may be modified inside the expression.
 	void clearKnowledgeIfInvalidated(Expression const& _expression);
 
-	/// Joins knowledge about storage and memory with an older point in the control-flow.
-	/// This only works if the current state is a direct successor of the older point,
-	/// i.e. `_otherStorage` and `_otherMemory` cannot have additional changes.
-	void joinKnowledge(
-		InvertibleMap<YulString, YulString> const& _olderStorage,
-		InvertibleMap<YulString, YulString> const& _olderMemory
-	);
-
-	static void joinKnowledgeHelper(
-		InvertibleMap<YulString, YulString>& _thisData,
-		InvertibleMap<YulString, YulString> const& _olderData
-	);
+	/// Joins knowledge about storage and memory with an older point in the control-flow,
+	/// given by checkpoints of m_storage and m_memory taken at that point.
+	/// This only works if the current state is a direct successor of the older point.
+	/// The cost is proportional to the number of changes since the checkpoints.
+	void joinKnowledge(size_t _storageCheckpoint, size_t _memoryCheckpoint);
 
 	/// Returns true iff the variable is in scope.
 	bool inScope(YulString _variableName) const;
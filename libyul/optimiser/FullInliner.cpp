@@ -26,6 +26,7 @@
 #include <libyul/optimiser/OptimizerUtilities.h>
 #include <libyul/optimiser/Metrics.h>
 #include <libyul/optimiser/SSAValueTracker.h>
+#include <libyul/backends/evm/EVMMetrics.h>
 #include <libyul/Exceptions.h>
 #include <libyul/AsmData.h>
 
@@ -38,8 +39,8 @@ using namespace std;
 using namespace dev;
 using namespace yul;
 
-FullInliner::FullInliner(Block& _ast, NameDispenser& _dispenser):
-	m_ast(_ast), m_nameDispenser(_dispenser)
+FullInliner::FullInliner(Block& _ast, NameDispenser& _dispenser, GasMeter const* _meter):
+	m_ast(_ast), m_nameDispenser(_dispenser), m_meter(_meter)
 {
 	// Determine constants
 	SSAValueTracker tracker;
@@ -116,9 +117,35 @@ bool FullInliner::shallInline(FunctionCall const& _funCall, YulString _callSite)
 			break;
 		}
 
+	if (m_meter)
+		return worthInlining(size, constantArg);
 	return (size < 6 || (constantArg && size < 12));
 }
 
+bool FullInliner::worthInlining(size_t _size, bool _constantArgument) const
+{
+	using dev::eth::Instruction;
+	yulAssert(m_meter, "");
+
+	// Call overhead: Pushing the return label and the function tag and jumping
+	// there and back again. Arguments and return variables still have to be moved
+	// into place after inlining, so they do not count as savings.
+	size_t savings =
+		2 * m_meter->instructionCosts(Instruction::PUSH1) +
+		2 * m_meter->instructionCosts(Instruction::JUMP) +
+		2 * m_meter->instructionCosts(Instruction::JUMPDEST);
+	// Constant arguments might provide a means for further optimization, so they cause a bonus.
+	if (_constantArgument)
+		savings *= 2;
+
+	// A unit of code size corresponds to about six bytes of bytecode once the stack
+	// layout is taken into account. For the default of 200 runs, this leads to roughly
+	// the same decisions as the size limits used without a gas meter.
+	size_t costs = m_meter->codeCosts(6 * _size);
+
+	return costs <= savings;
+}
+
 void FullInliner::tentativelyUpdateCodeSize(YulString _function, YulString _callSite)
 {
 	m_functionSizes.at(_callSite) += m_functionSizes.at(_function);
@@ -37,6 +37,7 @@ namespace yul
 {
 
 class NameCollector;
+class GasMeter;
 
 
 /**
@@ -63,13 +64,18 @@ class NameCollector;
  * code of f, with replacements: a -> f_a, b -> f_b, c -> f_c
  * let z := f_c
  *
+ * If a gas meter is provided, calls to functions that are neither tiny nor used only
+ * once are inlined if the estimated savings in runtime gas, weighted by the expected
+ * number of executions, outweigh the costs of deploying the copied body. Otherwise,
+ * only small functions are inlined.
+ *
  * Prerequisites: Disambiguator
  * More efficient if run after: Function Hoister, Expression Splitter
  */
 class FullInliner: public ASTModifier
 {
 public:
-	explicit FullInliner(Block& _ast, NameDispenser& _dispenser);
+	explicit FullInliner(Block& _ast, NameDispenser& _dispenser, GasMeter const* _meter = nullptr);
 
 	void run();
 
@@ -94,6 +100,9 @@ private:
 	void updateCodeSize(FunctionDefinition const& _fun);
 	void handleBlock(YulString _currentFunctionName, Block& _block);
 	bool recursive(FunctionDefinition const& _fun) const;
+	/// @returns true if the gas saved by not calling a function outweighs the costs of deploying
+	/// its body of size @a _size again, where constant arguments double the savings.
+	bool worthInlining(size_t _size, bool _constantArgument) const;
 
 	/// The AST to be modified. The root block itself will not be modified, because
 	/// we store pointers to functions.
@@ -105,6 +114,8 @@ private:
 	std::set<YulString> m_constants;
 	std::map<YulString, size_t> m_functionSizes;
 	NameDispenser& m_nameDispenser;
+	/// Gas meter used to weigh call overhead against code size, can be nullptr.
+	GasMeter const* m_meter = nullptr;
 };
 
 /**
@@ -0,0 +1,145 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimisation stage that moves variable declarations out of for loops.
+ */
+
+#include <libyul/optimiser/LoopInvariantCodeMotion.h>
+
+#include <libyul/optimiser/NameCollector.h>
+#include <libyul/optimiser/Semantics.h>
+#include <libyul/optimiser/SSAValueTracker.h>
+#include <libyul/AsmData.h>
+
+#include <libdevcore/CommonData.h>
+
+using namespace std;
+using namespace dev;
+using namespace yul;
+
+namespace
+{
+
+/// Collects the parameters of all functions.
+class ParameterCollector: public ASTWalker
+{
+public:
+	using ASTWalker::operator();
+	void operator()(FunctionDefinition const& _funDef) override
+	{
+		for (auto const& parameter: _funDef.parameters)
+			m_parameters.insert(parameter.name);
+		ASTWalker::operator()(_funDef);
+	}
+
+	set<YulString> m_parameters;
+};
+
+}
+
+void LoopInvariantCodeMotion::run(Dialect const& _dialect, Block& _ast)
+{
+	SSAValueTracker ssaValues;
+	ssaValues(_ast);
+	set<YulString> ssaVariables;
+	for (auto const& value: ssaValues.values())
+		ssaVariables.insert(value.first);
+
+	// Parameters are not tracked by the SSAValueTracker because their values are unknown,
+	// but they are just as invariant if they are never assigned to.
+	ParameterCollector parameters;
+	parameters(_ast);
+	Assignments assignments;
+	assignments(_ast);
+	for (YulString parameter: parameters.m_parameters)
+		if (!assignments.names().count(parameter))
+			ssaVariables.insert(parameter);
+
+	LoopInvariantCodeMotion{_dialect, std::move(ssaVariables)}(_ast);
+}
+
+void LoopInvariantCodeMotion::operator()(Block& _block)
+{
+	iterateReplacing(
+		_block.statements,
+		[&](Statement& _statement) -> boost::optional<vector<Statement>>
+		{
+			visit(_statement);
+			if (_statement.type() == typeid(ForLoop))
+				return rewriteLoop(boost::get<ForLoop>(_statement));
+			else
+				return {};
+		}
+	);
+}
+
+bool LoopInvariantCodeMotion::canBePromoted(
+	VariableDeclaration const& _varDecl,
+	set<YulString> const& _varsDefinedInCurrentScope
+) const
+{
+	for (auto const& variable: _varDecl.variables)
+		if (!m_ssaVariables.count(variable.name))
+			return false;
+	if (_varDecl.value)
+	{
+		MovableChecker checker{m_dialect, *_varDecl.value};
+		if (!checker.movable())
+			return false;
+		for (YulString reference: checker.referencedVariables())
+			if (_varsDefinedInCurrentScope.count(reference) || !m_ssaVariables.count(reference))
+				return false;
+	}
+	return true;
+}
+
+boost::optional<vector<Statement>> LoopInvariantCodeMotion::rewriteLoop(ForLoop& _for)
+{
+	// Variables declared in the pre block are visible in the loop but are not tracked below.
+	if (!_for.pre.statements.empty())
+		return {};
+
+	vector<Statement> replacement;
+	for (Block* block: {&_for.post, &_for.body})
+	{
+		set<YulString> varsDefinedInScope;
+		iterateReplacing(
+			block->statements,
+			[&](Statement& _statement) -> boost::optional<vector<Statement>>
+			{
+				if (_statement.type() == typeid(VariableDeclaration))
+				{
+					VariableDeclaration const& varDecl = boost::get<VariableDeclaration>(_statement);
+					if (canBePromoted(varDecl, varsDefinedInScope))
+					{
+						// The variables are not added to varsDefinedInScope because they
+						// are moved in front of the loop as well.
+						replacement.emplace_back(std::move(_statement));
+						return vector<Statement>{};
+					}
+					for (auto const& variable: varDecl.variables)
+						varsDefinedInScope.insert(variable.name);
+				}
+				return {};
+			}
+		);
+	}
+	if (replacement.empty())
+		return {};
+	replacement.emplace_back(std::move(_for));
+	return {std::move(replacement)};
+}
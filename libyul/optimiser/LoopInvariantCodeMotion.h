@@ -0,0 +1,74 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimisation stage that moves variable declarations out of for loops.
+ */
+
+#pragma once
+
+#include <libyul/optimiser/ASTWalker.h>
+
+#include <boost/optional.hpp>
+
+#include <set>
+
+namespace yul
+{
+struct Dialect;
+
+/**
+ * Loop-invariant code motion.
+ *
+ * Moves the declaration of a variable that is never re-assigned from the body or the
+ * post block of a for loop in front of the loop, if its value is movable and only
+ * references variables that are never re-assigned and declared outside of the loop.
+ *
+ * Only statements at the top level of the body or post block are considered, i.e. variable
+ * declarations inside conditional branches are not moved out of the loop.
+ *
+ * Prerequisites: Disambiguator, ForLoopInitRewriter.
+ * The ExpressionSplitter and the SSATransform should be run upfront to obtain better results.
+ */
+class LoopInvariantCodeMotion: public ASTModifier
+{
+public:
+	static void run(Dialect const& _dialect, Block& _ast);
+
+	using ASTModifier::operator();
+	void operator()(Block& _block) override;
+
+private:
+	LoopInvariantCodeMotion(Dialect const& _dialect, std::set<YulString> _ssaVariables):
+		m_dialect(_dialect),
+		m_ssaVariables(std::move(_ssaVariables))
+	{}
+
+	/// @returns true if the declaration can be moved in front of the enclosing loop, given
+	/// the variables declared before it in the same block of the loop.
+	bool canBePromoted(
+		VariableDeclaration const& _varDecl,
+		std::set<YulString> const& _varsDefinedInCurrentScope
+	) const;
+	/// @returns the statements to replace the loop with, if any declarations were moved.
+	boost::optional<std::vector<Statement>> rewriteLoop(ForLoop& _for);
+
+	Dialect const& m_dialect;
+	/// Variables that are never re-assigned.
+	std::set<YulString> const m_ssaVariables;
+};
+
+}
@@ -52,8 +52,12 @@ void RedundantAssignEliminator::operator()(Assignment const& _assignment)
 		changeUndecidedTo(var.name, State::Unused);
 
 	if (_assignment.variableNames.size() == 1)
-		// Default-construct it in "Undecided" state if it does not yet exist.
-		m_assignments[_assignment.variableNames.front().name][&_assignment];
+	{
+		// Add it in "Undecided" state if it is not yet tracked.
+		size_t number = m_numbering.numbers.at(&_assignment);
+		if (!m_assignments.unused[number] && !m_assignments.used[number])
+			m_assignments.undecided.set(number);
+	}
 }
 
 void RedundantAssignEliminator::operator()(If const& _if)
@@ -63,7 +67,7 @@ void RedundantAssignEliminator::operator()(If const& _if)
 	TrackedAssignments skipBranch{m_assignments};
 	(*this)(_if.body);
 
-	merge(m_assignments, move(skipBranch));
+	merge(m_assignments, skipBranch);
 }
 
 void RedundantAssignEliminator::operator()(Switch const& _switch)
@@ -88,19 +92,21 @@ void RedundantAssignEliminator::operator()(Switch const& _switch)
 		m_assignments = move(branches.back());
 		branches.pop_back();
 	}
-	for (auto& branch: branches)
-		merge(m_assignments, move(branch));
+	merge(m_assignments, move(branches));
 }
 
 void RedundantAssignEliminator::operator()(FunctionDefinition const& _functionDefinition)
 {
 	std::set<YulString> outerDeclaredVariables;
+	AssignmentNumbering outerNumbering;
 	TrackedAssignments outerAssignments;
 	ForLoopInfo forLoopInfo;
 	swap(m_declaredVariables, outerDeclaredVariables);
+	swap(m_numbering, outerNumbering);
 	swap(m_assignments, outerAssignments);
 	swap(m_forLoopInfo, forLoopInfo);
 
+	startFunction(_functionDefinition.body);
 	(*this)(_functionDefinition.body);
 
 	for (auto const& param: _functionDefinition.parameters)
@@ -109,6 +115,7 @@ void RedundantAssignEliminator::operator()(FunctionDefinition const& _functionDe
 		finalize(retParam.name, State::Used);
 
 	swap(m_declaredVariables, outerDeclaredVariables);
+	swap(m_numbering, outerNumbering);
 	swap(m_assignments, outerAssignments);
 	swap(m_forLoopInfo, forLoopInfo);
 }
@@ -150,7 +157,7 @@ void RedundantAssignEliminator::operator()(ForLoop const& _forLoop)
 
 		visit(*_forLoop.condition);
 		// Order of merging does not matter because "max" is commutative and associative.
-		merge(m_assignments, move(oneRun));
+		merge(m_assignments, oneRun);
 	}
 	else
 	{
@@ -158,19 +165,14 @@ void RedundantAssignEliminator::operator()(ForLoop const& _forLoop)
 		// Change all assignments that were newly introduced in the for loop to "used".
 		// We do not have to do that with the "break" or "continue" paths, because
 		// they will be joined later anyway.
-		// TODO parallel traversal might be more efficient here.
-		for (auto& var: m_assignments)
-			for (auto& assignment: var.second)
-			{
-				auto zeroIt = zeroRuns.find(var.first);
-				if (zeroIt != zeroRuns.end() && zeroIt->second.count(assignment.first))
-					continue;
-				assignment.second = State::Value::Used;
-			}
+		boost::dynamic_bitset<> newAssignments = m_assignments.tracked() - zeroRuns.tracked();
+		m_assignments.unused -= newAssignments;
+		m_assignments.undecided -= newAssignments;
+		m_assignments.used |= newAssignments;
 	}
 
 	// Order of merging does not matter because "max" is commutative and associative.
-	merge(m_assignments, move(zeroRuns));
+	merge(m_assignments, zeroRuns);
 	merge(m_assignments, move(m_forLoopInfo.pendingBreakStmts));
 	m_forLoopInfo.pendingBreakStmts.clear();
 
@@ -182,13 +184,13 @@ void RedundantAssignEliminator::operator()(ForLoop const& _forLoop)
 void RedundantAssignEliminator::operator()(Break const&)
 {
 	m_forLoopInfo.pendingBreakStmts.emplace_back(move(m_assignments));
-	m_assignments.clear();
+	m_assignments = TrackedAssignments(m_numbering.assignments.size());
 }
 
 void RedundantAssignEliminator::operator()(Continue const&)
 {
 	m_forLoopInfo.pendingContinueStmts.emplace_back(move(m_assignments));
-	m_assignments.clear();
+	m_assignments = TrackedAssignments(m_numbering.assignments.size());
 }
 
 void RedundantAssignEliminator::operator()(Block const& _block)
@@ -207,62 +209,105 @@ void RedundantAssignEliminator::operator()(Block const& _block)
 void RedundantAssignEliminator::run(Dialect const& _dialect, Block& _ast)
 {
 	RedundantAssignEliminator rae{_dialect};
+	rae.startFunction(_ast);
 	rae(_ast);
 
 	AssignmentRemover remover{rae.m_pendingRemovals};
 	remover(_ast);
 }
 
-template <class K, class V, class F>
-void joinMap(std::map<K, V>& _a, std::map<K, V>&& _b, F _conflictSolver)
+boost::dynamic_bitset<>& RedundantAssignEliminator::TrackedAssignments::operator[](State _state)
 {
-	// TODO Perhaps it is better to just create a sorted list
-	// and then use insert(begin, end)
-
-	auto ita = _a.begin();
-	auto aend = _a.end();
-	auto itb = _b.begin();
-	auto bend = _b.end();
-
-	for (; itb != bend; ++ita)
+	switch (_state)
 	{
-		if (ita == aend)
-			ita = _a.insert(ita, std::move(*itb++));
-		else if (ita->first < itb->first)
-			continue;
-		else if (itb->first < ita->first)
-			ita = _a.insert(ita, std::move(*itb++));
-		else
-		{
-			_conflictSolver(ita->second, std::move(itb->second));
-			++itb;
-		}
+	case State::Unused:
+		return unused;
+	case State::Undecided:
+		return undecided;
+	case State::Used:
+		break;
 	}
+	return used;
 }
 
-void RedundantAssignEliminator::merge(TrackedAssignments& _target, TrackedAssignments&& _other)
+void RedundantAssignEliminator::TrackedAssignments::untrack(size_t _number)
 {
-	joinMap(_target, move(_other), [](
-		map<Assignment const*, State>& _assignmentHere,
-		map<Assignment const*, State>&& _assignmentThere
-	)
-	{
-		return joinMap(_assignmentHere, move(_assignmentThere), State::join);
-	});
+	unused.reset(_number);
+	undecided.reset(_number);
+	used.reset(_number);
+}
+
+void RedundantAssignEliminator::TrackedAssignments::join(TrackedAssignments const& _other)
+{
+	// Statements that are only tracked on one side keep their state,
+	// conflicts are resolved towards "used", then "undecided".
+	used |= _other.used;
+	undecided |= _other.undecided;
+	undecided -= used;
+	unused |= _other.unused;
+	unused -= used;
+	unused -= undecided;
+}
+
+void RedundantAssignEliminator::merge(TrackedAssignments& _target, TrackedAssignments const& _other)
+{
+	_target.join(_other);
 }
 
 void RedundantAssignEliminator::merge(TrackedAssignments& _target, vector<TrackedAssignments>&& _source)
 {
-	for (TrackedAssignments& ts: _source)
-		merge(_target, move(ts));
+	for (TrackedAssignments const& ts: _source)
+		merge(_target, ts);
 	_source.clear();
 }
 
+namespace
+{
+/**
+ * Collects all assignments to single variables inside a block,
+ * but not inside nested function definitions.
+ */
+class AssignmentCollector: public ASTWalker
+{
+public:
+	using ASTWalker::operator();
+	void operator()(Assignment const& _assignment) override
+	{
+		if (_assignment.variableNames.size() == 1)
+			assignments.push_back(&_assignment);
+	}
+	void operator()(FunctionDefinition const&) override {}
+
+	vector<Assignment const*> assignments;
+};
+}
+
+void RedundantAssignEliminator::startFunction(Block const& _block)
+{
+	AssignmentCollector collector;
+	collector(_block);
+	m_numbering = AssignmentNumbering{};
+	m_numbering.assignments = move(collector.assignments);
+	for (size_t i = 0; i < m_numbering.assignments.size(); ++i)
+	{
+		Assignment const* assignment = m_numbering.assignments[i];
+		m_numbering.numbers[assignment] = i;
+		m_numbering.assignmentsTo[assignment->variableNames.front().name].push_back(i);
+	}
+	m_assignments = TrackedAssignments(m_numbering.assignments.size());
+}
+
 void RedundantAssignEliminator::changeUndecidedTo(YulString _variable, RedundantAssignEliminator::State _newState)
 {
-	for (auto& assignment: m_assignments[_variable])
-		if (assignment.second == State::Undecided)
-			assignment.second = _newState;
+	auto it = m_numbering.assignmentsTo.find(_variable);
+	if (it == m_numbering.assignmentsTo.end())
+		return;
+	for (size_t number: it->second)
+		if (m_assignments.undecided[number])
+		{
+			m_assignments.undecided.reset(number);
+			m_assignments[_newState].set(number);
+		}
 }
 
 void RedundantAssignEliminator::finalize(YulString _variable, RedundantAssignEliminator::State _finalState)
@@ -280,16 +325,20 @@ void RedundantAssignEliminator::finalize(
 	RedundantAssignEliminator::State _finalState
 )
 {
-	for (auto const& assignment: _assignments[_variable])
+	auto it = m_numbering.assignmentsTo.find(_variable);
+	if (it == m_numbering.assignmentsTo.end())
+		return;
+	for (size_t number: it->second)
 	{
-		State const state = assignment.second == State::Undecided ? _finalState : assignment.second;
+		bool unused = _assignments.unused[number] || (_assignments.undecided[number] && _finalState == State::Unused);
+		_assignments.untrack(number);
 
-		if (state == State::Unused && SideEffectsCollector{*m_dialect, *assignment.first->value}.movable())
+		Assignment const& assignment = *m_numbering.assignments[number];
+		if (unused && SideEffectsCollector{*m_dialect, *assignment.value}.movable())
 			// TODO the only point where we actually need this
 			// to be a set is for the for loop
-			m_pendingRemovals.insert(assignment.first);
+			m_pendingRemovals.insert(&assignment);
 	}
-	_assignments.erase(_variable);
 }
 
 void AssignmentRemover::operator()(Block& _block)
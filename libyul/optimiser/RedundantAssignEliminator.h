@@ -24,6 +24,8 @@
 #include <libyul/AsmDataForward.h>
 #include <libyul/optimiser/ASTWalker.h>
 
+#include <boost/dynamic_bitset.hpp>
+
 #include <map>
 #include <vector>
 
@@ -68,7 +70,10 @@ struct Dialect;
  * When a variable is referenced, the state of any assignment to that variable still
  * in the "undecided" state is changed to "used".
  * At points where control flow splits, a copy
- * of the mapping is handed over to each branch. At points where control flow
+ * of the mapping is handed over to each branch.
+ * The assignments inside a function are numbered densely, so the mapping is stored
+ * as one bit set per state and copies and joins take linear time in the number of
+ * assignments of the function. At points where control flow
  * joins, the two mappings coming from the two branches are combined in the following way:
  * Statements that are only in one mapping or have the same state are used unchanged.
  * Conflicting values are resolved in the following way:
@@ -126,31 +131,44 @@ public:
 	static void run(Dialect const& _dialect, Block& _ast);
 
 private:
-	class State
+	enum class State { Unused, Undecided, Used };
+
+	/// Dense numbering of the tracked assignments (assignments to a single variable)
+	/// of the function currently being analyzed, excluding nested functions.
+	struct AssignmentNumbering
 	{
-	public:
-		enum Value { Unused, Undecided, Used };
-		State(Value _value = Undecided): m_value(_value) {}
-		inline bool operator==(State _other) const { return m_value == _other.m_value; }
-		inline bool operator!=(State _other) const { return !operator==(_other); }
-		static inline void join(State& _a, State const& _b)
-		{
-			// Using "max" works here because of the order of the values in the enum.
-			_a.m_value =  Value(std::max(int(_a.m_value), int(_b.m_value)));
-		}
-	private:
-		Value m_value = Undecided;
+		std::vector<Assignment const*> assignments;
+		std::map<Assignment const*, size_t> numbers;
+		/// Numbers of the tracked assignments to each variable.
+		std::map<YulString, std::vector<size_t>> assignmentsTo;
 	};
 
-	// TODO check that this does not cause nondeterminism!
-	// This could also be a pseudo-map from state to assignment.
-	using TrackedAssignments = std::map<YulString, std::map<Assignment const*, State>>;
+	/// States of the tracked assignments, indexed by their number.
+	/// Each tracked assignment is contained in exactly one of the three sets,
+	/// the other assignments are not contained in any.
+	struct TrackedAssignments
+	{
+		explicit TrackedAssignments(size_t _size = 0): unused(_size), undecided(_size), used(_size) {}
+
+		boost::dynamic_bitset<>& operator[](State _state);
+		boost::dynamic_bitset<> tracked() const { return unused | undecided | used; }
+		void untrack(size_t _number);
+		/// Joins with @a _other according to the rules laid out above,
+		/// which corresponds to taking the maximum of the states.
+		void join(TrackedAssignments const& _other);
+
+		boost::dynamic_bitset<> unused;
+		boost::dynamic_bitset<> undecided;
+		boost::dynamic_bitset<> used;
+	};
 
-	/// Joins the assignment mapping of @a _source into @a _target according to the rules laid out
-	/// above.
-	/// Will destroy @a _source.
-	static void merge(TrackedAssignments& _target, TrackedAssignments&& _source);
+	/// Joins the assignment states of @a _source into @a _target according to the rules laid
+	/// out above.
+	static void merge(TrackedAssignments& _target, TrackedAssignments const& _source);
 	static void merge(TrackedAssignments& _target, std::vector<TrackedAssignments>&& _source);
+	/// Numbers the assignments in @a _block (excluding nested functions) and resets the
+	/// current assignment states.
+	void startFunction(Block const& _block);
 	void changeUndecidedTo(YulString _variable, State _newState);
 	/// Called when a variable goes out of scope. Sets the state of all still undecided
 	/// assignments to the final state. In this case, this also applies to pending
@@ -162,6 +180,7 @@ private:
 	Dialect const* m_dialect;
 	std::set<YulString> m_declaredVariables;
 	std::set<Assignment const*> m_pendingRemovals;
+	AssignmentNumbering m_numbering;
 	TrackedAssignments m_assignments;
 
 	/// Working data for traversing for-loops.
@@ -66,6 +66,35 @@ Rematerialiser::Rematerialiser(
 {
 }
 
+void Rematerialiser::operator()(VariableDeclaration& _varDecl)
+{
+	DataFlowAnalyzer::operator()(_varDecl);
+	for (auto const& var: _varDecl.variables)
+		m_loopDepthOfValue[var.name] = m_loopDepth;
+}
+
+void Rematerialiser::operator()(Assignment& _assignment)
+{
+	DataFlowAnalyzer::operator()(_assignment);
+	for (auto const& var: _assignment.variableNames)
+		m_loopDepthOfValue[var.name] = m_loopDepth;
+}
+
+void Rematerialiser::operator()(FunctionDefinition& _fun)
+{
+	size_t loopDepth = m_loopDepth;
+	m_loopDepth = 0;
+	DataFlowAnalyzer::operator()(_fun);
+	m_loopDepth = loopDepth;
+}
+
+void Rematerialiser::operator()(ForLoop& _for)
+{
+	++m_loopDepth;
+	DataFlowAnalyzer::operator()(_for);
+	--m_loopDepth;
+}
+
 void Rematerialiser::visit(Expression& _e)
 {
 	if (_e.type() == typeid(Identifier))
@@ -78,7 +107,10 @@ void Rematerialiser::visit(Expression& _e)
 			auto const& value = *m_value.at(name);
 			size_t refs = m_referenceCounts[name];
 			size_t cost = CodeCost::codeCost(m_dialect, value);
-			if (refs <= 1 || cost == 0 || (refs <= 5 && cost <= 1) || m_varsToAlwaysRematerialize.count(name))
+			// Moving an expression into a loop would evaluate it in every iteration,
+			// while pushing a literal is as cheap as duplicating it.
+			bool intoLoop = m_loopDepthOfValue[name] < m_loopDepth && value.type() != typeid(Literal);
+			if ((refs <= 1 && !intoLoop) || cost == 0 || (refs <= 5 && cost <= 1) || m_varsToAlwaysRematerialize.count(name))
 			{
 				assertThrow(m_referenceCounts[name] > 0, OptimizerException, "");
 				for (auto const& ref: m_references.forward[name])
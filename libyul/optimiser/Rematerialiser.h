@@ -32,6 +32,9 @@ namespace yul
  *  - the value is extremely cheap ("cost" of zero like ``caller()``)
  *  - the variable is referenced at most 5 times and the value is rather cheap
  *    ("cost" of at most 1 like a constant up to 0xff)
+ * References inside a for loop to values other than literals that are assigned outside
+ * of it are not replaced only because they are referenced exactly once, since the
+ * expression would then be evaluated in every iteration.
  *
  * Prerequisite: Disambiguator, ForLoopInitRewriter.
  */
@@ -61,11 +64,21 @@ protected:
 		std::set<YulString> _varsToAlwaysRematerialize = {}
 	);
 
+	using ASTModifier::operator();
+	void operator()(VariableDeclaration& _varDecl) override;
+	void operator()(Assignment& _assignment) override;
+	void operator()(FunctionDefinition& _fun) override;
+	void operator()(ForLoop& _for) override;
+
 	using ASTModifier::visit;
 	void visit(Expression& _e) override;
 
 	std::map<YulString, size_t> m_referenceCounts;
 	std::set<YulString> m_varsToAlwaysRematerialize;
+	/// Number of for loops the current position is nested in.
+	size_t m_loopDepth = 0;
+	/// Loop depth of the point where the variables were assigned their current values.
+	std::map<YulString, size_t> m_loopDepthOfValue;
 };
 
 }
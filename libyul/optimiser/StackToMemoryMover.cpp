@@ -0,0 +1,360 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimisation stage that moves variables of functions that are not compilable
+ * from the stack into memory.
+ */
+
+#include <libyul/optimiser/StackToMemoryMover.h>
+
+#include <libyul/optimiser/ASTWalker.h>
+#include <libyul/optimiser/NameCollector.h>
+#include <libyul/optimiser/NameDispenser.h>
+
+#include <libyul/CompilabilityChecker.h>
+#include <libyul/AsmData.h>
+#include <libyul/Dialect.h>
+
+#include <libdevcore/CommonData.h>
+
+using namespace std;
+using namespace dev;
+using namespace yul;
+
+namespace
+{
+
+/**
+ * Replaces declarations of and assignments to the given variables by ``mstore`` and
+ * references to them by ``mload``.
+ */
+class VariableMemoryReplacer: public ASTModifier
+{
+public:
+	VariableMemoryReplacer(
+		map<YulString, u256> const& _slots,
+		NameDispenser& _nameDispenser,
+		set<YulString>& _newNames
+	):
+		m_slots(_slots),
+		m_nameDispenser(_nameDispenser),
+		m_newNames(_newNames)
+	{}
+
+	using ASTModifier::operator();
+	using ASTModifier::visit;
+
+	void operator()(FunctionDefinition& _function) override
+	{
+		vector<Statement> parameterStores;
+		for (TypedName& parameter: _function.parameters)
+			if (m_slots.count(parameter.name))
+			{
+				YulString newName = this->newName(parameter.name);
+				parameterStores.emplace_back(store(
+					parameter.location,
+					parameter.name,
+					Identifier{parameter.location, newName}
+				));
+				parameter.name = newName;
+			}
+		ASTModifier::operator()(_function);
+		_function.body.statements.insert(
+			_function.body.statements.begin(),
+			make_move_iterator(parameterStores.begin()),
+			make_move_iterator(parameterStores.end())
+		);
+	}
+
+	void operator()(Block& _block) override
+	{
+		iterateReplacing(
+			_block.statements,
+			[&](Statement& _statement) -> boost::optional<vector<Statement>>
+			{
+				visit(_statement);
+				if (_statement.type() == typeid(VariableDeclaration))
+					return replaceDeclaration(boost::get<VariableDeclaration>(_statement));
+				else if (_statement.type() == typeid(Assignment))
+					return replaceAssignment(boost::get<Assignment>(_statement));
+				else
+					return {};
+			}
+		);
+	}
+
+	void visit(Expression& _expression) override
+	{
+		if (_expression.type() == typeid(Identifier))
+		{
+			Identifier& identifier = boost::get<Identifier>(_expression);
+			if (m_slots.count(identifier.name))
+			{
+				langutil::SourceLocation location = identifier.location;
+				_expression = FunctionCall{
+					location,
+					Identifier{location, "mload"_yulstring},
+					{slotLiteral(location, identifier.name)}
+				};
+			}
+		}
+		else
+			ASTModifier::visit(_expression);
+	}
+
+private:
+	boost::optional<vector<Statement>> replaceDeclaration(VariableDeclaration& _varDecl)
+	{
+		if (!any_of(_varDecl.variables.begin(), _varDecl.variables.end(), [&](TypedName const& _var) {
+			return m_slots.count(_var.name);
+		}))
+			return {};
+
+		vector<Statement> result;
+		if (!_varDecl.value)
+		{
+			TypedNameList remainingVariables;
+			for (TypedName const& variable: _varDecl.variables)
+				if (m_slots.count(variable.name))
+					result.emplace_back(store(
+						variable.location,
+						variable.name,
+						Literal{variable.location, LiteralKind::Number, YulString{"0"}, {}}
+					));
+				else
+					remainingVariables.emplace_back(variable);
+			if (!remainingVariables.empty())
+				result.insert(result.begin(), VariableDeclaration{_varDecl.location, std::move(remainingVariables), {}});
+		}
+		else if (_varDecl.variables.size() == 1)
+			result.emplace_back(store(_varDecl.location, _varDecl.variables.front().name, std::move(*_varDecl.value)));
+		else
+		{
+			// Keep the declaration, but declare fresh variables that are copied to memory directly afterwards.
+			vector<Statement> stores;
+			for (TypedName& variable: _varDecl.variables)
+				if (m_slots.count(variable.name))
+				{
+					YulString newName = this->newName(variable.name);
+					stores.emplace_back(store(variable.location, variable.name, Identifier{variable.location, newName}));
+					variable.name = newName;
+				}
+			result.emplace_back(std::move(_varDecl));
+			result += std::move(stores);
+		}
+		return {std::move(result)};
+	}
+
+	boost::optional<vector<Statement>> replaceAssignment(Assignment& _assignment)
+	{
+		if (!any_of(_assignment.variableNames.begin(), _assignment.variableNames.end(), [&](Identifier const& _var) {
+			return m_slots.count(_var.name);
+		}))
+			return {};
+
+		vector<Statement> result;
+		if (_assignment.variableNames.size() == 1)
+			result.emplace_back(store(_assignment.location, _assignment.variableNames.front().name, std::move(*_assignment.value)));
+		else
+		{
+			// Assign the values to fresh variables first and distribute them to memory and stack afterwards.
+			VariableDeclaration tempDecl{_assignment.location, {}, std::move(_assignment.value)};
+			vector<Statement> distribution;
+			for (Identifier const& variable: _assignment.variableNames)
+			{
+				YulString tempName = newName(variable.name);
+				tempDecl.variables.emplace_back(TypedName{variable.location, tempName, {}});
+				if (m_slots.count(variable.name))
+					distribution.emplace_back(store(variable.location, variable.name, Identifier{variable.location, tempName}));
+				else
+					distribution.emplace_back(Assignment{
+						variable.location,
+						{variable},
+						make_unique<Expression>(Identifier{variable.location, tempName})
+					});
+			}
+			result.emplace_back(std::move(tempDecl));
+			result += std::move(distribution);
+		}
+		return {std::move(result)};
+	}
+
+	Literal slotLiteral(langutil::SourceLocation const& _location, YulString _variable) const
+	{
+		return Literal{_location, LiteralKind::Number, YulString{formatNumber(m_slots.at(_variable))}, {}};
+	}
+
+	ExpressionStatement store(langutil::SourceLocation const& _location, YulString _variable, Expression _value) const
+	{
+		return ExpressionStatement{_location, FunctionCall{
+			_location,
+			Identifier{_location, "mstore"_yulstring},
+			{slotLiteral(_location, _variable), std::move(_value)}
+		}};
+	}
+
+	YulString newName(YulString _variable)
+	{
+		YulString name = m_nameDispenser.newName(_variable);
+		m_newNames.insert(name);
+		return name;
+	}
+
+	map<YulString, u256> const& m_slots;
+	NameDispenser& m_nameDispenser;
+	/// Names of the variables introduced to copy values to or from memory.
+	set<YulString>& m_newNames;
+};
+
+/// @returns the names of all functions that can call themselves, directly or indirectly.
+set<YulString> recursiveFunctions(vector<FunctionDefinition const*> const& _functions)
+{
+	map<YulString, set<YulString>> callees;
+	for (FunctionDefinition const* function: _functions)
+		callees[function->name];
+	for (FunctionDefinition const* function: _functions)
+		for (auto const& reference: ReferencesCounter::countReferences(function->body))
+			if (callees.count(reference.first))
+				callees[function->name].insert(reference.first);
+
+	set<YulString> recursive;
+	for (FunctionDefinition const* function: _functions)
+	{
+		set<YulString> visited;
+		vector<YulString> toVisit(callees[function->name].begin(), callees[function->name].end());
+		while (!toVisit.empty())
+		{
+			YulString callee = toVisit.back();
+			toVisit.pop_back();
+			if (callee == function->name)
+			{
+				recursive.insert(callee);
+				break;
+			}
+			if (visited.insert(callee).second)
+				toVisit += vector<YulString>(callees[callee].begin(), callees[callee].end());
+		}
+	}
+	return recursive;
+}
+
+/// @returns up to @a _number of @a _candidates that are neither in @a _slots nor in @a _excluded,
+/// least referenced in @a _references first.
+vector<YulString> selectVariables(
+	set<YulString> const& _candidates,
+	map<YulString, size_t> const& _references,
+	map<YulString, u256> const& _slots,
+	set<YulString> const& _excluded,
+	size_t _number
+)
+{
+	vector<pair<size_t, string>> sortedCandidates;
+	for (YulString candidate: _candidates)
+		if (!_slots.count(candidate) && !_excluded.count(candidate))
+			sortedCandidates.emplace_back(
+				_references.count(candidate) ? _references.at(candidate) : 0,
+				candidate.str()
+			);
+	// Compare the names as strings so that the choice does not depend on the YulString handles.
+	sort(sortedCandidates.begin(), sortedCandidates.end());
+
+	vector<YulString> selected;
+	for (auto const& candidate: sortedCandidates)
+	{
+		if (selected.size() >= _number)
+			break;
+		selected.emplace_back(candidate.second);
+	}
+	return selected;
+}
+
+}
+
+size_t StackToMemoryMover::run(
+	Dialect const& _dialect,
+	Block& _ast,
+	bool _optimizeStackAllocation,
+	u256 const& _memoryStart
+)
+{
+	yulAssert(
+		_ast.statements.size() > 0 && _ast.statements.at(0).type() == typeid(Block),
+		"Need to run the function grouper before the stack to memory mover."
+	);
+	if (!_dialect.builtin("mstore"_yulstring) || !_dialect.builtin("mload"_yulstring))
+		return 0;
+
+	auto functions = [&]()
+	{
+		vector<FunctionDefinition const*> result;
+		for (size_t i = 1; i < _ast.statements.size(); ++i)
+			result.emplace_back(&boost::get<FunctionDefinition>(_ast.statements[i]));
+		return result;
+	};
+	set<YulString> const recursive = recursiveFunctions(functions());
+
+	NameDispenser nameDispenser{_dialect, _ast};
+	map<YulString, u256> slots;
+	// Variables introduced by the replacement itself are never moved.
+	set<YulString> newNames;
+	while (true)
+	{
+		map<YulString, int> stackSurplus = CompilabilityChecker::run(_dialect, _ast, _optimizeStackAllocation);
+		if (stackSurplus.empty())
+			break;
+
+		map<YulString, u256> newSlots;
+		auto assignSlots = [&](vector<YulString> const& _variables)
+		{
+			for (YulString variable: _variables)
+				newSlots[variable] = _memoryStart + 32 * (slots.size() + newSlots.size());
+		};
+
+		if (stackSurplus.count(YulString{}))
+		{
+			Block const& mainBlock = boost::get<Block>(_ast.statements.at(0));
+			assignSlots(selectVariables(
+				NameCollector{mainBlock}.names(),
+				ReferencesCounter::countReferences(mainBlock),
+				slots,
+				newNames,
+				size_t(stackSurplus.at({}))
+			));
+		}
+		for (FunctionDefinition const* function: functions())
+		{
+			if (!stackSurplus.count(function->name) || recursive.count(function->name))
+				continue;
+			set<YulString> candidates = NameCollector{function->body}.names();
+			for (TypedName const& parameter: function->parameters)
+				candidates.insert(parameter.name);
+			assignSlots(selectVariables(
+				candidates,
+				ReferencesCounter::countReferences(*function),
+				slots,
+				newNames,
+				size_t(stackSurplus.at(function->name))
+			));
+		}
+
+		if (newSlots.empty())
+			break;
+		VariableMemoryReplacer{newSlots, nameDispenser, newNames}(_ast);
+		slots.insert(newSlots.begin(), newSlots.end());
+	}
+	return slots.size() * 32;
+}
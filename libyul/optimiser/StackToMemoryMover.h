@@ -0,0 +1,65 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Optimisation stage that moves variables of functions that are not compilable
+ * from the stack into memory.
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+
+namespace yul
+{
+
+struct Dialect;
+struct Block;
+
+/**
+ * Optimisation stage that moves local variables and parameters of functions that are not
+ * compilable into a reserved area of memory until the AST is compilable.
+ *
+ * Each moved variable is assigned its own 32 byte slot, its declarations and assignments
+ * are replaced by ``mstore`` and its references by ``mload``. Parameters are copied into
+ * their slot at the start of the function. Return variables and variables of recursive
+ * functions are never moved.
+ *
+ * In each round, as many variables as the CompilabilityChecker reports slots missing are
+ * moved out of every function that is not compilable, starting with the least referenced.
+ *
+ * The memory area must not be accessed by anything else and the code must not be
+ * re-entered while one of the functions whose variables were moved is active.
+ *
+ * Should only be used if the StackCompressor was not successful.
+ *
+ * Prerequisite: Disambiguator, Function Grouper
+ */
+class StackToMemoryMover
+{
+public:
+	/// Moves variables into memory starting at @a _memoryStart until the AST is compilable
+	/// or there are no variables left to move.
+	/// @returns the number of bytes of memory used.
+	static size_t run(
+		Dialect const& _dialect,
+		Block& _ast,
+		bool _optimizeStackAllocation,
+		dev::u256 const& _memoryStart
+	);
+};
+
+}
@@ -33,6 +33,7 @@
 #include <libyul/optimiser/ExpressionInliner.h>
 #include <libyul/optimiser/FullInliner.h>
 #include <libyul/optimiser/ForLoopInitRewriter.h>
+#include <libyul/optimiser/LoopInvariantCodeMotion.h>
 #include <libyul/optimiser/Rematerialiser.h>
 #include <libyul/optimiser/UnusedPruner.h>
 #include <libyul/optimiser/ExpressionSimplifier.h>
@@ -40,6 +41,7 @@
 #include <libyul/optimiser/SSAReverser.h>
 #include <libyul/optimiser/SSATransform.h>
 #include <libyul/optimiser/StackCompressor.h>
+#include <libyul/optimiser/StackToMemoryMover.h>
 #include <libyul/optimiser/StructuralSimplifier.h>
 #include <libyul/optimiser/RedundantAssignEliminator.h>
 #include <libyul/optimiser/VarNameCleaner.h>
@@ -53,19 +55,74 @@
 #include <libyul/backends/wasm/WasmDialect.h>
 #include <libyul/backends/evm/NoOutputAssembly.h>
 
+#include <libdevcore/Common.h>
 #include <libdevcore/CommonData.h>
+#include <libdevcore/Parallel.h>
+
+#include <functional>
 
 using namespace std;
 using namespace dev;
 using namespace yul;
 
-void OptimiserSuite::run(
+namespace
+{
+
+/// Runs @a _step on every top-level function definition of @a _ast and on a block
+/// consisting of the remaining top-level statements, using the threads of @a _pool.
+/// Only valid for steps that do not depend on or modify anything outside the function
+/// they are run on and do not create new names. The result is the same as running the
+/// step on @a _ast, independent of the number of threads.
+/// Requires the function definitions to follow all other statements, as established by
+/// the FunctionHoister, and otherwise simply runs @a _step on @a _ast.
+void runPerFunction(Block& _ast, WorkerPool& _pool, function<void(Block&)> const& _step)
+{
+	auto firstFunction = find_if(_ast.statements.begin(), _ast.statements.end(), [](Statement const& _s) {
+		return _s.type() == typeid(FunctionDefinition);
+	});
+	if (
+		_pool.threads() <= 1 ||
+		firstFunction == _ast.statements.end() ||
+		!all_of(firstFunction, _ast.statements.end(), [](Statement const& _s) {
+			return _s.type() == typeid(FunctionDefinition);
+		})
+	)
+	{
+		_step(_ast);
+		return;
+	}
+
+	vector<Block> units;
+	units.emplace_back(Block{_ast.location, {}});
+	for (auto it = _ast.statements.begin(); it != _ast.statements.end(); ++it)
+		if (it < firstFunction)
+			units.front().statements.emplace_back(std::move(*it));
+		else
+		{
+			units.emplace_back(Block{_ast.location, {}});
+			units.back().statements.emplace_back(std::move(*it));
+		}
+	_ast.statements.clear();
+
+	ScopeGuard reassemble([&]() {
+		for (Block& unit: units)
+			for (Statement& statement: unit.statements)
+				_ast.statements.emplace_back(std::move(statement));
+	});
+	_pool.parallelFor(units.size(), [&](size_t _unit) { _step(units[_unit]); });
+}
+
+}
+
+size_t OptimiserSuite::run(
 	Dialect const& _dialect,
 	GasMeter const* _meter,
 	Block& _ast,
 	AsmAnalysisInfo const& _analysisInfo,
 	bool _optimizeStackAllocation,
-	set<YulString> const& _externallyUsedIdentifiers
+	set<YulString> const& _externallyUsedIdentifiers,
+	size_t _threads,
+	boost::optional<u256> const& _spillMemoryStart
 )
 {
 	set<YulString> reservedIdentifiers = _externallyUsedIdentifiers;
@@ -90,6 +147,13 @@ void OptimiserSuite::run(
 	// None of the above can make stack problems worse.
 
 	NameDispenser dispenser{_dialect, ast, reservedIdentifiers};
+	// The steps inside perFunction are run on each function separately and potentially
+	// concurrently. Steps that use the name dispenser or look at more than one function
+	// act as synchronisation points and are always run on the whole AST.
+	// The same threads are used for all steps, so that their thread-local simplification
+	// rules are only created once.
+	WorkerPool pool(_threads);
+	auto perFunction = [&](function<void(Block&)> const& _step) { runPerFunction(ast, pool, _step); };
 
 	size_t codeSize = 0;
 	for (size_t rounds = 0; rounds < 12; ++rounds)
@@ -105,32 +169,37 @@ void OptimiserSuite::run(
 			// Turn into SSA and simplify
 			ExpressionSplitter{_dialect, dispenser}(ast);
 			SSATransform::run(ast, dispenser);
-			RedundantAssignEliminator::run(_dialect, ast);
-			RedundantAssignEliminator::run(_dialect, ast);
-
-			ExpressionSimplifier::run(_dialect, ast);
-			CommonSubexpressionEliminator{_dialect}(ast);
+			perFunction([&](Block& _block) {
+				RedundantAssignEliminator::run(_dialect, _block);
+				RedundantAssignEliminator::run(_dialect, _block);
+
+				ExpressionSimplifier::run(_dialect, _block);
+				CommonSubexpressionEliminator{_dialect}(_block);
+				LoopInvariantCodeMotion::run(_dialect, _block);
+			});
 		}
 
 		{
 			// still in SSA, perform structural simplification
-			ControlFlowSimplifier{_dialect}(ast);
-			StructuralSimplifier{_dialect}(ast);
-			ControlFlowSimplifier{_dialect}(ast);
-			BlockFlattener{}(ast);
-			DeadCodeEliminator{_dialect}(ast);
+			perFunction([&](Block& _block) {
+				ControlFlowSimplifier{_dialect}(_block);
+				StructuralSimplifier{_dialect}(_block);
+				ControlFlowSimplifier{_dialect}(_block);
+				BlockFlattener{}(_block);
+				DeadCodeEliminator{_dialect}(_block);
+			});
 			UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
 		}
 		{
 			// simplify again
-			CommonSubexpressionEliminator{_dialect}(ast);
+			perFunction([&](Block& _block) { CommonSubexpressionEliminator{_dialect}(_block); });
 			UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
 		}
 
 		{
 			// reverse SSA
 			SSAReverser::run(ast);
-			CommonSubexpressionEliminator{_dialect}(ast);
+			perFunction([&](Block& _block) { CommonSubexpressionEliminator{_dialect}(_block); });
 			UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
 
 			ExpressionJoiner::run(ast);
@@ -149,35 +218,41 @@ void OptimiserSuite::run(
 			// Turn into SSA again and simplify
 			ExpressionSplitter{_dialect, dispenser}(ast);
 			SSATransform::run(ast, dispenser);
-			RedundantAssignEliminator::run(_dialect, ast);
-			RedundantAssignEliminator::run(_dialect, ast);
-			CommonSubexpressionEliminator{_dialect}(ast);
+			perFunction([&](Block& _block) {
+				RedundantAssignEliminator::run(_dialect, _block);
+				RedundantAssignEliminator::run(_dialect, _block);
+				CommonSubexpressionEliminator{_dialect}(_block);
+			});
 		}
 
 		{
 			// run full inliner
 			FunctionGrouper{}(ast);
 			EquivalentFunctionCombiner::run(ast);
-			FullInliner{ast, dispenser}.run();
+			FullInliner{ast, dispenser, _meter}.run();
 			BlockFlattener{}(ast);
 		}
 
 		{
 			// SSA plus simplify
 			SSATransform::run(ast, dispenser);
-			RedundantAssignEliminator::run(_dialect, ast);
-			RedundantAssignEliminator::run(_dialect, ast);
-			ExpressionSimplifier::run(_dialect, ast);
-			StructuralSimplifier{_dialect}(ast);
-			BlockFlattener{}(ast);
-			DeadCodeEliminator{_dialect}(ast);
-			ControlFlowSimplifier{_dialect}(ast);
-			CommonSubexpressionEliminator{_dialect}(ast);
+			perFunction([&](Block& _block) {
+				RedundantAssignEliminator::run(_dialect, _block);
+				RedundantAssignEliminator::run(_dialect, _block);
+				ExpressionSimplifier::run(_dialect, _block);
+				StructuralSimplifier{_dialect}(_block);
+				BlockFlattener{}(_block);
+				DeadCodeEliminator{_dialect}(_block);
+				ControlFlowSimplifier{_dialect}(_block);
+				CommonSubexpressionEliminator{_dialect}(_block);
+			});
 			SSATransform::run(ast, dispenser);
-			RedundantAssignEliminator::run(_dialect, ast);
-			RedundantAssignEliminator::run(_dialect, ast);
+			perFunction([&](Block& _block) {
+				RedundantAssignEliminator::run(_dialect, _block);
+				RedundantAssignEliminator::run(_dialect, _block);
+			});
 			UnusedPruner::runUntilStabilised(_dialect, ast, reservedIdentifiers);
-			CommonSubexpressionEliminator{_dialect}(ast);
+			perFunction([&](Block& _block) { CommonSubexpressionEliminator{_dialect}(_block); });
 		}
 	}
 
@@ -202,9 +277,14 @@ void OptimiserSuite::run(
 	// This is a tuning parameter, but actually just prevents infinite loops.
 	size_t stackCompressorMaxIterations = 16;
 	FunctionGrouper{}(ast);
-	// We ignore the return value because we will get a much better error
-	// message once we perform code generation.
-	StackCompressor::run(_dialect, ast, _optimizeStackAllocation, stackCompressorMaxIterations);
+	// If there is no memory to move variables to, we ignore the return value
+	// because we will get a much better error message once we perform code generation.
+	size_t spilledMemory = 0;
+	if (
+		!StackCompressor::run(_dialect, ast, _optimizeStackAllocation, stackCompressorMaxIterations) &&
+		_spillMemoryStart
+	)
+		spilledMemory = StackToMemoryMover::run(_dialect, ast, _optimizeStackAllocation, *_spillMemoryStart);
 	BlockFlattener{}(ast);
 	DeadCodeEliminator{_dialect}(ast);
 	ControlFlowSimplifier{_dialect}(ast);
@@ -227,4 +307,5 @@ void OptimiserSuite::run(
 	yul::AsmAnalyzer::analyzeStrictAssertCorrect(_dialect, ast);
 
 	_ast = std::move(ast);
+	return spilledMemory;
 }
@@ -24,6 +24,10 @@
 #include <libyul/YulString.h>
 #include <liblangutil/EVMVersion.h>
 
+#include <libdevcore/Common.h>
+
+#include <boost/optional.hpp>
+
 #include <set>
 
 namespace yul
@@ -35,17 +39,27 @@ class GasMeter;
 
 /**
  * Optimiser suite that combines all steps and also provides the settings for the heuristics
+ *
+ * Steps that only work inside a single function and do not create new names can
+ * be run on the individual functions concurrently using up to @a _threads threads.
+ * The result does not depend on the number of threads.
+ *
+ * If @a _spillMemoryStart is given, variables of functions that are still not compilable
+ * after the stack compressor are moved to memory starting at that offset.
  */
 class OptimiserSuite
 {
 public:
-	static void run(
+	/// @returns the number of bytes of memory used for variables moved out of the stack.
+	static size_t run(
 		Dialect const& _dialect,
 		GasMeter const* _meter,
 		Block& _ast,
 		AsmAnalysisInfo const& _analysisInfo,
 		bool _optimizeStackAllocation,
-		std::set<YulString> const& _externallyUsedIdentifiers = {}
+		std::set<YulString> const& _externallyUsedIdentifiers = {},
+		size_t _threads = 1,
+		boost::optional<dev::u256> const& _spillMemoryStart = boost::none
 	);
 };
 
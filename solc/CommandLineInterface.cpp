@@ -28,11 +28,14 @@
 #include <libsolidity/interface/Version.h>
 #include <libsolidity/parsing/Parser.h>
 #include <libsolidity/ast/ASTPrinter.h>
+#include <libsolidity/ast/ASTCBORConverter.h>
 #include <libsolidity/ast/ASTJsonConverter.h>
 #include <libsolidity/analysis/NameAndTypeResolver.h>
 #include <libsolidity/interface/CompilerStack.h>
 #include <libsolidity/interface/StandardCompiler.h>
 #include <libsolidity/interface/GasEstimator.h>
+#include <libsolidity/codegen/MultiUseYulFunctionCollector.h>
+#include <libsolidity/formal/SMTQueryCache.h>
 
 #include <libyul/AssemblyStack.h>
 
@@ -107,6 +110,7 @@ static string const g_strAssemble = "assemble";
 static string const g_strAst = "ast";
 static string const g_strAstJson = "ast-json";
 static string const g_strAstCompactJson = "ast-compact-json";
+static string const g_strAstCBOR = "ast-cbor";
 static string const g_strBinary = "bin";
 static string const g_strBinaryRuntime = "bin-runtime";
 static string const g_strCombinedJson = "combined-json";
@@ -135,6 +139,7 @@ static string const g_strNatspecUser = "userdoc";
 static string const g_strOpcodes = "opcodes";
 static string const g_strOptimize = "optimize";
 static string const g_strOptimizeRuns = "optimize-runs";
+static string const g_strOptimizeProfile = "optimize-profile";
 static string const g_strOptimizeYul = "optimize-yul";
 static string const g_strOutputDir = "output-dir";
 static string const g_strOverwrite = "overwrite";
@@ -151,6 +156,9 @@ static string const g_strIgnoreMissingFiles = "ignore-missing";
 static string const g_strColor = "color";
 static string const g_strNoColor = "no-color";
 static string const g_strNewReporter = "new-reporter";
+static string const g_strSMTQueryCache = "smt-query-cache";
+static string const g_strFunctionLibraryStats = "function-library-stats";
+static string const g_strThreads = "threads";
 
 static string const g_argAbi = g_strAbi;
 static string const g_argPrettyJson = g_strPrettyJson;
@@ -160,6 +168,7 @@ static string const g_argAsmJson = g_strAsmJson;
 static string const g_argAssemble = g_strAssemble;
 static string const g_argAst = g_strAst;
 static string const g_argAstCompactJson = g_strAstCompactJson;
+static string const g_argAstCBOR = g_strAstCBOR;
 static string const g_argAstJson = g_strAstJson;
 static string const g_argBinary = g_strBinary;
 static string const g_argBinaryRuntime = g_strBinaryRuntime;
@@ -182,6 +191,7 @@ static string const g_argNatspecUser = g_strNatspecUser;
 static string const g_argOpcodes = g_strOpcodes;
 static string const g_argOptimize = g_strOptimize;
 static string const g_argOptimizeRuns = g_strOptimizeRuns;
+static string const g_argOptimizeProfile = g_strOptimizeProfile;
 static string const g_argOutputDir = g_strOutputDir;
 static string const g_argSignatureHashes = g_strSignatureHashes;
 static string const g_argStandardJSON = g_strStandardJSON;
@@ -192,6 +202,9 @@ static string const g_argIgnoreMissingFiles = g_strIgnoreMissingFiles;
 static string const g_argColor = g_strColor;
 static string const g_argNoColor = g_strNoColor;
 static string const g_argNewReporter = g_strNewReporter;
+static string const g_argSMTQueryCache = g_strSMTQueryCache;
+static string const g_argFunctionLibraryStats = g_strFunctionLibraryStats;
+static string const g_argThreads = g_strThreads;
 
 /// Possible arguments to for --combined-json
 static set<string> const g_combinedJsonArgs
@@ -318,11 +331,20 @@ void CommandLineInterface::handleEWasm(string const& _contractName)
 	if (m_args.count(g_argEWasm))
 	{
 		if (m_args.count(g_argOutputDir))
+		{
 			createFile(m_compiler->filesystemFriendlyName(_contractName) + ".wast", m_compiler->eWasm(_contractName));
+			createFile(
+				m_compiler->filesystemFriendlyName(_contractName) + ".wasm",
+				asString(m_compiler->eWasmObject(_contractName).bytecode),
+				true
+			);
+		}
 		else
 		{
-			sout() << "eWasm: " << endl;
+			sout() << "eWasm text: " << endl;
 			sout() << m_compiler->eWasm(_contractName) << endl;
+			sout() << "eWasm binary (hex): " << endl;
+			sout() << m_compiler->eWasmObject(_contractName).toHex() << endl;
 		}
 	}
 }
@@ -584,7 +606,7 @@ bool CommandLineInterface::parseLibraryOption(string const& _input)
 	return true;
 }
 
-void CommandLineInterface::createFile(string const& _fileName, string const& _data)
+void CommandLineInterface::createFile(string const& _fileName, string const& _data, bool _binary)
 {
 	namespace fs = boost::filesystem;
 	// create directory if not existent
@@ -599,7 +621,7 @@ void CommandLineInterface::createFile(string const& _fileName, string const& _da
 		m_error = true;
 		return;
 	}
-	ofstream outFile(pathName);
+	ofstream outFile(pathName, _binary ? ios::out | ios::binary : ios::out);
 	outFile << _data;
 	if (!outFile)
 		BOOST_THROW_EXCEPTION(FileError() << errinfo_comment("Could not write to file: " + pathName));
@@ -650,7 +672,18 @@ Allowed options)",
 			"Set for how many contract runs to optimize."
 			"Lower values will optimize more for initial deployment cost, higher values will optimize more for high-frequency usage."
 		)
+		(
+			g_argOptimizeProfile.c_str(),
+			po::value<string>()->value_name("file"),
+			"JSON file with execution counts of source ranges (\"<start>:<length>\") per source unit. "
+			"Overrides the number of runs for the runtime code in these ranges."
+		)
 		(g_strOptimizeYul.c_str(), "Enable Yul optimizer in Solidity, mostly for ABIEncoderV2. Still considered experimental.")
+		(
+			g_argThreads.c_str(),
+			po::value<unsigned>()->value_name("n")->default_value(1),
+			"Maximum number of threads used to optimize and compile Yul code. Does not influence the output."
+		)
 		(g_argPrettyJson.c_str(), "Output JSON in pretty format. Currently it only works with the combined JSON output.")
 		(
 			g_argLibraries.c_str(),
@@ -699,6 +732,16 @@ Allowed options)",
 			"and modify binaries in place."
 		)
 		(g_argMetadataLiteral.c_str(), "Store referenced sources are literal data in the metadata output.")
+		(
+			g_argSMTQueryCache.c_str(),
+			po::value<string>()->value_name("file"),
+			"Re-use answers of the SMT solvers stored in the given file and store new ones there."
+		)
+		(
+			g_argFunctionLibraryStats.c_str(),
+			"Print how many of the ABI coder and utility functions requested by the code generator "
+			"were reused from other contracts and how many had to be generated."
+		)
 		(
 			g_argAllowPaths.c_str(),
 			po::value<string>()->value_name("path(s)"),
@@ -714,6 +757,7 @@ Allowed options)",
 		(g_argAst.c_str(), "AST of all source files.")
 		(g_argAstJson.c_str(), "AST of all source files in JSON format.")
 		(g_argAstCompactJson.c_str(), "AST of all source files in a compact JSON format.")
+		(g_argAstCBOR.c_str(), "AST of all source files in a compact binary format (CBOR), base64-encoded unless written to --output-dir.")
 		(g_argAsm.c_str(), "EVM assembly of the contracts.")
 		(g_argAsmJson.c_str(), "EVM assembly of the contracts in JSON format.")
 		(g_argOpcodes.c_str(), "Opcodes of the contracts.")
@@ -721,7 +765,7 @@ Allowed options)",
 		(g_argBinaryRuntime.c_str(), "Binary of the runtime part of the contracts in hex.")
 		(g_argAbi.c_str(), "ABI specification of the contracts.")
 		(g_argIR.c_str(), "Intermediate Representation (IR) of all contracts (EXPERIMENTAL).")
-		(g_argEWasm.c_str(), "EWasm text representation of all contracts (EXPERIMENTAL).")
+		(g_argEWasm.c_str(), "EWasm text and binary representation of all contracts (EXPERIMENTAL).")
 		(g_argSignatureHashes.c_str(), "Function signature hashes of the contracts.")
 		(g_argNatspecUser.c_str(), "Natspec user documentation of all contracts.")
 		(g_argNatspecDev.c_str(), "Natspec developer documentation of all contracts.")
@@ -820,9 +864,7 @@ bool CommandLineInterface::processInput()
 			if (!boost::filesystem::is_regular_file(canonicalPath))
 				return ReadCallback::Result{false, "Not a valid file."};
 
-			auto contents = dev::readFileAsString(canonicalPath.string());
-			m_sourceCodes[path.generic_string()] = contents;
-			return ReadCallback::Result{true, contents};
+			return ReadCallback::Result{true, dev::readFileAsString(canonicalPath.string())};
 		}
 		catch (Exception const& _exception)
 		{
@@ -854,7 +896,8 @@ bool CommandLineInterface::processInput()
 	{
 		string input = dev::readStandardInput();
 		StandardCompiler compiler(fileReader);
-		sout() << compiler.compile(std::move(input)) << endl;
+		compiler.compile(input, sout());
+		sout() << endl;
 		return true;
 	}
 
@@ -878,6 +921,12 @@ bool CommandLineInterface::processInput()
 		m_evmVersion = *versionOption;
 	}
 
+	if (m_args[g_argThreads].as<unsigned>() == 0)
+	{
+		serr() << "Invalid option for --" << g_strThreads << ": must be at least 1." << endl;
+		return false;
+	}
+
 	if (m_args.count(g_argAssemble) || m_args.count(g_argStrictAssembly) || m_args.count(g_argYul))
 	{
 		// switch to assembly mode
@@ -928,6 +977,13 @@ bool CommandLineInterface::processInput()
 
 	m_compiler.reset(new CompilerStack(fileReader));
 
+	shared_ptr<smt::QueryCache> smtQueryCache;
+	if (m_args.count(g_argSMTQueryCache))
+	{
+		smtQueryCache = make_shared<smt::QueryCache>(m_args[g_argSMTQueryCache].as<string>());
+		m_compiler->setSMTQueryCache(smtQueryCache);
+	}
+
 	unique_ptr<SourceReferenceFormatter> formatter;
 	if (m_args.count(g_argNewReporter))
 		formatter = make_unique<SourceReferenceFormatterHuman>(serr(false), m_coloredOutput);
@@ -940,7 +996,9 @@ bool CommandLineInterface::processInput()
 			m_compiler->useMetadataLiteralSources(true);
 		if (m_args.count(g_argInputFile))
 			m_compiler->setRemappings(m_remappings);
-		m_compiler->setSources(m_sourceCodes);
+		// The compiler takes ownership of the sources, they are accessed through it from now on.
+		m_compiler->setSources(std::move(m_sourceCodes));
+		m_sourceCodes.clear();
 		if (m_args.count(g_argLibraries))
 			m_compiler->setLibraries(m_libraries);
 		if (m_args.count(g_argErrorRecovery))
@@ -955,6 +1013,27 @@ bool CommandLineInterface::processInput()
 		settings.expectedExecutionsPerDeployment = m_args[g_argOptimizeRuns].as<unsigned>();
 		settings.runYulOptimiser = m_args.count(g_strOptimizeYul);
 		settings.optimizeStackAllocation = settings.runYulOptimiser;
+		settings.yulThreads = m_args[g_argThreads].as<unsigned>();
+		if (m_args.count(g_argOptimizeProfile))
+		{
+			string profileFile = m_args[g_argOptimizeProfile].as<string>();
+			Json::Value profile;
+			string errors;
+			if (!jsonParseStrict(readFileAsString(profileFile), profile, &errors))
+			{
+				serr() << "Invalid execution profile \"" << profileFile << "\": " << errors << endl;
+				return false;
+			}
+			try
+			{
+				settings.executionProfile = make_shared<eth::ExecutionProfile>(eth::ExecutionProfile::fromJson(profile));
+			}
+			catch (eth::InvalidExecutionProfile const& _exception)
+			{
+				serr() << "Invalid execution profile \"" << profileFile << "\": " << *boost::get_error_info<errinfo_comment>(_exception) << endl;
+				return false;
+			}
+		}
 		m_compiler->setOptimiserSettings(settings);
 
 		bool successful = m_compiler->compile();
@@ -965,6 +1044,16 @@ bool CommandLineInterface::processInput()
 			formatter->printErrorInformation(*error);
 		}
 
+		if (smtQueryCache)
+		{
+			smtQueryCache->save();
+			for (string const& warning: smtQueryCache->warnings())
+				serr() << "Warning: " << warning << endl;
+			serr() <<
+				"SMT query cache: " << smtQueryCache->hits() << " hits, " <<
+				smtQueryCache->misses() << " misses." << endl;
+		}
+
 		if (!successful)
 			return false;
 	}
@@ -1051,7 +1140,7 @@ void CommandLineInterface::handleCombinedJSON()
 		if (requests.count(g_strOpcodes))
 			contractData[g_strOpcodes] = dev::eth::disassemble(m_compiler->object(contractName).bytecode);
 		if (requests.count(g_strAsm))
-			contractData[g_strAsm] = m_compiler->assemblyJSON(contractName, m_sourceCodes);
+			contractData[g_strAsm] = m_compiler->assemblyJSON(contractName);
 		if (requests.count(g_strSrcMap))
 		{
 			auto map = m_compiler->sourceMapping(contractName);
@@ -1084,11 +1173,11 @@ void CommandLineInterface::handleCombinedJSON()
 	{
 		bool legacyFormat = !requests.count(g_strCompactJSON);
 		output[g_strSources] = Json::Value(Json::objectValue);
-		for (auto const& sourceCode: m_sourceCodes)
+		for (string const& sourceName: m_compiler->sourceNames())
 		{
 			ASTJsonConverter converter(legacyFormat, m_compiler->sourceIndices());
-			output[g_strSources][sourceCode.first] = Json::Value(Json::objectValue);
-			output[g_strSources][sourceCode.first]["AST"] = converter.toJson(m_compiler->ast(sourceCode.first));
+			output[g_strSources][sourceName] = Json::Value(Json::objectValue);
+			output[g_strSources][sourceName]["AST"] = converter.toJson(m_compiler->ast(sourceName));
 		}
 	}
 
@@ -1110,6 +1199,8 @@ void CommandLineInterface::handleAst(string const& _argStr)
 		title = "JSON AST:";
 	else if (_argStr == g_argAstCompactJson)
 		title = "JSON AST (compact format):";
+	else if (_argStr == g_argAstCBOR)
+		title = "CBOR AST (base64):";
 	else
 		BOOST_THROW_EXCEPTION(InternalCompilerError() << errinfo_comment("Illegal argStr for AST"));
 
@@ -1117,8 +1208,8 @@ void CommandLineInterface::handleAst(string const& _argStr)
 	if (m_args.count(_argStr))
 	{
 		vector<ASTNode const*> asts;
-		for (auto const& sourceCode: m_sourceCodes)
-			asts.push_back(&m_compiler->ast(sourceCode.first));
+		for (string const& sourceName: m_compiler->sourceNames())
+			asts.push_back(&m_compiler->ast(sourceName));
 		map<ASTNode const*, eth::GasMeter::GasConsumption> gasCosts;
 		for (auto const& contract: m_compiler->contractNames())
 			if (auto const* assemblyItems = m_compiler->runtimeAssemblyItems(contract))
@@ -1134,41 +1225,49 @@ void CommandLineInterface::handleAst(string const& _argStr)
 		bool legacyFormat = !m_args.count(g_argAstCompactJson);
 		if (m_args.count(g_argOutputDir))
 		{
-			for (auto const& sourceCode: m_sourceCodes)
+			for (string const& sourceName: m_compiler->sourceNames())
 			{
 				stringstream data;
 				string postfix = "";
 				if (_argStr == g_argAst)
 				{
-					ASTPrinter printer(m_compiler->ast(sourceCode.first), sourceCode.second);
+					ASTPrinter printer(m_compiler->ast(sourceName), m_compiler->scanner(sourceName).source());
 					printer.print(data);
 				}
+				else if (_argStr == g_argAstCBOR)
+				{
+					bytes cbor = ASTCBORConverter(m_compiler->sourceIndices()).toCBOR(m_compiler->ast(sourceName));
+					data.write(reinterpret_cast<char const*>(cbor.data()), cbor.size());
+					postfix += "_cbor";
+				}
 				else
 				{
-					ASTJsonConverter(legacyFormat, m_compiler->sourceIndices()).print(data, m_compiler->ast(sourceCode.first));
+					ASTJsonConverter(legacyFormat, m_compiler->sourceIndices()).print(data, m_compiler->ast(sourceName));
 					postfix += "_json";
 				}
-				boost::filesystem::path path(sourceCode.first);
-				createFile(path.filename().string() + postfix + ".ast", data.str());
+				boost::filesystem::path path(sourceName);
+				createFile(path.filename().string() + postfix + ".ast", data.str(), _argStr == g_argAstCBOR);
 			}
 		}
 		else
 		{
 			sout() << title << endl << endl;
-			for (auto const& sourceCode: m_sourceCodes)
+			for (string const& sourceName: m_compiler->sourceNames())
 			{
-				sout() << endl << "======= " << sourceCode.first << " =======" << endl;
+				sout() << endl << "======= " << sourceName << " =======" << endl;
 				if (_argStr == g_argAst)
 				{
 					ASTPrinter printer(
-						m_compiler->ast(sourceCode.first),
-						sourceCode.second,
+						m_compiler->ast(sourceName),
+						m_compiler->scanner(sourceName).source(),
 						gasCosts
 					);
 					printer.print(sout());
 				}
+				else if (_argStr == g_argAstCBOR)
+					sout() << toBase64(ASTCBORConverter(m_compiler->sourceIndices()).toCBOR(m_compiler->ast(sourceName))) << endl;
 				else
-					ASTJsonConverter(legacyFormat, m_compiler->sourceIndices()).print(sout(), m_compiler->ast(sourceCode.first));
+					ASTJsonConverter(legacyFormat, m_compiler->sourceIndices()).print(sout(), m_compiler->ast(sourceName));
 			}
 		}
 	}
@@ -1281,13 +1380,15 @@ bool CommandLineInterface::assemble(
 )
 {
 	bool successful = true;
+	OptimiserSettings settings = _optimize ? OptimiserSettings::full() : OptimiserSettings::minimal();
+	settings.yulThreads = m_args[g_argThreads].as<unsigned>();
 	map<string, yul::AssemblyStack> assemblyStacks;
 	for (auto const& src: m_sourceCodes)
 	{
 		auto& stack = assemblyStacks[src.first] = yul::AssemblyStack(
 			m_evmVersion,
 			_language,
-			_optimize ? OptimiserSettings::full() : OptimiserSettings::minimal()
+			settings
 		);
 		try
 		{
@@ -1396,6 +1497,7 @@ void CommandLineInterface::outputCompilationResults()
 	handleAst(g_argAst);
 	handleAst(g_argAstJson);
 	handleAst(g_argAstCompactJson);
+	handleAst(g_argAstCBOR);
 
 	vector<string> contracts = m_compiler->contractNames();
 	for (string const& contract: contracts)
@@ -1408,9 +1510,9 @@ void CommandLineInterface::outputCompilationResults()
 		{
 			string ret;
 			if (m_args.count(g_argAsmJson))
-				ret = dev::jsonPrettyPrint(m_compiler->assemblyJSON(contract, m_sourceCodes));
+				ret = dev::jsonPrettyPrint(m_compiler->assemblyJSON(contract));
 			else
-				ret = m_compiler->assemblyString(contract, m_sourceCodes);
+				ret = m_compiler->assemblyString(contract);
 
 			if (m_args.count(g_argOutputDir))
 			{
@@ -1435,6 +1537,17 @@ void CommandLineInterface::outputCompilationResults()
 		handleNatspec(false, contract);
 	} // end of contracts iteration
 
+	if (m_args.count(g_argFunctionLibraryStats))
+		if (YulFunctionLibrary const* library = m_compiler->functionLibrary())
+		{
+			size_t requested = library->hits() + library->misses();
+			serr() <<
+				"Function library: " << library->hits() << " of " << requested <<
+				" requested functions reused (" <<
+				(requested ? 100 * library->hits() / requested : 0) << "%), " <<
+				library->size() << " distinct functions generated." << endl;
+		}
+
 	if (!g_hasOutput)
 	{
 		if (m_args.count(g_argOutputDir))
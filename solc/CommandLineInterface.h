@@ -84,7 +84,8 @@ private:
 	/// Create a file in the given directory
 	/// @arg _fileName the name of the file
 	/// @arg _data to be written
-	void createFile(std::string const& _fileName, std::string const& _data);
+	/// @arg _binary whether to write the data without newline conversion
+	void createFile(std::string const& _fileName, std::string const& _data, bool _binary = false);
 
 	/// Create a json file in the given directory
 	/// @arg _fileName the name of the file (the extension will be replaced with .json)
@@ -99,7 +100,7 @@ private:
 
 	/// Compiler arguments variable map
 	boost::program_options::variables_map m_args;
-	/// map of input files to source code strings
+	/// map of input files to source code strings, moved into the compiler when compiling
 	std::map<std::string, std::string> m_sourceCodes;
 	/// list of remappings
 	std::vector<dev::solidity::CompilerStack::Remapping> m_remappings;
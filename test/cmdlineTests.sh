@@ -152,6 +152,9 @@ function test_solc_behaviour()
     sed -i -e 's/^\(Exception while assembling:\).*/\1/' "$stderr_path"
     # Remove exception class name.
     sed -i -e 's/^\(Dynamic exception type:\).*/\1/' "$stderr_path"
+    # Remove the code deposit costs from gas estimates, since they include the metadata,
+    # whose size depends on the compiler version.
+    sed -i -e 's/^\(   [0-9]* + \)[0-9]*\( = \)[0-9]*$/\1<deposit>\2<total>/' "$stdout_path"
 
     if [[ $exitCode -ne "$exit_code_expected" ]]
     then
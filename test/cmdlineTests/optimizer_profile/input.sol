@@ -0,0 +1,7 @@
+pragma solidity >=0.0;
+
+contract C {
+    uint x;
+    function hot() public { x ^= 0x8000000000000000000000000000000000000000000000000000000000000000; }
+    function cold() public { x ^= 0x4000000000000000000000000000000000000000000000000000000000000000; }
+}
@@ -0,0 +1,9 @@
+pragma solidity >=0.0;
+pragma experimental ABIEncoderV2;
+
+contract C {
+	// The ABI decoder for these parameters does not fit the stack.
+	function f(bytes memory a, bytes memory, bytes memory, bytes memory, bytes memory, bytes memory, bytes memory, bytes memory, bytes memory, bytes memory, bytes memory, bytes memory, bytes memory, bytes memory b) public pure returns (uint) {
+		return a.length + b.length;
+	}
+}
@@ -40,6 +40,16 @@ BOOST_AUTO_TEST_CASE(test_to_hex)
 	BOOST_CHECK_EQUAL(toHex(fromHex("FF"), HexPrefix::DontAdd,  HexCase::Lower), "ff");
 }
 
+BOOST_AUTO_TEST_CASE(test_to_base64)
+{
+	BOOST_CHECK_EQUAL(toBase64(bytes()), "");
+	BOOST_CHECK_EQUAL(toBase64(asBytes("f")), "Zg==");
+	BOOST_CHECK_EQUAL(toBase64(asBytes("fo")), "Zm8=");
+	BOOST_CHECK_EQUAL(toBase64(asBytes("foo")), "Zm9v");
+	BOOST_CHECK_EQUAL(toBase64(asBytes("foobar")), "Zm9vYmFy");
+	BOOST_CHECK_EQUAL(toBase64(fromHex("fbff")), "+/8=");
+}
+
 BOOST_AUTO_TEST_CASE(test_format_number)
 {
 	BOOST_CHECK_EQUAL(formatNumber(u256(0x8000000)), "0x08000000");
@@ -0,0 +1,108 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for InvertibleMap, in particular joining with checkpoints.
+ */
+
+#include <libdevcore/InvertibleMap.h>
+
+#include <test/Options.h>
+
+#include <string>
+
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(InvertibleMapTest)
+
+BOOST_AUTO_TEST_CASE(references)
+{
+	InvertibleMap<string, string> m;
+	m.set("a", "x");
+	m.set("b", "x");
+	m.set("c", "y");
+	m.eraseValue("x");
+	BOOST_CHECK(m.values == (map<string, string>{{"c", "y"}}));
+	m.set("c", "z");
+	m.eraseValue("y");
+	BOOST_CHECK(m.values == (map<string, string>{{"c", "z"}}));
+}
+
+BOOST_AUTO_TEST_CASE(join_unchanged)
+{
+	InvertibleMap<string, string> m;
+	m.set("a", "x");
+	m.set("b", "y");
+	size_t checkpoint = m.checkpoint();
+	m.joinWithCheckpoint(checkpoint);
+	BOOST_CHECK(m.values == (map<string, string>{{"a", "x"}, {"b", "y"}}));
+}
+
+BOOST_AUTO_TEST_CASE(join_removes_new_and_changed_keys)
+{
+	InvertibleMap<string, string> m;
+	m.set("a", "x");
+	m.set("b", "y");
+	m.set("c", "z");
+	size_t checkpoint = m.checkpoint();
+	m.set("a", "w");
+	// Changed and changed back: retained.
+	m.set("b", "w");
+	m.set("b", "y");
+	m.set("d", "x");
+	m.joinWithCheckpoint(checkpoint);
+	BOOST_CHECK(m.values == (map<string, string>{{"b", "y"}, {"c", "z"}}));
+}
+
+BOOST_AUTO_TEST_CASE(join_after_clear)
+{
+	InvertibleMap<string, string> m;
+	m.set("a", "x");
+	m.set("b", "y");
+	size_t checkpoint = m.checkpoint();
+	m.clear();
+	m.set("a", "x");
+	m.set("b", "z");
+	m.joinWithCheckpoint(checkpoint);
+	BOOST_CHECK(m.values == (map<string, string>{{"a", "x"}}));
+}
+
+BOOST_AUTO_TEST_CASE(nested_checkpoints)
+{
+	InvertibleMap<string, string> m;
+	m.set("a", "x");
+	m.set("b", "y");
+	size_t outer = m.checkpoint();
+	m.set("c", "z");
+	size_t inner = m.checkpoint();
+	m.set("c", "w");
+	m.eraseKey("a");
+	m.joinWithCheckpoint(inner);
+	BOOST_CHECK(m.values == (map<string, string>{{"b", "y"}}));
+	m.set("a", "x");
+	m.joinWithCheckpoint(outer);
+	BOOST_CHECK(m.values == (map<string, string>{{"a", "x"}, {"b", "y"}}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -23,6 +23,8 @@
 
 #include <test/Options.h>
 
+#include <sstream>
+
 using namespace std;
 
 namespace dev
@@ -69,6 +71,32 @@ BOOST_AUTO_TEST_CASE(json_compact_print)
 	BOOST_CHECK("{\"1\":1,\"2\":\"2\",\"3\":{\"3.1\":\"3.1\",\"3.2\":2}}" == jsonCompactPrint(json));
 }
 
+BOOST_AUTO_TEST_CASE(json_stream_writer)
+{
+	Json::Value json;
+	json["1"] = 1;
+	json["2"]["2.1"]["2.1.1"] = "2.1.1";
+	json["2"]["2.1"]["2.1.2"] = Json::arrayValue;
+	json["2"]["2.2"] = 2;
+	json["3"] = Json::objectValue;
+	json["4"]["\"4.1\""] = 4;
+
+	stringstream stream;
+	JsonStreamWriter writer(stream);
+	writer.write({"1"}, json["1"]);
+	writer.write({"2", "2.1", "2.1.1"}, json["2"]["2.1"]["2.1.1"]);
+	writer.write({"2", "2.1", "2.1.2"}, json["2"]["2.1"]["2.1.2"]);
+	writer.write({"2", "2.2"}, json["2"]["2.2"]);
+	writer.write({"3"}, json["3"]);
+	writer.write({"4", "\"4.1\""}, json["4"]["\"4.1\""]);
+	writer.finish();
+	BOOST_CHECK_EQUAL(stream.str(), jsonCompactPrint(json));
+
+	stringstream empty;
+	JsonStreamWriter(empty).finish();
+	BOOST_CHECK_EQUAL(empty.str(), "{}");
+}
+
 BOOST_AUTO_TEST_CASE(parse_json_not_strict)
 {
 	Json::Value json;
@@ -148,6 +148,27 @@ BOOST_AUTO_TEST_CASE(all_assembly_items)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(tag_table)
+{
+	Assembly _assembly;
+	AssemblyItem tag1 = _assembly.newTag();
+	AssemblyItem tag2 = _assembly.newTag();
+	AssemblyItem table = _assembly.newTagTable({tag2, tag1, tag2});
+	_assembly.append(table);
+	_assembly.append(u256(0));
+	_assembly.append(Instruction::MSTORE);
+	_assembly.append(tag1);
+	_assembly.append(tag2);
+
+	// The table contains the positions of the jumpdests in two bytes each.
+	BOOST_CHECK_EQUAL(
+		_assembly.assemble().toHex(),
+		"6008600052" "5b" "5b" "fe" "0006" "0005" "0006"
+	);
+	string tableName = "data_" + toHex(u256(table.data()));
+	BOOST_CHECK(_assembly.assemblyString().find(tableName + " tags tag_2 tag_1 tag_2") != string::npos);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
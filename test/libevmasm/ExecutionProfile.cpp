@@ -0,0 +1,100 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Tests for execution profiles.
+ */
+
+#include <libevmasm/ExecutionProfile.h>
+#include <libevmasm/Exceptions.h>
+
+#include <libdevcore/JSON.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace langutil;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+	Json::Value parse(string const& _json)
+	{
+		Json::Value result;
+		BOOST_REQUIRE(jsonParseStrict(_json, result));
+		return result;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(ExecutionProfileTest)
+
+BOOST_AUTO_TEST_CASE(innermost_range)
+{
+	ExecutionProfile profile = ExecutionProfile::fromJson(parse(R"({
+		"a.sol": { "0:100": 5, "10:20": 1000, "40:10": 0 }
+	})"));
+	auto a = make_shared<CharStream>("", "a.sol");
+	auto b = make_shared<CharStream>("", "b.sol");
+
+	BOOST_CHECK_EQUAL(profile.executions({0, 100, a}, 200), 5);
+	BOOST_CHECK_EQUAL(profile.executions({12, 20, a}, 200), 1000);
+	BOOST_CHECK_EQUAL(profile.executions({40, 50, a}, 200), 0);
+	// Not fully contained in the inner ranges.
+	BOOST_CHECK_EQUAL(profile.executions({25, 45, a}, 200), 5);
+	BOOST_CHECK_EQUAL(profile.executions({90, 110, a}, 200), 200);
+	BOOST_CHECK_EQUAL(profile.executions({12, 20, b}, 200), 200);
+	BOOST_CHECK_EQUAL(profile.executions({12, 20, nullptr}, 200), 200);
+	BOOST_CHECK_EQUAL(profile.executions({}, 200), 200);
+}
+
+BOOST_AUTO_TEST_CASE(json_round_trip)
+{
+	Json::Value json = parse(R"({ "a.sol": { "10:20": 1000, "0:100": 5 }, "b.sol": {} })");
+	ExecutionProfile profile = ExecutionProfile::fromJson(json);
+	BOOST_CHECK(ExecutionProfile::fromJson(profile.toJson()) == profile);
+	BOOST_CHECK(ExecutionProfile::fromJson(parse(R"({ "a.sol": { "10:20": 1000 } })")) != profile);
+}
+
+BOOST_AUTO_TEST_CASE(invalid)
+{
+	for (char const* json: {
+		R"([])",
+		R"({ "a.sol": 1 })",
+		R"({ "a.sol": { "10": 1 } })",
+		R"({ "a.sol": { "10:": 1 } })",
+		R"({ "a.sol": { "-1:10": 1 } })",
+		R"({ "a.sol": { "1:2:3": 1 } })",
+		R"({ "a.sol": { "1:2": -1 } })",
+		R"({ "a.sol": { "1:2": "many" } })"
+	})
+		BOOST_CHECK_THROW(ExecutionProfile::fromJson(parse(json)), InvalidExecutionProfile);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
@@ -27,6 +27,9 @@
 #include <libevmasm/JumpdestRemover.h>
 #include <libevmasm/ControlFlowGraph.h>
 #include <libevmasm/BlockDeduplicator.h>
+#include <libevmasm/JumpThreader.h>
+#include <libevmasm/ConstantOptimiser.h>
+#include <libevmasm/ExecutionProfile.h>
 #include <libevmasm/Assembly.h>
 
 #include <boost/test/unit_test.hpp>
@@ -112,6 +115,24 @@ namespace
 		AssemblyItems output = CFG(_input);
 		BOOST_CHECK_EQUAL_COLLECTIONS(_expectation.begin(), _expectation.end(), output.begin(), output.end());
 	}
+
+	/// Gives access to the search of the ComputeMethod, bypassing the cache.
+	class ComputeMethodTester: public ComputeMethod
+	{
+	public:
+		using ComputeMethod::Params;
+		using ComputeMethod::ComputeMethod;
+		using ComputeMethod::gasNeeded;
+
+		AssemblyItems const& routine() const { return m_routine; }
+		/// Searches for a representation of @a _value without using any stored results.
+		AssemblyItems search(u256 const& _value, unsigned _depth = c_maxDepth)
+		{
+			m_representations.clear();
+			m_maxSteps = 10000;
+			return findRepresentation(_value, _depth);
+		}
+	};
 }
 
 BOOST_AUTO_TEST_SUITE(Optimiser)
@@ -1158,6 +1179,234 @@ BOOST_AUTO_TEST_CASE(jumpdest_removal_subassemblies)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(jump_threading)
+{
+	AssemblyItems items{
+		u256(1),
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMPI,
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		AssemblyItem(PushTag, 3),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		AssemblyItem(Tag, 4),
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 3),
+		u256(0),
+		Instruction::DUP1,
+		Instruction::RETURN
+	};
+	// All jumps go to tag 3 directly and the returning block is moved behind the first jump.
+	AssemblyItems expectation{
+		u256(1),
+		AssemblyItem(PushTag, 3),
+		Instruction::JUMPI,
+		AssemblyItem(PushTag, 3),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 3),
+		u256(0),
+		Instruction::DUP1,
+		Instruction::RETURN,
+		AssemblyItem(Tag, 1),
+		AssemblyItem(PushTag, 3),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		AssemblyItem(Tag, 4),
+		AssemblyItem(PushTag, 3),
+		Instruction::JUMP
+	};
+	JumpThreader threader(items);
+	BOOST_REQUIRE(threader.optimise());
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+	BOOST_CHECK(!JumpThreader(items).optimise());
+}
+
+BOOST_AUTO_TEST_CASE(jump_threading_endless_loop)
+{
+	AssemblyItems items{
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		AssemblyItem(PushTag, 2),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 2),
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP
+	};
+	AssemblyItems expectation = items;
+	JumpThreader threader(items);
+	BOOST_CHECK(!threader.optimise());
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(block_layout_keeps_fall_through)
+{
+	// The block at tag 1 is entered by falling through and the last block runs off the
+	// end of the code, so neither of them can be moved.
+	AssemblyItems items{
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP,
+		u256(7),
+		AssemblyItem(Tag, 1),
+		u256(0),
+		Instruction::DUP1,
+		Instruction::REVERT,
+		AssemblyItem(Tag, 2),
+		u256(8),
+		AssemblyItem(PushTag, 3),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 3),
+		u256(9)
+	};
+	AssemblyItems expectation = items;
+	JumpThreader threader(items);
+	BOOST_CHECK(!threader.optimise());
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(jump_threading_tags_referenced_from_outside)
+{
+	// Tag t1 is referenced from the super-assembly, so its block has to stay even though
+	// the only jump inside the sub-assembly is threaded through it.
+	Assembly main;
+	AssemblyPointer sub = make_shared<Assembly>();
+
+	auto t1 = sub->newTag();
+	auto t2 = sub->newTag();
+	sub->append(Instruction::CALLVALUE);
+	sub->append(t1.pushTag());
+	sub->append(Instruction::JUMPI);
+	sub->append(u256(0));
+	sub->append(Instruction::DUP1);
+	sub->append(Instruction::REVERT);
+	sub->append(t2);
+	sub->append(u256(2));
+	sub->append(Instruction::DUP1);
+	sub->append(Instruction::RETURN);
+	sub->append(t1);
+	sub->append(t2.pushTag());
+	sub->append(Instruction::JUMP);
+
+	size_t subId = size_t(main.appendSubroutine(sub).data());
+	main.append(t1.toSubAssemblyTag(subId));
+
+	Assembly::OptimiserSettings settings;
+	settings.runJumpdestRemover = true;
+	settings.runPeephole = true;
+	settings.runDeduplicate = true;
+	settings.evmVersion = dev::test::Options::get().evmVersion();
+	main.optimise(settings);
+
+	AssemblyItems expectationSub{
+		Instruction::CALLVALUE, t2.pushTag(), Instruction::JUMPI, u256(0), Instruction::DUP1, Instruction::REVERT,
+		t2.tag(), u256(2), Instruction::DUP1, Instruction::RETURN,
+		t1.tag(), t2.pushTag(), Instruction::JUMP
+	};
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		sub->items().begin(), sub->items().end(),
+		expectationSub.begin(), expectationSub.end()
+	);
+}
+
+BOOST_AUTO_TEST_CASE(cse_across_blocks)
+{
+	// Knowledge about storage is carried over into a block whose tag is only jumped to
+	// from preceding code, unless the tag escapes or is also the target of a later jump.
+	auto optimisedSLoads = [](bool _escapingTag, bool _laterJump)
+	{
+		Assembly assembly;
+		AssemblyItem tag = assembly.newTag();
+		if (_escapingTag)
+		{
+			assembly.append(tag.pushTag());
+			assembly.append(u256(1));
+			assembly.append(Instruction::SSTORE);
+		}
+		assembly.append(u256(5));
+		assembly.append(u256(0));
+		assembly.append(Instruction::SSTORE);
+		assembly.append(Instruction::CALLVALUE);
+		assembly.append(tag.pushTag());
+		assembly.append(Instruction::JUMPI);
+		assembly.append(u256(0));
+		assembly.append(Instruction::DUP1);
+		assembly.append(Instruction::REVERT);
+		assembly.append(tag);
+		assembly.append(u256(0));
+		assembly.append(Instruction::SLOAD);
+		assembly.append(u256(1));
+		assembly.append(Instruction::SSTORE);
+		assembly.append(Instruction::STOP);
+		if (_laterJump)
+		{
+			assembly.append(assembly.newTag());
+			assembly.append(tag.pushTag());
+			assembly.append(Instruction::JUMP);
+		}
+
+		Assembly::OptimiserSettings settings;
+		settings.runCSE = true;
+		settings.evmVersion = dev::test::Options::get().evmVersion();
+		assembly.optimise(settings);
+		return count(assembly.items().begin(), assembly.items().end(), AssemblyItem(Instruction::SLOAD));
+	};
+	BOOST_CHECK_EQUAL(optimisedSLoads(false, false), 0);
+	BOOST_CHECK_EQUAL(optimisedSLoads(true, false), 1);
+	BOOST_CHECK_EQUAL(optimisedSLoads(false, true), 1);
+}
+
+BOOST_AUTO_TEST_CASE(cse_across_blocks_unknown_stack_elements)
+{
+	// The stack elements at tag_1 differ between the two incoming paths, so they must not be
+	// identified with the unknown stack elements at the start of the first block.
+	Assembly assembly;
+	AssemblyItem tag1 = assembly.newTag();
+	AssemblyItem tag2 = assembly.newTag();
+	assembly.append(Instruction::DUP1);
+	assembly.append(u256(7));
+	assembly.append(Instruction::SWAP2);
+	assembly.append(Instruction::CALLVALUE);
+	assembly.append(tag2.pushTag());
+	assembly.append(Instruction::JUMPI);
+	assembly.append(tag1.pushTag());
+	assembly.append(Instruction::JUMP);
+	assembly.append(tag2);
+	assembly.append(u256(8));
+	assembly.append(Instruction::SWAP3);
+	assembly.append(Instruction::POP);
+	assembly.append(tag1.pushTag());
+	assembly.append(Instruction::JUMP);
+	assembly.append(tag1);
+	assembly.append(Instruction::DUP3);
+	assembly.append(Instruction::DUP2);
+	assembly.append(Instruction::SUB);
+	assembly.append(u256(0));
+	assembly.append(Instruction::SSTORE);
+	assembly.append(Instruction::STOP);
+
+	Assembly::OptimiserSettings settings;
+	settings.runCSE = true;
+	settings.evmVersion = dev::test::Options::get().evmVersion();
+	assembly.optimise(settings);
+
+	AssemblyItems const& items = assembly.items();
+	auto lastBlock = find(items.begin(), items.end(), tag1.tag());
+	BOOST_REQUIRE(lastBlock != items.end());
+	BOOST_CHECK(find(lastBlock, items.end(), AssemblyItem(Instruction::SUB)) != items.end());
+}
+
 BOOST_AUTO_TEST_CASE(cse_sub_zero)
 {
 	checkCSE({
@@ -1370,6 +1619,113 @@ BOOST_AUTO_TEST_CASE(cse_replace_too_large_shift)
 	});
 }
 
+BOOST_AUTO_TEST_CASE(constant_optimiser_execution_profile)
+{
+	// Computing 2**255 is cheaper to deploy, but pushing it is cheaper to run.
+	u256 const constant = u256(1) << 255;
+	auto source = make_shared<CharStream>("", "a.sol");
+	auto optimisedItems = [&](ExecutionProfile const* _profile)
+	{
+		Assembly assembly;
+		for (int i = 0; i < 2; ++i)
+		{
+			assembly.setSourceLocation({10 * i, 10 * i + 5, source});
+			assembly.append(constant);
+			assembly.append(u256(i));
+			assembly.append(Instruction::SSTORE);
+		}
+		ConstantOptimisationMethod::optimiseConstants(false, 1, dev::test::Options::get().evmVersion(), assembly, _profile);
+		return assembly.items();
+	};
+	auto pushesConstant = [&](AssemblyItems const& _items)
+	{
+		return find(_items.begin(), _items.end(), AssemblyItem(constant)) != _items.end();
+	};
+
+	BOOST_CHECK(!pushesConstant(optimisedItems(nullptr)));
+
+	ExecutionProfile hot;
+	hot.add("a.sol", 0, 20, 100000);
+	BOOST_CHECK(pushesConstant(optimisedItems(&hot)));
+
+	// Only the source range of the first occurrence is hot, which is still enough on average.
+	ExecutionProfile partiallyHot;
+	partiallyHot.add("a.sol", 0, 5, 100000);
+	BOOST_CHECK(pushesConstant(optimisedItems(&partiallyHot)));
+
+	ExecutionProfile otherSource;
+	otherSource.add("b.sol", 0, 20, 100000);
+	BOOST_CHECK(!pushesConstant(optimisedItems(&otherSource)));
+}
+
+BOOST_AUTO_TEST_CASE(constant_optimiser_repeated_search)
+{
+	// Constants with many candidate decompositions. The result of the search must not
+	// depend on whether it was already performed for another assembly.
+	vector<u256> constants{
+		u256("0x0000000000000000ffffffffffffffff0000000000000000ffffffffffffffff"),
+		u256("0x00000000ffffffff00000000ffffffff00000000ffffffff00000000ffffffff"),
+		u256("0x0000ffff0000ffff0000ffff0000ffff0000ffff0000ffff0000ffff0000ffff"),
+		u256("0x00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff00ff"),
+		u256("0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f"),
+		(u256(1) << 160) - 1,
+		u256(0xa9059cbb) << 224
+	};
+	for (size_t runs: {1, 200, 100000})
+	{
+		auto optimisedItems = [&]()
+		{
+			Assembly assembly;
+			for (u256 const& constant: constants)
+			{
+				assembly.append(constant);
+				assembly.append(Instruction::POP);
+			}
+			ConstantOptimisationMethod::optimiseConstants(false, runs, dev::test::Options::get().evmVersion(), assembly);
+			return assembly.items();
+		};
+		AssemblyItems first = optimisedItems();
+		BOOST_CHECK(first == optimisedItems());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(constant_optimiser_cache)
+{
+	u256 const constant = u256("0x0000000000000000ffffffffffffffff0000000000000000ffffffffffffffff");
+	for (size_t runs: {1, 200, 100000})
+	{
+		ComputeMethodTester::Params params{false, runs, 1, EVMVersion::constantinople()};
+		size_t hits = ComputeMethod::cacheHits();
+		ComputeMethodTester first(params, constant);
+		ComputeMethodTester second(params, constant);
+		BOOST_CHECK_GT(ComputeMethod::cacheHits(), hits);
+
+		AssemblyItems uncached = second.search(constant);
+		BOOST_CHECK(first.routine() == uncached);
+		BOOST_CHECK(second.routine() == uncached);
+		BOOST_CHECK(second.gasNeeded() == second.gasNeeded(uncached));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(constant_optimiser_depth_bound)
+{
+	// 2**240 + 2**160 + 2**80 needs three nested decompositions.
+	u256 const constant = (u256(1) << 240) + (u256(1) << 160) + (u256(1) << 80);
+	// With few runs, the code size dominates and the nested decomposition is the cheapest.
+	ComputeMethodTester::Params params{false, 1, 1, EVMVersion::constantinople()};
+	ComputeMethodTester method(params, constant);
+	AssemblyItems expectation{
+		u256(1), u256(80), Instruction::SHL,
+		u256(1), u256(160), Instruction::SHL,
+		Instruction::ADD,
+		u256(1), u256(240), Instruction::SHL,
+		Instruction::ADD
+	};
+	BOOST_CHECK_EQUAL_COLLECTIONS(method.routine().begin(), method.routine().end(), expectation.begin(), expectation.end());
+	// A deeper search does not find anything better.
+	BOOST_CHECK(method.gasNeeded() == method.gasNeeded(method.search(constant, 16)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -47,6 +47,19 @@ BOOST_AUTO_TEST_CASE(test_fail)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(shared_source)
+{
+	auto const text = std::make_shared<std::string const>("shared source");
+	CharStream first(text, "first");
+	CharStream second(text, "second");
+
+	BOOST_CHECK(first.sharedSource() == text);
+	BOOST_CHECK(&first.source() == &second.source());
+	BOOST_CHECK('h' == first.advanceAndGet());
+	BOOST_CHECK('s' == second.get());
+	BOOST_CHECK_EQUAL(second.lineAtPosition(3), "shared source");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
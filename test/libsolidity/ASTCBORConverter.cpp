@@ -0,0 +1,256 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the CBOR encoding of the AST.
+ */
+
+#include <libsolidity/ast/ASTCBORConverter.h>
+#include <libsolidity/ast/ASTJsonConverter.h>
+#include <libsolidity/interface/CompilerStack.h>
+
+#include <libdevcore/CommonData.h>
+#include <libdevcore/JSON.h>
+
+#include <test/Options.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+/// Decoder for the subset of CBOR produced by the ASTCBORConverter.
+/// Source locations are converted back to strings, so the result can be compared to the JSON AST.
+class CBORDecoder
+{
+public:
+	explicit CBORDecoder(bytes const& _data): m_data(_data) {}
+
+	Json::Value decode()
+	{
+		BOOST_REQUIRE_EQUAL(readHead(6), 256);
+		Json::Value result = readValue();
+		BOOST_CHECK_EQUAL(m_position, m_data.size());
+		return result;
+	}
+
+private:
+	Json::Value readValue()
+	{
+		BOOST_REQUIRE(m_position < m_data.size());
+		uint8_t initial = m_data[m_position];
+		switch (initial >> 5)
+		{
+		case 0:
+			return Json::UInt64(readHead(0));
+		case 1:
+			return Json::Int64(-1 - int64_t(readHead(1)));
+		case 3:
+		case 6:
+			return readString();
+		case 4:
+		{
+			Json::Value array = Json::arrayValue;
+			for (uint64_t size = readHead(4); size > 0; --size)
+				array.append(readValue());
+			return array;
+		}
+		case 5:
+		{
+			Json::Value object = Json::objectValue;
+			for (uint64_t size = readHead(5); size > 0; --size)
+			{
+				string key = readString();
+				Json::Value value = readValue();
+				if (key == "src")
+				{
+					BOOST_REQUIRE(value.isArray() && value.size() == 3);
+					value = value[0].asString() + ":" + value[1].asString() + ":" + value[2].asString();
+				}
+				object[key] = value;
+			}
+			return object;
+		}
+		case 7:
+			m_position++;
+			if (initial == 0xf4)
+				return false;
+			else if (initial == 0xf5)
+				return true;
+			BOOST_REQUIRE_EQUAL(initial, 0xf6);
+			return Json::nullValue;
+		}
+		BOOST_FAIL("Unexpected CBOR type.");
+		return {};
+	}
+
+	string readString()
+	{
+		if (m_data[m_position] >> 5 == 6)
+		{
+			BOOST_REQUIRE_EQUAL(readHead(6), 25);
+			uint64_t index = readHead(0);
+			BOOST_REQUIRE(index < m_stringTable.size());
+			return m_stringTable[index];
+		}
+		uint64_t length = readHead(3);
+		BOOST_REQUIRE(m_position + length <= m_data.size());
+		string result(m_data.begin() + m_position, m_data.begin() + m_position + length);
+		m_position += length;
+		size_t index = m_stringTable.size();
+		if (result.size() >= (index < 24 ? 3 : index < 0x100 ? 4 : index < 0x10000 ? 5 : 7))
+			m_stringTable.push_back(result);
+		return result;
+	}
+
+	uint64_t readHead(uint8_t _expectedType)
+	{
+		BOOST_REQUIRE(m_position < m_data.size());
+		uint8_t initial = m_data[m_position++];
+		BOOST_REQUIRE_EQUAL(initial >> 5, _expectedType);
+		uint8_t additional = initial & 0x1f;
+		if (additional < 24)
+			return additional;
+		BOOST_REQUIRE(additional <= 27);
+		size_t size = size_t(1) << (additional - 24);
+		BOOST_REQUIRE(m_position + size <= m_data.size());
+		uint64_t result = fromBigEndian<uint64_t>(bytesConstRef(m_data.data() + m_position, size));
+		m_position += size;
+		return result;
+	}
+
+	bytes const& m_data;
+	size_t m_position = 0;
+	vector<string> m_stringTable;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(SolidityASTCBORConverter)
+
+BOOST_AUTO_TEST_CASE(encoding)
+{
+	Json::Value json;
+	json["abc"] = "abc";
+	json["ab"] = "ab";
+	json["list"][0] = "abc";
+	json["list"][1] = -2;
+	json["list"][2] = 300;
+	json["list"][3] = Json::nullValue;
+	json["list"][4] = true;
+	json["src"] = "1:-1:0";
+	BOOST_CHECK_EQUAL(
+		toHex(ASTCBORConverter::toCBOR(json)),
+		"d90100" // stringref namespace
+		"a4" // map with 4 entries
+		"626162" "626162" // "ab": "ab" (too short for a reference)
+		"63616263" "d81900" // "abc": reference to "abc"
+		"646c697374" "85" "d81900" "21" "19012c" "f6" "f5" // "list": ["abc", -2, 300, null, true]
+		"63737263" "83" "01" "20" "00" // "src": [1, -1, 0]
+	);
+}
+
+BOOST_AUTO_TEST_CASE(same_as_json)
+{
+	CompilerStack compiler;
+	compiler.setSources({
+		{"a", "pragma solidity >=0.0;\ncontract C { uint x; function f(uint a) public returns (uint) { x = a + 1; return x * 2; } }"},
+		{"b", "pragma solidity >=0.0;\nimport \"a\"; contract D is C { event E(uint indexed); function g() public { emit E(f(3)); } }"}
+	});
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(compiler.parseAndAnalyze());
+	for (string const& source: compiler.sourceNames())
+	{
+		Json::Value json = ASTJsonConverter(false, compiler.sourceIndices()).toJson(compiler.ast(source));
+		bytes cbor = ASTCBORConverter(compiler.sourceIndices()).toCBOR(compiler.ast(source));
+		BOOST_CHECK_EQUAL(jsonCompactPrint(CBORDecoder(cbor).decode()), jsonCompactPrint(json));
+		BOOST_CHECK(cbor.size() < jsonCompactPrint(json).size());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(same_as_json_all_node_types)
+{
+	string const library = R"(
+		pragma solidity >=0.0;
+		pragma experimental ABIEncoderV2;
+		library L { function inc(uint x) internal pure returns (uint) { return x + 1; } }
+	)";
+	string const contract = R"(
+		pragma solidity >=0.0;
+		import "lib" as lib;
+		import {L as M} from "lib";
+		interface I { function f() external; }
+		contract B { constructor(uint) public {} }
+		contract D is B(2) {}
+		/// @title test
+		contract C is B {
+			using M for uint;
+			struct S { uint a; mapping(address => uint[]) b; }
+			enum E { X, Y }
+			event Ev(uint indexed a, bytes32 b) anonymous;
+			S s;
+			uint[3] fixedArray;
+			function(uint) external returns (uint) f;
+			modifier m(uint x) { require(x > 0, "\x41"); _; }
+			constructor() B(1) public {}
+			function g(uint a) public m(a) returns (uint r, bool) {
+				uint[] memory values = new uint[](a);
+				for (uint i = 0; i < a; i++) { if (i == 2) continue; else if (i > 5) break; values[i] = i.inc(); }
+				do { a--; } while (a > 10);
+				while (a > 0) a /= 2;
+				(r, ) = (a == 0 ? 1 ether : 2 finney, true);
+				emit Ev(a, bytes32(0));
+				assembly { let x := a r := add(x, 1) }
+				uint8 small = uint8(-r);
+				s.a = small + fixedArray[0];
+				delete s;
+				return (r, !(r > 1));
+			}
+			function() external payable {}
+		}
+	)";
+	CompilerStack compiler;
+	compiler.setSources({{"lib", library}, {"c", contract}});
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(compiler.parseAndAnalyze());
+	for (string const& source: compiler.sourceNames())
+	{
+		Json::Value json = ASTJsonConverter(false, compiler.sourceIndices()).toJson(compiler.ast(source));
+		bytes cbor = ASTCBORConverter(compiler.sourceIndices()).toCBOR(compiler.ast(source));
+		BOOST_CHECK_EQUAL(jsonCompactPrint(CBORDecoder(cbor).decode()), jsonCompactPrint(json));
+		// Locations, keys and repeated type descriptions make up most of the JSON.
+		BOOST_CHECK_LT(cbor.size() * 3, jsonCompactPrint(json).size() * 2);
+		// The text output is base64-encoded and still smaller than the JSON.
+		BOOST_CHECK_LT(toBase64(cbor).size(), jsonCompactPrint(json).size());
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
@@ -19,10 +19,16 @@
  */
 
 #include <test/libsolidity/SolidityExecutionFramework.h>
+#include <libdevcore/Keccak256.h>
 #include <libdevcore/SwarmHash.h>
 #include <libevmasm/GasMeter.h>
+#include <libyul/AssemblyStack.h>
 
+#include <boost/algorithm/string/replace.hpp>
+
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 
 using namespace std;
 using namespace langutil;
@@ -168,6 +174,80 @@ BOOST_AUTO_TEST_CASE(single_callvaluecheck)
 	BOOST_CHECK_EQUAL(bytecodeSizePayable - bytecodeSizeNonpayable, 26);
 }
 
+BOOST_AUTO_TEST_CASE(jump_table_dispatch)
+{
+	string sourceCode = "contract C {\n";
+	for (size_t i = 0; i < 60; ++i)
+		sourceCode += "\tfunction f" + to_string(i) + "() public pure returns (uint) { return " + to_string(i) + "; }\n";
+	sourceCode += "}\n";
+
+	auto callCosts = [&](size_t _runs) {
+		m_optimiserSettings.expectedExecutionsPerDeployment = _runs;
+		compileAndRun(sourceCode);
+		vector<u256> costs;
+		for (size_t i = 0; i < 60; ++i)
+		{
+			string signature = "f" + to_string(i) + "()";
+			BOOST_CHECK(callContractFunction(signature) == encodeArgs(i));
+			// Exclude the cost of the transaction data, which depends on the function identifier.
+			costs.push_back(m_gasUsed - GasMeter::dataGas(FixedHash<4>(dev::keccak256(signature)).asBytes(), false));
+		}
+		return costs;
+	};
+	// The selector tree is used for the default number of runs, the jump table for many runs.
+	vector<u256> treeCosts = callCosts(200);
+	vector<u256> tableCosts = callCosts(100000);
+
+	u256 treeTotal = accumulate(treeCosts.begin(), treeCosts.end(), u256(0));
+	u256 tableTotal = accumulate(tableCosts.begin(), tableCosts.end(), u256(0));
+	u256 treeSpread = *max_element(treeCosts.begin(), treeCosts.end()) - *min_element(treeCosts.begin(), treeCosts.end());
+	u256 tableSpread = *max_element(tableCosts.begin(), tableCosts.end()) - *min_element(tableCosts.begin(), tableCosts.end());
+	BOOST_TEST_MESSAGE("Average call cost: " + (treeTotal / 60).str() + " (tree), " + (tableTotal / 60).str() + " (table)");
+	// Calls are cheaper by at least 50 gas on average.
+	BOOST_CHECK_LE(tableTotal + 50 * 60, treeTotal);
+	// The cost only depends on the position inside the bucket, not on the number of functions.
+	BOOST_CHECK_LT(tableSpread, treeSpread);
+	BOOST_CHECK_LE(tableSpread, 3 * 22);
+}
+
+BOOST_AUTO_TEST_CASE(loop_invariant_code_motion)
+{
+	// The loop runs in the constructor of a Yul object. Since only the number of iterations
+	// differs between the deployments, the difference in gas is the cost of the iterations.
+	auto iterationCosts = [&](string const& _sourceCode, OptimiserSettings const& _settings) {
+		auto gasUsed = [&](size_t _iterations) {
+			string source = boost::algorithm::replace_all_copy(_sourceCode, "ITERATIONS", to_string(_iterations));
+			yul::AssemblyStack stack(Options::get().evmVersion(), yul::AssemblyStack::Language::StrictAssembly, _settings);
+			BOOST_REQUIRE(stack.parseAndAnalyze("", source));
+			stack.optimize();
+			sendMessage(stack.assemble(yul::AssemblyStack::Machine::EVM).bytecode->bytecode, true);
+			BOOST_REQUIRE(m_transactionSuccessful);
+			return m_gasUsed;
+		};
+		return (gasUsed(20) - gasUsed(10)) / 10;
+	};
+	string invariantInLoop = R"({
+		let a := calldataload(0)
+		let s := 0
+		for { let i := 0 } lt(i, ITERATIONS) { i := add(i, 1) } { s := add(s, mul(a, exp(a, 3))) }
+		sstore(0, s)
+	})";
+	string invariantHoisted = R"({
+		let a := calldataload(0)
+		let t := mul(a, exp(a, 3))
+		let s := 0
+		for { let i := 0 } lt(i, ITERATIONS) { i := add(i, 1) } { s := add(s, t) }
+		sstore(0, s)
+	})";
+
+	u256 unoptimised = iterationCosts(invariantInLoop, OptimiserSettings::minimal());
+	u256 optimised = iterationCosts(invariantInLoop, OptimiserSettings::full());
+	BOOST_TEST_MESSAGE("Cost per iteration: " + unoptimised.str() + " (unoptimised), " + optimised.str() + " (optimised)");
+	// The invariant is moved out of the loop and stays there, which saves at least the exp.
+	BOOST_CHECK_EQUAL(optimised, iterationCosts(invariantHoisted, OptimiserSettings::full()));
+	BOOST_CHECK_LE(optimised + 60, unoptimised);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -0,0 +1,403 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the SMT solver portfolio, using mock solvers.
+ */
+
+#include <libsolidity/formal/SMTPortfolio.h>
+
+#include <libdevcore/CommonData.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace dev::solidity::smt;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+string toString(Expression const& _expr)
+{
+	string result = _expr.name();
+	if (!_expr.arguments().empty())
+	{
+		result += "(";
+		for (size_t i = 0; i < _expr.arguments().size(); ++i)
+			result += (i ? " " : "") + toString(_expr.arguments()[i]);
+		result += ")";
+	}
+	return result;
+}
+
+/// Solver that records the queries it is asked and answers them using a callback
+/// that gets the sorted assertions of the query.
+class MockSolver: public SolverInterface
+{
+public:
+	explicit MockSolver(function<CheckResult(vector<string> const&)> _answer = {}): m_answer(std::move(_answer)) {}
+
+	void reset() override { m_assertions = {{}}; }
+	void push() override { m_assertions.emplace_back(); }
+	void pop() override { m_assertions.pop_back(); }
+	void declareVariable(string const&, Sort const&) override {}
+	void addAssertion(Expression const& _expr) override
+	{
+		m_assertions.back().push_back(toString(_expr));
+		++addedAssertions;
+	}
+	pair<CheckResult, vector<string>> check(vector<Expression> const& _expressionsToEvaluate) override
+	{
+		vector<string> assertions;
+		for (auto const& level: m_assertions)
+			assertions += level;
+		sort(assertions.begin(), assertions.end());
+		queries.push_back(assertions);
+		CheckResult result = m_answer ? m_answer(assertions) : CheckResult::SATISFIABLE;
+		return {result, vector<string>(_expressionsToEvaluate.size(), "0")};
+	}
+
+	/// Sorted assertions of all queries so far.
+	vector<vector<string>> queries;
+	/// Number of calls to addAssertion so far.
+	size_t addedAssertions = 0;
+	/// Number of assertion levels (including the base level) currently on the solver.
+	size_t levels() const { return m_assertions.size(); }
+
+private:
+	function<CheckResult(vector<string> const&)> m_answer;
+	vector<vector<string>> m_assertions{{}};
+};
+
+/// Signal that solvers running in different threads can wait for.
+class Latch
+{
+public:
+	void open()
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_open = true;
+		m_opened.notify_all();
+	}
+	void wait()
+	{
+		unique_lock<mutex> lock(m_mutex);
+		m_opened.wait(lock, [&]() { return m_open; });
+	}
+
+private:
+	mutex m_mutex;
+	condition_variable m_opened;
+	bool m_open = false;
+};
+
+/// Solver with a fixed answer. It can wait for @a _waitFor before answering
+/// and opens @a _answered right before it returns.
+class ScriptedSolver: public MockSolver
+{
+public:
+	ScriptedSolver(CheckResult _result, string _value, Latch* _waitFor = nullptr, Latch* _answered = nullptr):
+		m_result(_result), m_value(std::move(_value)), m_waitFor(_waitFor), m_answered(_answered)
+	{}
+
+	pair<CheckResult, vector<string>> check(vector<Expression> const& _expressionsToEvaluate) override
+	{
+		if (m_waitFor)
+			m_waitFor->wait();
+		if (m_answered)
+			m_answered->open();
+		return {m_result, vector<string>(_expressionsToEvaluate.size(), m_value)};
+	}
+	void interrupt() override { ++interrupts; }
+
+	atomic<unsigned> interrupts{0};
+
+private:
+	CheckResult m_result;
+	string m_value;
+	Latch* m_waitFor;
+	Latch* m_answered;
+};
+
+/// Solver that does not answer until it is interrupted. Like real solvers, it only
+/// notices interrupts after it started searching, which here is only after the first interrupt.
+class InterruptibleSolver: public MockSolver
+{
+public:
+	pair<CheckResult, vector<string>> check(vector<Expression> const&) override
+	{
+		started.open();
+		unique_lock<mutex> lock(m_mutex);
+		m_interrupted.wait(lock, [&]() { return interrupts >= 2; });
+		return {CheckResult::UNKNOWN, {}};
+	}
+	void interrupt() override
+	{
+		lock_guard<mutex> lock(m_mutex);
+		++interrupts;
+		m_interrupted.notify_all();
+	}
+
+	Latch started;
+	unsigned interrupts = 0;
+
+private:
+	mutex m_mutex;
+	condition_variable m_interrupted;
+};
+
+Expression intVariable(SolverInterface& _solver, string const& _name)
+{
+	return _solver.newVariable(_name, make_shared<Sort>(Kind::Int));
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(SMTPortfolioTest)
+
+BOOST_AUTO_TEST_CASE(interrupt_before_search_is_not_lost)
+{
+	auto interruptible = make_unique<InterruptibleSolver>();
+	InterruptibleSolver const& interruptibleRef = *interruptible;
+	vector<unique_ptr<SolverInterface>> solvers;
+	// The first solver only answers once the second one is running, so that it has to be interrupted.
+	solvers.emplace_back(make_unique<ScriptedSolver>(CheckResult::SATISFIABLE, "1", &interruptible->started));
+	solvers.emplace_back(std::move(interruptible));
+	SMTPortfolio portfolio(std::move(solvers));
+
+	Expression x = intVariable(portfolio, "x");
+	portfolio.addAssertion(x > 0);
+	// The first interrupt is ignored by the solver, so it has to be repeated.
+	auto result = portfolio.check({x});
+	BOOST_CHECK(result.first == CheckResult::SATISFIABLE);
+	BOOST_CHECK(result.second == vector<string>{"1"});
+	BOOST_CHECK_GE(interruptibleRef.interrupts, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(first_solver_has_priority)
+{
+	Latch secondAnswered;
+	vector<unique_ptr<SolverInterface>> solvers;
+	solvers.emplace_back(make_unique<ScriptedSolver>(CheckResult::UNSATISFIABLE, "1", &secondAnswered));
+	solvers.emplace_back(make_unique<ScriptedSolver>(CheckResult::SATISFIABLE, "2", nullptr, &secondAnswered));
+	auto const& first = dynamic_cast<ScriptedSolver const&>(*solvers.front());
+	SMTPortfolio portfolio(std::move(solvers));
+
+	Expression x = intVariable(portfolio, "x");
+	portfolio.addAssertion(x > 0);
+	// The second solver answers first, but the answer of the first solver is used
+	// and the first solver is not interrupted.
+	auto result = portfolio.check({x});
+	BOOST_CHECK(result.first == CheckResult::UNSATISFIABLE);
+	BOOST_CHECK(result.second == vector<string>{"1"});
+	BOOST_CHECK_EQUAL(first.interrupts.load(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(lower_priority_answers_are_ignored)
+{
+	Latch firstAnswered;
+	vector<unique_ptr<SolverInterface>> solvers;
+	solvers.emplace_back(make_unique<ScriptedSolver>(CheckResult::UNKNOWN, "1", nullptr, &firstAnswered));
+	solvers.emplace_back(make_unique<ScriptedSolver>(CheckResult::SATISFIABLE, "2", &firstAnswered));
+	solvers.emplace_back(make_unique<ScriptedSolver>(CheckResult::UNSATISFIABLE, "3"));
+	SMTPortfolio portfolio(std::move(solvers));
+
+	Expression x = intVariable(portfolio, "x");
+	portfolio.addAssertion(x > 0);
+	// Whether the third solver finishes before it is interrupted does not matter.
+	auto result = portfolio.check({x});
+	BOOST_CHECK(result.first == CheckResult::SATISFIABLE);
+	BOOST_CHECK(result.second == vector<string>{"2"});
+}
+
+BOOST_AUTO_TEST_CASE(no_solver_answers)
+{
+	vector<unique_ptr<SolverInterface>> solvers;
+	solvers.emplace_back(make_unique<ScriptedSolver>(CheckResult::ERROR, "1"));
+	solvers.emplace_back(make_unique<ScriptedSolver>(CheckResult::UNKNOWN, "2"));
+	solvers.emplace_back(make_unique<ScriptedSolver>(CheckResult::ERROR, "3"));
+	vector<ScriptedSolver const*> scripted;
+	for (auto const& solver: solvers)
+		scripted.push_back(dynamic_cast<ScriptedSolver const*>(solver.get()));
+	SMTPortfolio portfolio(std::move(solvers));
+
+	Expression x = intVariable(portfolio, "x");
+	portfolio.addAssertion(x > 0);
+	auto result = portfolio.check({x});
+	BOOST_CHECK(result.first == CheckResult::UNKNOWN);
+	BOOST_CHECK(result.second.empty());
+	for (auto const* solver: scripted)
+		BOOST_CHECK_EQUAL(solver->interrupts.load(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(unsat_core_outside_cone)
+{
+	auto solver = make_unique<MockSolver>([](vector<string> const& _assertions) {
+		bool positive = find(_assertions.begin(), _assertions.end(), ">(y 0)") != _assertions.end();
+		bool negative = find(_assertions.begin(), _assertions.end(), "<(y 0)") != _assertions.end();
+		return positive && negative ? CheckResult::UNSATISFIABLE : CheckResult::SATISFIABLE;
+	});
+	MockSolver const& mock = *solver;
+	vector<unique_ptr<SolverInterface>> solvers;
+	solvers.emplace_back(std::move(solver));
+	SMTPortfolio portfolio(std::move(solvers));
+
+	Expression x = intVariable(portfolio, "x");
+	Expression y = intVariable(portfolio, "y");
+	portfolio.addAssertion(y > 0);
+	portfolio.addAssertion(y < 0);
+	portfolio.push();
+	portfolio.addAssertion(x > 0);
+	BOOST_CHECK(portfolio.check({x}).first == CheckResult::UNSATISFIABLE);
+	vector<vector<string>> expectation{{">(x 0)"}, {"<(y 0)", ">(y 0)"}};
+	BOOST_CHECK(mock.queries == expectation);
+	// The assertions of the last query stay on the solver, one per level.
+	BOOST_CHECK_EQUAL(mock.levels(), size_t(3));
+}
+
+BOOST_AUTO_TEST_CASE(independent_components)
+{
+	auto solver = make_unique<MockSolver>();
+	MockSolver const& mock = *solver;
+	vector<unique_ptr<SolverInterface>> solvers;
+	solvers.emplace_back(std::move(solver));
+	SMTPortfolio portfolio(std::move(solvers));
+
+	Expression a = intVariable(portfolio, "a");
+	Expression b = intVariable(portfolio, "b");
+	Expression c = intVariable(portfolio, "c");
+	Expression x = intVariable(portfolio, "x");
+	portfolio.addAssertion(a > 0);
+	portfolio.addAssertion(b > c);
+	portfolio.addAssertion(c > 0);
+	portfolio.addAssertion(x < 10);
+	portfolio.push();
+	portfolio.addAssertion(x > 0);
+	BOOST_CHECK(portfolio.check({x}).first == CheckResult::SATISFIABLE);
+	// The cone of influence and every other component are checked separately.
+	vector<vector<string>> expectation{{"<(x 10)", ">(x 0)"}, {">(a 0)"}, {">(b c)", ">(c 0)"}};
+	BOOST_CHECK(mock.queries == expectation);
+
+	// The results for the other components are memoised.
+	portfolio.pop();
+	portfolio.push();
+	portfolio.addAssertion(x > 1);
+	BOOST_CHECK(portfolio.check({}).first == CheckResult::SATISFIABLE);
+	expectation.push_back({"<(x 10)", ">(x 1)"});
+	BOOST_CHECK(mock.queries == expectation);
+	BOOST_CHECK_EQUAL(mock.levels(), size_t(3));
+}
+
+BOOST_AUTO_TEST_CASE(no_push_checks_complete_query)
+{
+	auto solver = make_unique<MockSolver>();
+	MockSolver const& mock = *solver;
+	vector<unique_ptr<SolverInterface>> solvers;
+	solvers.emplace_back(std::move(solver));
+	SMTPortfolio portfolio(std::move(solvers));
+
+	Expression x = intVariable(portfolio, "x");
+	Expression y = intVariable(portfolio, "y");
+	portfolio.addAssertion(x > 0);
+	portfolio.addAssertion(y > 0);
+	BOOST_CHECK(portfolio.check({x}).first == CheckResult::SATISFIABLE);
+	vector<vector<string>> expectation{{">(x 0)", ">(y 0)"}};
+	BOOST_CHECK(mock.queries == expectation);
+	BOOST_CHECK_EQUAL(mock.levels(), size_t(3));
+}
+
+BOOST_AUTO_TEST_CASE(model_needs_cone_of_expressions)
+{
+	auto solver = make_unique<MockSolver>([](vector<string> const& _assertions) {
+		bool positive = find(_assertions.begin(), _assertions.end(), ">(x 0)") != _assertions.end();
+		bool negative = find(_assertions.begin(), _assertions.end(), "<(x 0)") != _assertions.end();
+		return positive && negative ? CheckResult::UNSATISFIABLE : CheckResult::SATISFIABLE;
+	});
+	MockSolver const& mock = *solver;
+	vector<unique_ptr<SolverInterface>> solvers;
+	solvers.emplace_back(std::move(solver));
+	SMTPortfolio portfolio(std::move(solvers));
+
+	Expression x = intVariable(portfolio, "x");
+	Expression y = intVariable(portfolio, "y");
+	portfolio.addAssertion(y > 5);
+	portfolio.push();
+	portfolio.addAssertion(x < 0);
+	portfolio.push();
+	portfolio.addAssertion(x > 0);
+	// The expression to evaluate is not needed to show unsatisfiability.
+	BOOST_CHECK(portfolio.check({y}).first == CheckResult::UNSATISFIABLE);
+	vector<vector<string>> expectation{{"<(x 0)", ">(x 0)"}};
+	BOOST_CHECK(mock.queries == expectation);
+
+	// For a model, the cone of influence of the expressions to evaluate is added.
+	portfolio.pop();
+	portfolio.push();
+	portfolio.addAssertion(x < 1);
+	auto result = portfolio.check({y});
+	BOOST_CHECK(result.first == CheckResult::SATISFIABLE);
+	BOOST_CHECK_EQUAL(result.second.size(), size_t(1));
+	expectation.push_back({"<(x 0)", "<(x 1)"});
+	expectation.push_back({"<(x 0)", "<(x 1)", ">(y 5)"});
+	BOOST_CHECK(mock.queries == expectation);
+}
+
+BOOST_AUTO_TEST_CASE(common_prefix_is_kept_on_solver)
+{
+	auto solver = make_unique<MockSolver>();
+	MockSolver const& mock = *solver;
+	vector<unique_ptr<SolverInterface>> solvers;
+	solvers.emplace_back(std::move(solver));
+	SMTPortfolio portfolio(std::move(solvers));
+
+	Expression x = intVariable(portfolio, "x");
+	portfolio.addAssertion(x > 0);
+	portfolio.addAssertion(x < 10);
+	portfolio.push();
+	portfolio.addAssertion(x > 1);
+	BOOST_CHECK(portfolio.check({}).first == CheckResult::SATISFIABLE);
+	BOOST_CHECK_EQUAL(mock.addedAssertions, size_t(3));
+
+	// Only the assertion of the innermost level is replaced.
+	portfolio.pop();
+	portfolio.push();
+	portfolio.addAssertion(x > 2);
+	BOOST_CHECK(portfolio.check({}).first == CheckResult::SATISFIABLE);
+	BOOST_CHECK_EQUAL(mock.addedAssertions, size_t(4));
+	BOOST_CHECK_EQUAL(mock.levels(), size_t(4));
+
+	vector<vector<string>> expectation{{"<(x 10)", ">(x 0)", ">(x 1)"}, {"<(x 10)", ">(x 0)", ">(x 2)"}};
+	BOOST_CHECK(mock.queries == expectation);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
@@ -0,0 +1,162 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the cache of SMT query answers.
+ */
+
+#include <libsolidity/formal/SMTQueryCache.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <string>
+
+using namespace std;
+using namespace dev::solidity::smt;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(SMTQueryCacheTest)
+
+BOOST_AUTO_TEST_CASE(normalise_renames_declared_symbols)
+{
+	string a =
+		"(set-logic QF_UFLIA)\n"
+		"(declare-fun |x_12_0| () Int)\n"
+		"(declare-fun |y_13_0| () Int)\n"
+		"; comment\n"
+		"(assert (> x_12_0   y_13_0))\n"
+		"(check-sat)\n";
+	string b =
+		"(set-logic QF_UFLIA)\n"
+		"(declare-fun |x_20_0| () Int)\n"
+		"(declare-fun |y_21_0| () Int)\n"
+		"(assert (> x_20_0 y_21_0))\n"
+		"(check-sat)\n";
+	BOOST_CHECK_EQUAL(QueryCache::normalise(a), QueryCache::normalise(b));
+	BOOST_CHECK_EQUAL(
+		QueryCache::normalise(a),
+		"(set-logic QF_UFLIA) (declare-fun @v0 () Int) (declare-fun @v1 () Int) (assert (> @v0 @v1)) (check-sat)"
+	);
+	string swapped =
+		"(set-logic QF_UFLIA)\n"
+		"(declare-fun |x_20_0| () Int)\n"
+		"(declare-fun |y_21_0| () Int)\n"
+		"(assert (> y_21_0 x_20_0))\n"
+		"(check-sat)\n";
+	BOOST_CHECK(QueryCache::normalise(a) != QueryCache::normalise(swapped));
+}
+
+BOOST_AUTO_TEST_CASE(only_decisive_answers)
+{
+	QueryCache cache;
+	cache.store("(check-sat)", {CheckResult::UNKNOWN, {}});
+	cache.store("(assert false) (check-sat)", {CheckResult::ERROR, {}});
+	BOOST_CHECK(!cache.lookup("(check-sat)"));
+	cache.store("(check-sat)", {CheckResult::SATISFIABLE, {"1", "true"}});
+	auto answer = cache.lookup("(check-sat)\n");
+	BOOST_REQUIRE(answer);
+	BOOST_CHECK(answer->first == CheckResult::SATISFIABLE);
+	BOOST_CHECK((answer->second == vector<string>{"1", "true"}));
+	BOOST_CHECK_EQUAL(cache.hits(), 1);
+	BOOST_CHECK_EQUAL(cache.misses(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(least_recently_used_evicted)
+{
+	QueryCache cache({}, 2);
+	cache.store("(assert a)", {CheckResult::SATISFIABLE, {}});
+	cache.store("(assert b)", {CheckResult::UNSATISFIABLE, {}});
+	cache.store("(assert c)", {CheckResult::SATISFIABLE, {}});
+	BOOST_CHECK(cache.lookup("(assert a)"));
+	cache.save();
+	BOOST_CHECK_EQUAL(cache.size(), 2);
+	BOOST_CHECK(cache.lookup("(assert a)"));
+	BOOST_CHECK(!cache.lookup("(assert b)"));
+	BOOST_CHECK(cache.lookup("(assert c)"));
+}
+
+BOOST_AUTO_TEST_CASE(persistence)
+{
+	boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+	{
+		QueryCache cache(path.string());
+		BOOST_CHECK_EQUAL(cache.size(), 0);
+		cache.store("(declare-fun |x| () Int) (assert (> x 0))", {CheckResult::SATISFIABLE, {"1"}});
+		cache.store("(assert false)", {CheckResult::UNSATISFIABLE, {}});
+		cache.save();
+	}
+	{
+		QueryCache cache(path.string());
+		BOOST_CHECK_EQUAL(cache.size(), 2);
+		auto answer = cache.lookup("(declare-fun |y| () Int) (assert (> y 0))");
+		BOOST_REQUIRE(answer);
+		BOOST_CHECK(answer->first == CheckResult::SATISFIABLE);
+		BOOST_CHECK((answer->second == vector<string>{"1"}));
+		answer = cache.lookup("(assert false)");
+		BOOST_REQUIRE(answer);
+		BOOST_CHECK(answer->first == CheckResult::UNSATISFIABLE);
+	}
+	boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(corrupt_file)
+{
+	boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+	for (string const& content: {
+		string("{\"version\": 1, \"entr"),
+		string("{\"version\": 1, \"entries\": {\"xyz\": {\"result\": \"sat\"}}}"),
+		string("{\"version\": 1, \"statistics\": {\"hits\": \"many\"}}")
+	})
+	{
+		{
+			ofstream file(path.string());
+			file << content;
+		}
+		QueryCache cache(path.string());
+		BOOST_CHECK_EQUAL(cache.size(), 0);
+		BOOST_CHECK_EQUAL(cache.warnings().size(), 1);
+		cache.store("(assert false)", {CheckResult::UNSATISFIABLE, {}});
+		cache.save();
+		BOOST_CHECK_EQUAL(cache.warnings().size(), 1);
+		BOOST_CHECK_EQUAL(QueryCache(path.string()).size(), 1);
+	}
+	boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(unwritable_file)
+{
+	boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+	QueryCache cache((directory / "cache.json").string());
+	BOOST_CHECK(cache.warnings().empty());
+	cache.store("(assert false)", {CheckResult::UNSATISFIABLE, {}});
+	cache.save();
+	BOOST_CHECK_EQUAL(cache.warnings().size(), 1);
+	BOOST_CHECK(!boost::filesystem::exists(directory));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
@@ -22,6 +22,8 @@
 #include <test/Metadata.h>
 #include <test/Options.h>
 
+#include <libsolidity/codegen/MultiUseYulFunctionCollector.h>
+
 using namespace std;
 
 namespace dev
@@ -53,6 +55,31 @@ BOOST_AUTO_TEST_CASE(does_not_include_creation_time_only_internal_functions)
 	BOOST_CHECK(runtimeBytecode.size() <= 30);
 }
 
+BOOST_AUTO_TEST_CASE(abi_functions_shared_between_contracts)
+{
+	char const* sourceCode = R"(
+		pragma experimental ABIEncoderV2;
+		contract A {
+			function f(uint[] memory a) public pure returns (uint[] memory) { return a; }
+		}
+		contract B {
+			function f(uint[] memory a) public pure returns (uint[] memory) { return a; }
+		}
+	)";
+	BOOST_REQUIRE(success(sourceCode));
+	BOOST_REQUIRE_MESSAGE(compiler().compile(), "Compiling contract failed");
+	BOOST_REQUIRE(compiler().functionLibrary());
+	BOOST_CHECK(compiler().functionLibrary()->size() > 0);
+	BOOST_CHECK(compiler().functionLibrary()->hits() > 0);
+	// Each of the two contracts takes every function at most once from the library
+	// and dependencies are not counted, so there cannot be more hits than functions.
+	BOOST_CHECK(compiler().functionLibrary()->hits() <= compiler().functionLibrary()->size());
+	BOOST_CHECK(
+		dev::test::bytecodeSansMetadata(compiler().runtimeObject("A").bytecode) ==
+		dev::test::bytecodeSansMetadata(compiler().runtimeObject("B").bytecode)
+	);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -3645,6 +3645,27 @@ BOOST_AUTO_TEST_CASE(super_alone)
 	)
 }
 
+BOOST_AUTO_TEST_CASE(jump_table_function_selector)
+{
+	string sourceCode = "contract C {\n\tuint public x;\n";
+	for (size_t i = 0; i < 30; ++i)
+		sourceCode += "\tfunction f" + to_string(i) + "() public returns (uint) { return " + to_string(i) + "; }\n";
+	sourceCode += "\tfunction() external { x++; }\n}\n";
+	// Make the jump table cheaper than the selector tree.
+	m_optimiserSettings.expectedExecutionsPerDeployment = 100000;
+	compileAndRun(sourceCode);
+	for (size_t i = 0; i < 30; ++i)
+		ABI_CHECK(callContractFunction("f" + to_string(i) + "()"), encodeArgs(i));
+	// Unknown functions either end up in an empty bucket or fail the comparison.
+	for (size_t i = 0; i < 10; ++i)
+		ABI_CHECK(callContractFunction("g" + to_string(i) + "()"), encodeArgs());
+	ABI_CHECK(callContractFunction("x()"), encodeArgs(10));
+	// Calldata that is too short for a function identifier.
+	sendMessage(bytes{0x01}, false);
+	BOOST_CHECK(m_transactionSuccessful);
+	ABI_CHECK(callContractFunction("x()"), encodeArgs(11));
+}
+
 BOOST_AUTO_TEST_CASE(fallback_function)
 {
 	char const* sourceCode = R"(
@@ -15547,6 +15568,53 @@ BOOST_AUTO_TEST_CASE(abi_decode_dynamic_array)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(abi_decode_variables_moved_to_memory)
+{
+	// The ABI decoders for fourteen parameters do not fit the stack, so the Yul optimiser
+	// has to move some of their variables to memory. All parameters are combined into
+	// the result to check that none of them got lost.
+	string uintParameters;
+	string bytesParameters;
+	string uintBody;
+	string bytesBody;
+	string uintSignature;
+	string bytesSignature;
+	for (size_t i = 1; i <= 14; ++i)
+	{
+		string separator = i == 1 ? "" : ", ";
+		string name = "a" + to_string(i);
+		uintParameters += separator + "uint " + name;
+		bytesParameters += separator + "bytes memory " + name;
+		uintBody += "r = r * 2 + " + name + ";\n";
+		bytesBody += "r = r * 2 + " + name + ".length;\n";
+		uintSignature += (i == 1 ? "" : ",") + string("uint256");
+		bytesSignature += (i == 1 ? "" : ",") + string("bytes");
+	}
+	string sourceCode =
+		"pragma experimental ABIEncoderV2;\n"
+		"contract C {\n"
+		"function f(" + uintParameters + ") public pure returns (uint r) {\n" + uintBody + "}\n"
+		"function g(" + bytesParameters + ") public pure returns (uint r) {\n" + bytesBody + "}\n"
+		"}\n";
+	m_optimiserSettings = OptimiserSettings::full();
+	compileAndRun(sourceCode);
+
+	bytes arguments;
+	for (size_t i = 1; i <= 14; ++i)
+		arguments += encodeArgs(i);
+	ABI_CHECK(callContractFunctionNoEncoding("f(" + uintSignature + ")", arguments), encodeArgs(32752));
+
+	// The i-th parameter has length i.
+	bytes heads;
+	bytes tails;
+	for (size_t i = 1; i <= 14; ++i)
+	{
+		heads += encodeArgs(14 * 0x20 + tails.size());
+		tails += encodeArgs(i) + bytes(32, uint8_t(i));
+	}
+	ABI_CHECK(callContractFunctionNoEncoding("g(" + bytesSignature + ")", heads + tails), encodeArgs(32752));
+}
+
 BOOST_AUTO_TEST_CASE(write_storage_external)
 {
 	char const* sourceCode = R"(
@@ -19,7 +19,9 @@
  * Unit tests for interface/StandardCompiler.h.
  */
 
+#include <sstream>
 #include <string>
+#include <boost/algorithm/string/replace.hpp>
 #include <boost/test/unit_test.hpp>
 #include <libsolidity/interface/StandardCompiler.h>
 #include <libsolidity/interface/Version.h>
@@ -327,6 +329,56 @@ BOOST_AUTO_TEST_CASE(optimizer_runs_not_an_unsigned_number)
 	BOOST_CHECK(containsError(result, "JSONError", "The \"runs\" setting must be an unsigned number."));
 }
 
+BOOST_AUTO_TEST_CASE(optimizer_profile)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"optimizer": {
+				"enabled": true,
+				"profile": { "fileA": { "13:20": 1000 } }
+			},
+			"outputSelection": {
+				"fileA": { "A": [ "metadata" ] }
+			}
+		},
+		"sources": {
+			"fileA": {
+				"content": "contract A { function f() public {} }"
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsAtMostWarnings(result));
+	Json::Value metadata;
+	BOOST_REQUIRE(jsonParseStrict(result["contracts"]["fileA"]["A"]["metadata"].asString(), metadata));
+	BOOST_CHECK_EQUAL(metadata["settings"]["optimizer"]["profile"]["fileA"]["13:20"].asUInt(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(optimizer_profile_invalid_range)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"optimizer": {
+				"enabled": true,
+				"profile": { "empty": { "13-20": 1000 } }
+			}
+		},
+		"sources": {
+			"empty": {
+				"content": ""
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsError(result, "JSONError", "Invalid source range \"13-20\" in the execution profile of \"empty\"."));
+}
+
 BOOST_AUTO_TEST_CASE(basic_compilation)
 {
 	char const* input = R"(
@@ -1368,6 +1420,115 @@ BOOST_AUTO_TEST_CASE(standard_output_selection_wildcard_multiple_sources)
 	BOOST_REQUIRE(result["sources"]["B"].isObject());
 }
 
+BOOST_AUTO_TEST_CASE(yul_threads_do_not_change_output)
+{
+	string const input = R"(
+	{
+		"language": "Yul",
+		"sources":
+		{
+			"A":
+			{
+				"content": "object \"a\" { code { let s := datasize(\"b\") datacopy(0, dataoffset(\"b\"), s) mstore(s, datasize(\"c\")) return(0, add(s, 32)) } object \"b\" { code { function f(x) -> y { y := add(x, calldataload(x)) } sstore(f(1), f(2)) } object \"d\" { code { mstore(0, 7) } } } object \"c\" { code { function g(x) -> y { y := mul(x, sload(x)) } mstore(g(3), g(4)) return(0, 64) } } }"
+			}
+		},
+		"settings":
+		{
+			"optimizer": { "enabled": true, "details": { "yul": true } },
+			"threads": THREADS,
+			"outputSelection":
+			{
+				"*": { "*": ["evm.bytecode.object", "irOptimized"] }
+			}
+		}
+	}
+	)";
+
+	auto compileWithThreads = [&](string const& _threads) {
+		Json::Value result = compile(boost::replace_first_copy(input, "THREADS", _threads));
+		BOOST_REQUIRE(result["contracts"]["A"]["a"].isObject());
+		return result["contracts"]["A"]["a"];
+	};
+	Json::Value serial = compileWithThreads("1");
+	Json::Value parallel = compileWithThreads("4");
+	BOOST_CHECK(!serial["evm"]["bytecode"]["object"].asString().empty());
+	BOOST_CHECK_EQUAL(serial["evm"]["bytecode"]["object"].asString(), parallel["evm"]["bytecode"]["object"].asString());
+	BOOST_CHECK_EQUAL(serial["irOptimized"].asString(), parallel["irOptimized"].asString());
+
+	Json::Value result = compile(boost::replace_first_copy(input, "THREADS", "0"));
+	BOOST_CHECK(containsError(result, "JSONError", "\"settings.threads\" must be a positive integer."));
+}
+
+BOOST_AUTO_TEST_CASE(streamed_output)
+{
+	// The name of one source is a prefix of the other one, so the order of the
+	// qualified contract names differs from the order of the output.
+	string const input = R"(
+	{
+		"language": "Solidity",
+		"sources":
+		{
+			"a": { "content": "contract C { function f() public { uint x; } } contract D {}" },
+			"a.b": { "content": "contract B {}" }
+		},
+		"settings":
+		{
+			"outputSelection":
+			{
+				"*": { "*": ["abi", "evm.bytecode.object"], "": ["ast"] }
+			}
+		}
+	}
+	)";
+	solidity::StandardCompiler compiler;
+	Json::Value parsedInput;
+	BOOST_REQUIRE(jsonParseStrict(input, parsedInput));
+	Json::Value result = compiler.compile(parsedInput);
+	BOOST_REQUIRE(result["contracts"]["a"]["C"].isObject());
+	BOOST_REQUIRE(result["contracts"]["a"]["D"].isObject());
+	BOOST_REQUIRE(result["contracts"]["a.b"]["B"].isObject());
+	BOOST_REQUIRE(result["errors"].isArray());
+	BOOST_REQUIRE(result["sources"]["a.b"]["ast"].isObject());
+
+	stringstream streamed;
+	compiler.compile(input, streamed);
+	BOOST_CHECK_EQUAL(streamed.str(), jsonCompactPrint(result));
+	BOOST_CHECK_EQUAL(compiler.compile(input), streamed.str());
+
+	stringstream invalid;
+	compiler.compile("1", invalid);
+	Json::Value error;
+	BOOST_REQUIRE(jsonParseStrict(invalid.str(), error));
+	BOOST_CHECK(containsError(error, "JSONError", "* Line 1, Column 1\n  A valid JSON document must be either an array or an object value.\n"));
+}
+
+BOOST_AUTO_TEST_CASE(streamed_output_late_exception)
+{
+	// An exception after the errors have been produced, while producing the sources,
+	// still has to be reported.
+	stringstream streamed;
+	solidity::StandardCompiler::streamOutput([](solidity::StandardCompiler::OutputWriter const& _output) {
+		_output({"contracts", "a", "C"}, Json::objectValue);
+		Json::Value errors = Json::arrayValue;
+		Json::Value warning = Json::objectValue;
+		warning["type"] = "Warning";
+		warning["message"] = "Some warning.";
+		errors.append(warning);
+		_output({"errors"}, errors);
+		_output({"sources", "a"}, Json::objectValue);
+		BOOST_THROW_EXCEPTION(Exception());
+	}, streamed);
+
+	Json::Value result;
+	BOOST_REQUIRE(jsonParseStrict(streamed.str(), result));
+	BOOST_CHECK(result["contracts"]["a"]["C"].isObject());
+	BOOST_CHECK(containsError(result, "Warning", "Some warning."));
+	BOOST_REQUIRE(result["errors"].isArray());
+	BOOST_REQUIRE_EQUAL(result["errors"].size(), 2u);
+	BOOST_CHECK_EQUAL(result["errors"][1]["type"].asString(), "InternalCompilerError");
+	BOOST_CHECK(!result.isMember("sources"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -17,13 +17,13 @@ contract C {
 // optimize-yul: true
 // ----
 // creation:
-//   codeDepositCost: 610600
-//   executionCost: 645
-//   totalCost: 611245
+//   codeDepositCost: 592800
+//   executionCost: 625
+//   totalCost: 593425
 // external:
-//   a(): 429
-//   b(uint256): 884
-//   f1(uint256): 351
+//   a(): 385
+//   b(uint256): 789
+//   f1(uint256): 296
 //   f2(uint256[],string[],uint16,address): infinite
 //   f3(uint16[],string[],uint16,address): infinite
 //   f4(uint32[],string[12],bytes[2][],address): infinite
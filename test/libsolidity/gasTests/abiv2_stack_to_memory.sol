@@ -0,0 +1,47 @@
+pragma experimental ABIEncoderV2;
+
+// The decoder of g does not fit the stack, so the optimiser moves two of its
+// variables to memory. Compare with f, whose decoder fits the stack.
+contract C {
+    function f(uint a1, uint a2, uint a3, uint a4, uint a5, uint a6, uint a7, uint a8, uint a9, uint a10, uint a11, uint a12) public pure returns (uint r) {
+        r = a1;
+        r = r * 2 + a2;
+        r = r * 2 + a3;
+        r = r * 2 + a4;
+        r = r * 2 + a5;
+        r = r * 2 + a6;
+        r = r * 2 + a7;
+        r = r * 2 + a8;
+        r = r * 2 + a9;
+        r = r * 2 + a10;
+        r = r * 2 + a11;
+        r = r * 2 + a12;
+    }
+    function g(uint a1, uint a2, uint a3, uint a4, uint a5, uint a6, uint a7, uint a8, uint a9, uint a10, uint a11, uint a12, uint a13, uint a14) public pure returns (uint r) {
+        r = a1;
+        r = r * 2 + a2;
+        r = r * 2 + a3;
+        r = r * 2 + a4;
+        r = r * 2 + a5;
+        r = r * 2 + a6;
+        r = r * 2 + a7;
+        r = r * 2 + a8;
+        r = r * 2 + a9;
+        r = r * 2 + a10;
+        r = r * 2 + a11;
+        r = r * 2 + a12;
+        r = r * 2 + a13;
+        r = r * 2 + a14;
+    }
+}
+// ====
+// optimize: true
+// optimize-yul: true
+// ----
+// creation:
+//   codeDepositCost: 99800
+//   executionCost: 147
+//   totalCost: 99947
+// external:
+//   f(uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256): 565
+//   g(uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256,uint256): 623
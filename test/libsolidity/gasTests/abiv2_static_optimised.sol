@@ -0,0 +1,19 @@
+pragma experimental ABIEncoderV2;
+
+contract C {
+    function f1(uint[3] memory a, uint16 b, address c) public pure returns (uint, uint16, address) { return (a[0], b, c); }
+    function f2(uint32[4] memory a, bytes32 b) public pure returns (uint32[4] memory, bytes32) { return (a, b); }
+    function f3(uint8 a, int16 b, bool c, address d) public pure returns (uint8, int16, bool, address) { return (a, b, c, d); }
+}
+// ====
+// optimize: true
+// optimize-yul: true
+// ----
+// creation:
+//   codeDepositCost: 162800
+//   executionCost: 208
+//   totalCost: 163008
+// external:
+//   f1(uint256[3],uint16,address): infinite
+//   f2(uint32[4],bytes32): infinite
+//   f3(uint8,int16,bool,address): 636
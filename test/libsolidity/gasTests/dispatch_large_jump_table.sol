@@ -0,0 +1,55 @@
+contract Large {
+    uint public a;
+    uint[] public b;
+    function f1(uint x) public returns (uint) { a = x; b[uint8(msg.data[0])] = x; }
+    function f2(uint x) public returns (uint) { b[uint8(msg.data[1])] = x; }
+    function f3(uint x) public returns (uint) { b[uint8(msg.data[2])] = x; }
+    function f4(uint x) public returns (uint) { b[uint8(msg.data[3])] = x; }
+    function f5(uint x) public returns (uint) { b[uint8(msg.data[4])] = x; }
+    function f6(uint x) public returns (uint) { b[uint8(msg.data[5])] = x; }
+    function f7(uint x) public returns (uint) { b[uint8(msg.data[6])] = x; }
+    function f8(uint x) public returns (uint) { b[uint8(msg.data[7])] = x; }
+    function f9(uint x) public returns (uint) { b[uint8(msg.data[8])] = x; }
+    function f0(uint x) public pure returns (uint) { require(x > 10); }
+    function g1(uint x) public payable returns (uint) { a = x; b[uint8(msg.data[0])] = x; }
+    function g2(uint x) public payable returns (uint) { b[uint8(msg.data[1])] = x; }
+    function g3(uint x) public payable returns (uint) { b[uint8(msg.data[2])] = x; }
+    function g4(uint x) public payable returns (uint) { b[uint8(msg.data[3])] = x; }
+    function g5(uint x) public payable returns (uint) { b[uint8(msg.data[4])] = x; }
+    function g6(uint x) public payable returns (uint) { b[uint8(msg.data[5])] = x; }
+    function g7(uint x) public payable returns (uint) { b[uint8(msg.data[6])] = x; }
+    function g8(uint x) public payable returns (uint) { b[uint8(msg.data[7])] = x; }
+    function g9(uint x) public payable returns (uint) { b[uint8(msg.data[8])] = x; }
+    function g0(uint x) public payable returns (uint) { require(x > 10); }
+}
+// ====
+// optimize: true
+// optimize-runs: 10000
+// ----
+// creation:
+//   codeDepositCost: 290400
+//   executionCost: 331
+//   totalCost: 290731
+// external:
+//   a(): 420
+//   b(uint256): 724
+//   f0(uint256): 290
+//   f1(uint256): 40586
+//   f2(uint256): 20586
+//   f3(uint256): 20564
+//   f4(uint256): 20586
+//   f5(uint256): 20564
+//   f6(uint256): 20564
+//   f7(uint256): 20564
+//   f8(uint256): 20564
+//   f9(uint256): 20564
+//   g0(uint256): 266
+//   g1(uint256): 40540
+//   g2(uint256): 20540
+//   g3(uint256): 20540
+//   g4(uint256): 20540
+//   g5(uint256): 20540
+//   g6(uint256): 20540
+//   g7(uint256): 20540
+//   g8(uint256): 20540
+//   g9(uint256): 20540
@@ -27,29 +27,29 @@ contract Large {
 // optimize-runs: 2
 // ----
 // creation:
-//   codeDepositCost: 260400
+//   codeDepositCost: 257800
 //   executionCost: 300
-//   totalCost: 260700
+//   totalCost: 258100
 // external:
-//   a(): 398
-//   b(uint256): 1105
-//   f0(uint256): 334
-//   f1(uint256): 40874
-//   f2(uint256): 20940
-//   f3(uint256): 21028
-//   f4(uint256): 21006
-//   f5(uint256): 20984
-//   f6(uint256): 20896
-//   f7(uint256): 20676
-//   f8(uint256): 20808
-//   f9(uint256): 20830
-//   g0(uint256): 574
-//   g1(uint256): 40586
-//   g2(uint256): 20674
-//   g3(uint256): 20762
-//   g4(uint256): 20740
-//   g5(uint256): 20828
-//   g6(uint256): 20608
-//   g7(uint256): 20718
-//   g8(uint256): 20696
-//   g9(uint256): 20542
+//   a(): 386
+//   b(uint256): 1075
+//   f0(uint256): 322
+//   f1(uint256): 40849
+//   f2(uint256): 20915
+//   f3(uint256): 21003
+//   f4(uint256): 20981
+//   f5(uint256): 20959
+//   f6(uint256): 20871
+//   f7(uint256): 20651
+//   f8(uint256): 20783
+//   f9(uint256): 20805
+//   g0(uint256): 562
+//   g1(uint256): 40561
+//   g2(uint256): 20649
+//   g3(uint256): 20737
+//   g4(uint256): 20715
+//   g5(uint256): 20803
+//   g6(uint256): 20583
+//   g7(uint256): 20693
+//   g8(uint256): 20671
+//   g9(uint256): 20517
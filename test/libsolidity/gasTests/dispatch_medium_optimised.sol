@@ -14,16 +14,16 @@ contract Medium {
 // optimize-runs: 2
 // ----
 // creation:
-//   codeDepositCost: 140800
-//   executionCost: 183
-//   totalCost: 140983
+//   codeDepositCost: 141200
+//   executionCost: 190
+//   totalCost: 141390
 // external:
-//   a(): 398
-//   b(uint256): 863
-//   f1(uint256): 40654
-//   f2(uint256): 20698
-//   f3(uint256): 20742
-//   g0(uint256): 332
-//   g7(uint256): 20608
-//   g8(uint256): 20586
-//   g9(uint256): 20542
+//   a(): 386
+//   b(uint256): 833
+//   f1(uint256): 40629
+//   f2(uint256): 20673
+//   f3(uint256): 20717
+//   g0(uint256): 320
+//   g7(uint256): 20583
+//   g8(uint256): 20561
+//   g9(uint256): 20517
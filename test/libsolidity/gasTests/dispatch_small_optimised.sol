@@ -9,11 +9,11 @@ contract Small {
 // optimize-runs: 2
 // ----
 // creation:
-//   codeDepositCost: 60400
-//   executionCost: 111
-//   totalCost: 60511
+//   codeDepositCost: 70200
+//   executionCost: 117
+//   totalCost: 70317
 // external:
 //   fallback: 118
-//   a(): 376
-//   b(uint256): 753
-//   f1(uint256): 40588
+//   a(): 364
+//   b(uint256): 723
+//   f1(uint256): 40560
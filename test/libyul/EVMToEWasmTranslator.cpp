@@ -0,0 +1,86 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the translation from EVM dialect to eWasm dialect.
+ */
+
+#include <libyul/backends/wasm/EVMToEWasmTranslator.h>
+#include <libyul/backends/evm/EVMDialect.h>
+#include <libyul/AssemblyStack.h>
+#include <libyul/AsmData.h>
+#include <libyul/Object.h>
+
+#include <libsolidity/interface/OptimiserSettings.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <string>
+
+using namespace std;
+using namespace langutil;
+
+namespace yul
+{
+namespace test
+{
+
+namespace
+{
+
+set<string> translatedFunctions(string const& _source)
+{
+	AssemblyStack stack(EVMVersion{}, AssemblyStack::Language::StrictAssembly, dev::solidity::OptimiserSettings::minimal());
+	BOOST_REQUIRE(stack.parseAndAnalyze("", _source));
+	Object translated = EVMToEWasmTranslator(EVMDialect::strictAssemblyForEVMObjects(EVMVersion{})).run(*stack.parserResult());
+	set<string> functions;
+	for (auto const& statement: translated.code->statements)
+		functions.insert(boost::get<FunctionDefinition>(statement).name.str());
+	return functions;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(EVMToEWasmTranslatorTest)
+
+BOOST_AUTO_TEST_CASE(only_used_polyfill_functions)
+{
+	set<string> functions = translatedFunctions("{ sstore(0, add(calldataload(0), 1)) }");
+	BOOST_CHECK(functions.count("main"));
+	BOOST_CHECK(functions.count("sstore"));
+	BOOST_CHECK(functions.count("calldataload"));
+	// Called by the polyfill of add.
+	BOOST_CHECK(functions.count("add"));
+	BOOST_CHECK(functions.count("add_carry"));
+	BOOST_CHECK(!functions.count("mul"));
+	BOOST_CHECK(!functions.count("keccak256"));
+	BOOST_CHECK(!functions.count("staticcall"));
+}
+
+BOOST_AUTO_TEST_CASE(repeated_translation)
+{
+	string const source = "{ mstore(0, keccak256(0, 32)) }";
+	set<string> functions = translatedFunctions(source);
+	BOOST_CHECK(functions.count("keccak256"));
+	BOOST_CHECK(!functions.count("add"));
+	BOOST_CHECK(translatedFunctions(source) == functions);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -0,0 +1,499 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the binary encoding of eWasm modules.
+ */
+
+#include <libyul/AssemblyStack.h>
+
+#include <libsolidity/interface/OptimiserSettings.h>
+
+#include <libevmasm/LinkerObject.h>
+
+#include <libdevcore/CommonData.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+using namespace dev;
+using namespace langutil;
+
+namespace yul
+{
+namespace test
+{
+
+namespace
+{
+
+MachineAssemblyObject compile(string const& _source)
+{
+	AssemblyStack stack(EVMVersion{}, AssemblyStack::Language::EWasm, dev::solidity::OptimiserSettings::minimal());
+	BOOST_REQUIRE(stack.parseAndAnalyze("", _source));
+	MachineAssemblyObject object = stack.assemble(AssemblyStack::Machine::eWasm);
+	BOOST_REQUIRE(object.bytecode);
+	return object;
+}
+
+uint8_t const i32Type = 0x7f;
+uint8_t const i64Type = 0x7e;
+/// Accepts values of any type when popped from the stack.
+uint8_t const anyType = 0x00;
+
+/**
+ * Decodes a module in the subset of the binary format that is generated and validates
+ * the types of all instructions, including those of embedded sub-modules.
+ */
+class TypeChecker
+{
+public:
+	explicit TypeChecker(bytes const& _code): m_code(_code) {}
+
+	void module()
+	{
+		expect(bytes(m_code.begin(), m_code.begin() + min<size_t>(8, m_code.size())) == fromHex("0061736d01000000"), "Invalid header.");
+		m_pos = 8;
+		while (m_pos < m_code.size())
+		{
+			uint8_t section = byte();
+			size_t size = leb();
+			size_t end = m_pos + size;
+			expect(end <= m_code.size(), "Section too long.");
+			switch (section)
+			{
+			case 0x00:
+			{
+				size_t nameLength = leb();
+				m_pos += nameLength;
+				expect(m_pos <= end, "Invalid custom section.");
+				TypeChecker(bytes(m_code.begin() + m_pos, m_code.begin() + end)).module();
+				m_pos = end;
+				break;
+			}
+			case 0x01:
+				for (size_t count = leb(); count > 0; --count)
+				{
+					expect(byte() == 0x60, "Invalid function type.");
+					size_t parameters = leb();
+					for (size_t i = 0; i < parameters; ++i)
+						expect(byte() == i64Type, "Invalid parameter type.");
+					size_t results = leb();
+					expect(results <= 1, "Multiple results.");
+					if (results)
+						expect(byte() == i64Type, "Invalid result type.");
+					m_types.emplace_back(parameters, results == 1);
+				}
+				break;
+			case 0x03:
+				for (size_t count = leb(); count > 0; --count)
+				{
+					size_t type = leb();
+					expect(type < m_types.size(), "Invalid type index.");
+					m_functions.push_back(m_types[type]);
+				}
+				break;
+			case 0x06:
+				for (size_t count = leb(); count > 0; --count)
+				{
+					expect(byte() == i64Type && byte() == 0x01, "Invalid global type.");
+					expect(byte() == 0x42, "Invalid global initialiser.");
+					signedLeb();
+					expect(byte() == 0x0b, "Invalid global initialiser.");
+					++m_globals;
+				}
+				break;
+			case 0x0a:
+			{
+				size_t count = leb();
+				expect(count == m_functions.size(), "Function and code sections differ.");
+				for (size_t i = 0; i < count; ++i)
+					function(m_functions[i]);
+				break;
+			}
+			default:
+				m_pos = end;
+			}
+			expect(m_pos == end, "Invalid section size.");
+		}
+	}
+
+private:
+	struct Frame
+	{
+		size_t height;
+		bool unreachable;
+		bool returns;
+	};
+
+	void function(pair<size_t, bool> const& _signature)
+	{
+		size_t size = leb();
+		size_t end = m_pos + size;
+		expect(end <= m_code.size(), "Function too long.");
+		m_locals = _signature.first;
+		for (size_t groups = leb(); groups > 0; --groups)
+		{
+			m_locals += leb();
+			expect(byte() == i64Type, "Invalid local type.");
+		}
+		m_frames = {Frame{0, false, _signature.second}};
+		m_stack.clear();
+		while (!m_frames.empty())
+			instruction();
+		expect(m_pos == end, "Invalid function size.");
+	}
+
+	void instruction()
+	{
+		uint8_t opcode = byte();
+		if (opcode == 0x00)
+			unreachable();
+		else if (opcode == 0x01)
+			{}
+		else if (opcode == 0x02 || opcode == 0x03 || opcode == 0x04)
+		{
+			if (opcode == 0x04)
+				pop(i32Type);
+			expect(byte() == 0x40, "Unsupported block type.");
+			m_frames.push_back(Frame{m_stack.size(), false, false});
+		}
+		else if (opcode == 0x05)
+		{
+			endFrame();
+			m_frames.back().unreachable = false;
+		}
+		else if (opcode == 0x0b)
+		{
+			endFrame();
+			m_frames.pop_back();
+		}
+		else if (opcode == 0x0c || opcode == 0x0d)
+		{
+			if (opcode == 0x0d)
+				pop(i32Type);
+			size_t depth = leb();
+			expect(depth < m_frames.size(), "Invalid label.");
+			expect(!m_frames[m_frames.size() - 1 - depth].returns, "Branch to a block with result.");
+			if (opcode == 0x0c)
+				unreachable();
+		}
+		else if (opcode == 0x10)
+		{
+			size_t index = leb();
+			expect(index < m_functions.size(), "Invalid function index.");
+			for (size_t i = 0; i < m_functions[index].first; ++i)
+				pop(i64Type);
+			if (m_functions[index].second)
+				m_stack.push_back(i64Type);
+		}
+		else if (opcode == 0x1a)
+			pop(anyType);
+		else if (opcode == 0x20 || opcode == 0x21)
+		{
+			expect(leb() < m_locals, "Invalid local index.");
+			if (opcode == 0x20)
+				m_stack.push_back(i64Type);
+			else
+				pop(i64Type);
+		}
+		else if (opcode == 0x23 || opcode == 0x24)
+		{
+			expect(leb() < m_globals, "Invalid global index.");
+			if (opcode == 0x23)
+				m_stack.push_back(i64Type);
+			else
+				pop(i64Type);
+		}
+		else if (opcode == 0x29 || opcode == 0x37)
+		{
+			if (opcode == 0x37)
+				pop(i64Type);
+			pop(i32Type);
+			leb();
+			leb();
+			if (opcode == 0x29)
+				m_stack.push_back(i64Type);
+		}
+		else if (opcode == 0x42)
+		{
+			signedLeb();
+			m_stack.push_back(i64Type);
+		}
+		else if (opcode == 0x45)
+			unary(i32Type, i32Type);
+		else if (opcode == 0x50)
+			unary(i64Type, i32Type);
+		else if (0x51 <= opcode && opcode <= 0x5a)
+			binary(i32Type);
+		else if (0x7c <= opcode && opcode <= 0x8a)
+			binary(i64Type);
+		else if (opcode == 0xa7)
+			unary(i64Type, i32Type);
+		else if (opcode == 0xad)
+			unary(i32Type, i64Type);
+		else
+			expect(false, "Unsupported opcode " + toHex(bytes{opcode}) + ".");
+	}
+
+	void unary(uint8_t _argument, uint8_t _result)
+	{
+		pop(_argument);
+		m_stack.push_back(_result);
+	}
+
+	void binary(uint8_t _result)
+	{
+		pop(i64Type);
+		pop(i64Type);
+		m_stack.push_back(_result);
+	}
+
+	void unreachable()
+	{
+		m_stack.resize(m_frames.back().height);
+		m_frames.back().unreachable = true;
+	}
+
+	void endFrame()
+	{
+		expect(!m_frames.empty(), "Unbalanced end.");
+		Frame const& frame = m_frames.back();
+		if (frame.returns)
+			pop(i64Type);
+		expect(m_stack.size() == frame.height, "Values left on the stack at the end of a block.");
+	}
+
+	void pop(uint8_t _type)
+	{
+		Frame const& frame = m_frames.back();
+		if (m_stack.size() == frame.height)
+		{
+			expect(frame.unreachable, "Stack underflow.");
+			return;
+		}
+		expect(_type == anyType || m_stack.back() == _type, "Type mismatch at offset " + to_string(m_pos) + ".");
+		m_stack.pop_back();
+	}
+
+	uint8_t byte()
+	{
+		expect(m_pos < m_code.size(), "Unexpected end of code.");
+		return m_code[m_pos++];
+	}
+
+	uint64_t leb()
+	{
+		uint64_t result = 0;
+		for (size_t shift = 0; ; shift += 7)
+		{
+			uint8_t b = byte();
+			result |= uint64_t(b & 0x7f) << shift;
+			if (!(b & 0x80))
+				return result;
+		}
+	}
+
+	void signedLeb()
+	{
+		while (byte() & 0x80)
+		{}
+	}
+
+	static void expect(bool _condition, string const& _message)
+	{
+		if (!_condition)
+			throw runtime_error(_message);
+	}
+
+	bytes m_code;
+	size_t m_pos = 0;
+	vector<pair<size_t, bool>> m_types;
+	vector<pair<size_t, bool>> m_functions;
+	size_t m_globals = 0;
+	size_t m_locals = 0;
+	vector<Frame> m_frames;
+	vector<uint8_t> m_stack;
+};
+
+/// @returns an empty string if @a _code is a well-typed module and the error otherwise.
+string typeCheck(bytes const& _code)
+{
+	try
+	{
+		TypeChecker(_code).module();
+	}
+	catch (runtime_error const& _error)
+	{
+		return _error.what();
+	}
+	return "";
+}
+
+/// @returns the number of occurrences of @a _needle in @a _haystack.
+size_t count(string const& _haystack, string const& _needle)
+{
+	size_t result = 0;
+	for (size_t pos = _haystack.find(_needle); pos != string::npos; pos = _haystack.find(_needle, pos + 1))
+		++result;
+	return result;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(EWasmToBinaryTest)
+
+BOOST_AUTO_TEST_CASE(functions)
+{
+	MachineAssemblyObject object = compile(R"({
+		function main() { let x := f(1, 2) }
+		function f(a, b) -> r { r := i64.add(a, b) }
+	})");
+	BOOST_CHECK_EQUAL(
+		toHex(object.bytecode->bytecode),
+		// magic and version
+		"0061736d01000000"
+		// types: () -> () and (i64, i64) -> i64
+		"010a0260000060027e7e017e"
+		// functions
+		"0303020001"
+		// memory
+		"0503010001"
+		// exports: memory and main
+		"071102066d656d6f72790200046d61696e0000"
+		// code
+		"0a1c02"
+		"0c01017e42014202100121000b"
+		"0d01017e20002001" "7c" "210220020b"
+	);
+	// The text representation describes the same module.
+	BOOST_CHECK_EQUAL(count(object.assembly, "\n(func "), 2);
+	BOOST_CHECK_EQUAL(count(object.assembly, "(local "), 2);
+	BOOST_CHECK(boost::contains(object.assembly, "(call $f (i64.const 1) (i64.const 2))"));
+	BOOST_CHECK(boost::contains(object.assembly, "(i64.add (get_local $a) (get_local $b))"));
+}
+
+BOOST_AUTO_TEST_CASE(labels)
+{
+	MachineAssemblyObject object = compile(R"({
+		function main() {
+			for { let i := 0 } i64.ne(i, 0) { i := i64.add(i, 1) } { break }
+		}
+	})");
+	bytes const& code = object.bytecode->bytecode;
+	// block $label_ (i := 0) (loop $label__2 (br_if $label_ ...) (block $label__1 (break $label_)) ... (br $label__2))
+	string const body =
+		"0240" "42002100"
+		"0340" "200042005245" "0d01"
+		"0240" "0c02" "0b"
+		"200042017c2100"
+		"0c00"
+		"0b" "0b";
+	BOOST_CHECK(boost::contains(toHex(code), body));
+	BOOST_CHECK_EQUAL(typeCheck(code), "");
+}
+
+BOOST_AUTO_TEST_CASE(comparisons)
+{
+	MachineAssemblyObject object = compile(R"({
+		function main() {
+			let x := i64.load(0)
+			let y := i64.add(i64.lt_u(x, 2), i64.eqz(x))
+			if i64.ne(x, y) { i64.store(8, i64.ge_u(y, x)) }
+			if x { y := f(i64.eq(x, 1)) }
+			switch i64.gt_u(x, y)
+			case 0 { i64.store(16, x) }
+			default { i64.store(16, i64.le_u(y, 7)) }
+		}
+		function f(a) -> r {
+			for { } i64.lt_u(r, a) { r := i64.add(r, 1) } {
+				if i64.eqz(i64.and(r, 1)) { continue }
+				r := i64.shl(r, 1)
+			}
+		}
+	})");
+	bytes const& code = object.bytecode->bytecode;
+	BOOST_CHECK_EQUAL(typeCheck(code), "");
+	// A comparison used as a condition is not converted, one used as a value is extended to i64.
+	BOOST_CHECK(boost::contains(toHex(code), "2000200152" "0440"));
+	BOOST_CHECK(boost::contains(toHex(code), "2000420254ad"));
+	// Other conditions are compared to zero.
+	BOOST_CHECK(boost::contains(toHex(code), "20005045" "0440"));
+	// Memory addresses are i32.
+	BOOST_CHECK(boost::contains(toHex(code), "4200a7" "2903"));
+	// The conversions are part of the module, so the text representation is well-typed as well.
+	string const& text = object.assembly;
+	BOOST_CHECK(boost::contains(text, "(i64.extend_i32_u (i64.lt_u (get_local $x) (i64.const 2)))"));
+	BOOST_CHECK(boost::contains(text, "(if (i64.ne (get_local $x) (get_local $y)) (then"));
+	BOOST_CHECK(boost::contains(text, "(if (i32.eqz (i64.eqz (get_local $x))) (then"));
+	BOOST_CHECK(boost::contains(text, "(br_if $label_ (i32.eqz (i64.lt_u (get_local $r) (get_local $a))))"));
+	BOOST_CHECK(boost::contains(text, "(i64.load (i32.wrap_i64 (i64.const 0)))"));
+	BOOST_CHECK_EQUAL(count(text, "i64.extend_i32_u"), 6);
+}
+
+BOOST_AUTO_TEST_CASE(sub_modules)
+{
+	MachineAssemblyObject inner = compile(R"(
+		object "b" { code { function main() { } } }
+	)");
+	MachineAssemblyObject outer = compile(R"(
+		object "a" {
+			code {
+				function main() {
+					let s1, s2, s3, s4 := datasize("b")
+					let o1, o2, o3, o4 := dataoffset("b")
+					i64.store(o4, s4)
+				}
+			}
+			object "b" { code { function main() { } } }
+		}
+	)");
+	bytes const& innerCode = inner.bytecode->bytecode;
+	bytes const& outerCode = outer.bytecode->bytecode;
+
+	// The sub-module is embedded as a custom section named after the sub-object,
+	// directly after the header.
+	bytes const header = fromHex("0061736d01000000");
+	bytes const sectionStart = header + bytes{0x00, uint8_t(2 + innerCode.size()), 0x01, 'b'};
+	BOOST_REQUIRE(outerCode.size() > sectionStart.size() + innerCode.size());
+	BOOST_CHECK(bytes(outerCode.begin(), outerCode.begin() + sectionStart.size()) == sectionStart);
+	BOOST_CHECK(
+		bytes(outerCode.begin() + sectionStart.size(), outerCode.begin() + sectionStart.size() + innerCode.size()) ==
+		innerCode
+	);
+
+	// datasize and dataoffset refer to the embedded module.
+	string const dataSize = "42" + toHex(bytes{uint8_t(innerCode.size())}) + "2402";
+	string const dataOffset = "42" + toHex(bytes{uint8_t(sectionStart.size())}) + "2402";
+	BOOST_CHECK(boost::contains(toHex(outerCode), dataSize));
+	BOOST_CHECK(boost::contains(toHex(outerCode), dataOffset));
+
+	BOOST_CHECK_EQUAL(typeCheck(innerCode), "");
+	BOOST_CHECK_EQUAL(typeCheck(outerCode), "");
+
+	// The text representation contains both modules.
+	BOOST_CHECK_EQUAL(count(outer.assembly, "(module"), 2);
+	BOOST_CHECK(boost::starts_with(outer.assembly, inner.assembly));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -35,6 +35,7 @@
 #include <libyul/optimiser/FullInliner.h>
 #include <libyul/optimiser/ForLoopConditionIntoBody.h>
 #include <libyul/optimiser/ForLoopInitRewriter.h>
+#include <libyul/optimiser/LoopInvariantCodeMotion.h>
 #include <libyul/optimiser/LoadResolver.h>
 #include <libyul/optimiser/MainFunction.h>
 #include <libyul/optimiser/NameDisplacer.h>
@@ -47,6 +48,7 @@
 #include <libyul/optimiser/RedundantAssignEliminator.h>
 #include <libyul/optimiser/StructuralSimplifier.h>
 #include <libyul/optimiser/StackCompressor.h>
+#include <libyul/optimiser/StackToMemoryMover.h>
 #include <libyul/optimiser/Suite.h>
 #include <libyul/backends/evm/ConstantOptimiser.h>
 #include <libyul/backends/evm/EVMDialect.h>
@@ -100,6 +102,12 @@ YulOptimizerTest::YulOptimizerTest(string const& _filename)
 		m_validatedSettings["step"] = m_settings["step"];
 		m_settings.erase("step");
 	}
+	if (m_settings.count("runs"))
+	{
+		m_runs = stoul(m_settings["runs"]);
+		m_validatedSettings["runs"] = m_settings["runs"];
+		m_settings.erase("runs");
+	}
 
 	m_expectation = parseSimpleExpectations(file);
 }
@@ -145,6 +153,12 @@ TestCase::TestResult YulOptimizerTest::run(ostream& _stream, string const& _line
 		disambiguate();
 		ForLoopInitRewriter{}(*m_ast);
 	}
+	else if (m_optimizerStep == "loopInvariantCodeMotion")
+	{
+		disambiguate();
+		ForLoopInitRewriter{}(*m_ast);
+		LoopInvariantCodeMotion::run(*m_dialect, *m_ast);
+	}
 	else if (m_optimizerStep == "commonSubexpressionEliminator")
 	{
 		disambiguate();
@@ -193,6 +207,17 @@ TestCase::TestResult YulOptimizerTest::run(ostream& _stream, string const& _line
 		FullInliner(*m_ast, nameDispenser).run();
 		ExpressionJoiner::run(*m_ast);
 	}
+	else if (m_optimizerStep == "fullInlinerGasMeter")
+	{
+		disambiguate();
+		(FunctionHoister{})(*m_ast);
+		(FunctionGrouper{})(*m_ast);
+		NameDispenser nameDispenser{*m_dialect, *m_ast};
+		ExpressionSplitter{*m_dialect, nameDispenser}(*m_ast);
+		GasMeter meter(dynamic_cast<EVMDialect const&>(*m_dialect), false, m_runs);
+		FullInliner(*m_ast, nameDispenser, &meter).run();
+		ExpressionJoiner::run(*m_ast);
+	}
 	else if (m_optimizerStep == "mainFunction")
 	{
 		disambiguate();
@@ -308,6 +333,15 @@ TestCase::TestResult YulOptimizerTest::run(ostream& _stream, string const& _line
 		StackCompressor::run(*m_dialect, *m_ast, true, maxIterations);
 		(BlockFlattener{})(*m_ast);
 	}
+	else if (m_optimizerStep == "stackToMemoryMover")
+	{
+		disambiguate();
+		(FunctionGrouper{})(*m_ast);
+		size_t maxIterations = 16;
+		StackCompressor::run(*m_dialect, *m_ast, true, maxIterations);
+		StackToMemoryMover::run(*m_dialect, *m_ast, true, 0x80);
+		(BlockFlattener{})(*m_ast);
+	}
 	else if (m_optimizerStep == "wordSizeTransform")
 	{
 		disambiguate();
@@ -319,6 +353,17 @@ TestCase::TestResult YulOptimizerTest::run(ostream& _stream, string const& _line
 	{
 		GasMeter meter(dynamic_cast<EVMDialect const&>(*m_dialect), false, 200);
 		OptimiserSuite::run(*m_dialect, &meter, *m_ast, *m_analysisInfo, true);
+
+		// The result must not depend on the number of threads.
+		string singleThreadedResult = AsmPrinter{m_yul}(*m_ast);
+		if (!parse(_stream, _linePrefix, _formatted))
+			return TestResult::FatalError;
+		OptimiserSuite::run(*m_dialect, &meter, *m_ast, *m_analysisInfo, true, {}, 4);
+		if (AsmPrinter{m_yul}(*m_ast) != singleThreadedResult)
+		{
+			AnsiColorized(_stream, _formatted, {formatting::BOLD, formatting::RED}) << _linePrefix << "Result differs when run with multiple threads." << endl;
+			return TestResult::Failure;
+		}
 	}
 	else
 	{
@@ -63,6 +63,8 @@ private:
 
 	std::string m_source;
 	bool m_yul = false;
+	/// Expected number of executions per deployment used by steps that require a gas meter.
+	size_t m_runs = 200;
 	std::string m_optimizerStep;
 	std::string m_expectation;
 
@@ -21,24 +21,34 @@
 #include <libevmasm/Assembly.h>
 #include <libevmasm/ConstantOptimiser.h>
 #include <libsolc/libsolc.h>
+#include <libyul/YulString.h>
 
+#include <cstdlib>
+#include <iostream>
+#include <memory>
 #include <sstream>
 
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
+using namespace yul;
 
 void FuzzerUtil::runCompiler(string const& _input, bool _quiet)
 {
 	if (!_quiet)
 		cout << "Input JSON: " << _input << endl;
-	string outputString(solidity_compile(_input.c_str(), nullptr));
+	string outputString;
+	{
+		FuzzerStats::Stage stage("compile");
+		outputString = solidity_compile(_input.c_str(), nullptr);
+	}
 	if (!_quiet)
 		cout << "Output JSON: " << outputString << endl;
 
 	// This should be safe given the above copies the output.
 	solidity_free();
 
+	FuzzerStats::Stage stage("check output");
 	Json::Value output;
 	if (!jsonParseStrict(outputString, output))
 	{
@@ -60,6 +70,7 @@ void FuzzerUtil::runCompiler(string const& _input, bool _quiet)
 				throw std::runtime_error(std::move(msg));
 			}
 		}
+	FuzzerStats::instance().finishExecution();
 }
 
 void FuzzerUtil::testCompiler(string const& _input, bool _optimize, bool _quiet)
@@ -108,18 +119,22 @@ void FuzzerUtil::testConstantOptimizer(string const& _input, bool _quiet)
 			cout << n << endl;
 		assembly.append(n);
 	}
-	for (bool isCreation: {false, true})
-		for (unsigned runs: {1, 2, 3, 20, 40, 100, 200, 400, 1000})
-		{
-			// Make a copy here so that each time we start with the original state.
-			Assembly tmp = assembly;
-			ConstantOptimisationMethod::optimiseConstants(
-					isCreation,
-					runs,
-					langutil::EVMVersion{},
-					tmp
-			);
-		}
+	{
+		FuzzerStats::Stage stage("optimise constants");
+		for (bool isCreation: {false, true})
+			for (unsigned runs: {1, 2, 3, 20, 40, 100, 200, 400, 1000})
+			{
+				// Make a copy here so that each time we start with the original state.
+				Assembly tmp = assembly;
+				ConstantOptimisationMethod::optimiseConstants(
+						isCreation,
+						runs,
+						langutil::EVMVersion{},
+						tmp
+				);
+			}
+	}
+	FuzzerStats::instance().finishExecution();
 }
 
 void FuzzerUtil::testStandardCompiler(string const& _input, bool _quiet)
@@ -129,3 +144,81 @@ void FuzzerUtil::testStandardCompiler(string const& _input, bool _quiet)
 
 	runCompiler(_input, _quiet);
 }
+
+FuzzerStats::Stage::Stage(string _name):
+	m_name(std::move(_name)),
+	m_start(chrono::steady_clock::now())
+{
+}
+
+FuzzerStats::Stage::~Stage()
+{
+	FuzzerStats::instance().addStageTime(m_name, chrono::steady_clock::now() - m_start);
+}
+
+FuzzerStats& FuzzerStats::instance()
+{
+	static FuzzerStats stats;
+	return stats;
+}
+
+FuzzerStats::FuzzerStats():
+	m_start(chrono::steady_clock::now())
+{
+	if (char const* interval = getenv("SOLC_FUZZER_STATS"))
+		m_reportInterval = size_t(max(0l, atol(interval)));
+}
+
+void FuzzerStats::finishExecution()
+{
+	++m_executions;
+	if (m_reportInterval > 0 && m_executions % m_reportInterval == 0)
+		print(cerr);
+}
+
+void FuzzerStats::addStageTime(string const& _stage, chrono::steady_clock::duration _duration)
+{
+	m_stageTimes[_stage] += _duration;
+}
+
+void FuzzerStats::print(ostream& _out) const
+{
+	using seconds = chrono::duration<double>;
+	using microseconds = chrono::duration<double, micro>;
+	double elapsed = chrono::duration_cast<seconds>(chrono::steady_clock::now() - m_start).count();
+	_out << "#" << m_executions << " executions, ";
+	_out << (elapsed > 0 ? double(m_executions) / elapsed : 0.0) << " exec/s" << endl;
+	for (auto const& stage: m_stageTimes)
+	{
+		double total = chrono::duration_cast<seconds>(stage.second).count();
+		_out << "  " << stage.first << ": " << total << " s total";
+		if (m_executions > 0)
+			_out << ", " << chrono::duration_cast<microseconds>(stage.second).count() / m_executions << " us/exec";
+		_out << endl;
+	}
+}
+
+YulFuzzerSession::Input::Input(YulFuzzerSession const&):
+	m_checkpoint(YulStringRepository::checkpoint())
+{
+}
+
+YulFuzzerSession::Input::~Input()
+{
+	YulStringRepository::rollback(m_checkpoint);
+	FuzzerStats::instance().finishExecution();
+}
+
+YulFuzzerSession const& YulFuzzerSession::instance(langutil::EVMVersion _evmVersion)
+{
+	static map<langutil::EVMVersion, unique_ptr<YulFuzzerSession>> sessions;
+	if (!sessions[_evmVersion])
+		sessions[_evmVersion].reset(new YulFuzzerSession(_evmVersion));
+	return *sessions[_evmVersion];
+}
+
+YulFuzzerSession::YulFuzzerSession(langutil::EVMVersion _evmVersion):
+	m_evmVersion(_evmVersion),
+	m_dialect(EVMDialect::strictAssemblyForEVMObjects(_evmVersion))
+{
+}
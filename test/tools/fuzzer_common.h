@@ -15,6 +15,14 @@
 	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <libyul/backends/evm/EVMDialect.h>
+
+#include <liblangutil/EVMVersion.h>
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <ostream>
 #include <string>
 
 /**
@@ -28,3 +36,74 @@ struct FuzzerUtil
 	static void testConstantOptimizer(std::string const& _input, bool _quiet);
 	static void testStandardCompiler(std::string const& _input, bool _quiet);
 };
+
+/**
+ * Execution statistics for in-process (persistent-mode) fuzzing.
+ * Counts executions and accumulates the time spent in each named stage.
+ * If the environment variable SOLC_FUZZER_STATS is set to a positive number n,
+ * a summary is printed to stderr every n executions.
+ */
+class FuzzerStats
+{
+public:
+	/// Measures the time from construction to destruction and adds it to the given stage.
+	class Stage
+	{
+	public:
+		explicit Stage(std::string _name);
+		~Stage();
+	private:
+		std::string m_name;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	static FuzzerStats& instance();
+
+	/// Records the end of one execution and prints a summary if requested.
+	void finishExecution();
+	void addStageTime(std::string const& _stage, std::chrono::steady_clock::duration _duration);
+	void print(std::ostream& _out) const;
+
+private:
+	FuzzerStats();
+
+	std::chrono::steady_clock::time_point m_start;
+	size_t m_executions = 0;
+	size_t m_reportInterval = 0;
+	std::map<std::string, std::chrono::steady_clock::duration> m_stageTimes;
+};
+
+/**
+ * Long-lived state for persistent-mode fuzzing of the Yul targets.
+ * The dialect of the given EVM version (including its builtin names) is created once
+ * and survives all iterations, while the YulStrings introduced by a single input are
+ * discarded when the corresponding Input object goes out of scope.
+ * This replaces YulStringRepository::reset() per input, which also drops (and thus
+ * forces a rebuild of) all dialects. It must not be combined with code that calls
+ * YulStringRepository::reset() itself (like the standard JSON interface).
+ */
+class YulFuzzerSession
+{
+public:
+	/// Scope of a single input. All AST nodes, assembly stacks etc. created for the
+	/// input have to be destroyed before this object.
+	class Input
+	{
+	public:
+		explicit Input(YulFuzzerSession const&);
+		~Input();
+	private:
+		size_t m_checkpoint;
+	};
+
+	static YulFuzzerSession const& instance(langutil::EVMVersion _evmVersion = langutil::EVMVersion());
+
+	langutil::EVMVersion evmVersion() const { return m_evmVersion; }
+	yul::EVMDialect const& dialect() const { return m_dialect; }
+
+private:
+	explicit YulFuzzerSession(langutil::EVMVersion _evmVersion);
+
+	langutil::EVMVersion m_evmVersion;
+	yul::EVMDialect const& m_dialect;
+};
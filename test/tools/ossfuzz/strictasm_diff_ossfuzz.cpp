@@ -31,6 +31,7 @@
 #include <libdevcore/CommonData.h>
 
 #include <test/tools/ossfuzz/yulFuzzerCommon.h>
+#include <test/tools/fuzzer_common.h>
 
 #include <string>
 #include <memory>
@@ -55,15 +56,17 @@ extern "C" int LLVMFuzzerTestOneInput(uint8_t const* _data, size_t _size)
 	}))
 		return 0;
 
-	YulStringRepository::reset();
+	YulFuzzerSession const& session = YulFuzzerSession::instance();
+	YulFuzzerSession::Input scope(session);
 
 	AssemblyStack stack(
-		langutil::EVMVersion(),
+		session.evmVersion(),
 		AssemblyStack::Language::StrictAssembly,
 		dev::solidity::OptimiserSettings::full()
 	);
 	try
 	{
+		FuzzerStats::Stage stage("parse and analyze");
 		if (
 			!stack.parseAndAnalyze("source", input) ||
 			!stack.parserResult()->code ||
@@ -80,10 +83,11 @@ extern "C" int LLVMFuzzerTestOneInput(uint8_t const* _data, size_t _size)
 	ostringstream os2;
 	try
 	{
+		FuzzerStats::Stage stage("interpret");
 		yulFuzzerUtil::interpret(
 			os1,
 			stack.parserResult()->code,
-			EVMDialect::strictAssemblyForEVMObjects(langutil::EVMVersion())
+			session.dialect()
 		);
 	}
 	catch (yul::test::StepLimitReached const&)
@@ -94,13 +98,17 @@ extern "C" int LLVMFuzzerTestOneInput(uint8_t const* _data, size_t _size)
 	{
 	}
 
-	stack.optimize();
+	{
+		FuzzerStats::Stage stage("optimize");
+		stack.optimize();
+	}
 	try
 	{
+		FuzzerStats::Stage stage("interpret");
 		yulFuzzerUtil::interpret(
 			os2,
 			stack.parserResult()->code,
-			EVMDialect::strictAssemblyForEVMObjects(langutil::EVMVersion()),
+			session.dialect(),
 			(yul::test::yul_fuzzer::yulFuzzerUtil::maxSteps * 1.5)
 		);
 	}
@@ -15,6 +15,8 @@
 	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <test/tools/fuzzer_common.h>
+
 #include <libyul/AssemblyStack.h>
 #include <liblangutil/EVMVersion.h>
 
@@ -26,18 +28,23 @@ extern "C" int LLVMFuzzerTestOneInput(uint8_t const* _data, size_t _size)
 	if (_size > 600)
 		return 0;
 
-	YulStringRepository::reset();
+	YulFuzzerSession const& session = YulFuzzerSession::instance();
+	YulFuzzerSession::Input scope(session);
 
 	string input(reinterpret_cast<char const*>(_data), _size);
 	AssemblyStack stack(
-		langutil::EVMVersion(),
+		session.evmVersion(),
 		AssemblyStack::Language::StrictAssembly,
 		dev::solidity::OptimiserSettings::full()
 	);
 
-	if (!stack.parseAndAnalyze("source", input))
-		return 0;
+	{
+		FuzzerStats::Stage stage("parse and analyze");
+		if (!stack.parseAndAnalyze("source", input))
+			return 0;
+	}
 
+	FuzzerStats::Stage stage("optimize");
 	stack.optimize();
 	return 0;
 }
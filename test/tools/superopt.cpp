@@ -0,0 +1,555 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Superoptimiser that searches for cheaper replacements of instruction sequences
+ * found in compiled code and prints them as candidate optimiser rules.
+ */
+
+#include <test/tools/yulInterpreter/EVMInstructionInterpreter.h>
+#include <test/tools/yulInterpreter/Interpreter.h>
+
+#include <libsolidity/interface/CompilerStack.h>
+
+#include <libevmasm/AssemblyItem.h>
+#include <libevmasm/ExpressionClasses.h>
+#include <libevmasm/GasMeter.h>
+#include <libevmasm/KnownState.h>
+#include <libevmasm/SemanticInformation.h>
+
+#include <liblangutil/SourceReferenceFormatter.h>
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/CommonData.h>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace langutil;
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+/// @returns true if @a _item may be part of a sequence that is optimised, i.e. if it only
+/// operates on the stack and its effect can be determined by the symbolic and the concrete
+/// evaluation alike.
+bool isStackItem(AssemblyItem const& _item)
+{
+	if (_item.type() == Push)
+		return true;
+	if (_item.type() != Operation)
+		return false;
+	Instruction instruction = _item.instruction();
+	if (
+		isDupInstruction(instruction) ||
+		isSwapInstruction(instruction) ||
+		instruction == Instruction::POP
+	)
+		return true;
+	// The gas costs of EXP depend on the exponent and memory is not modelled.
+	return
+		SemanticInformation::movable(instruction) &&
+		instruction != Instruction::EXP &&
+		instruction != Instruction::MLOAD &&
+		instructionInfo(instruction).ret == 1;
+}
+
+unsigned gasCosts(AssemblyItems const& _items)
+{
+	unsigned gas = 0;
+	for (AssemblyItem const& item: _items)
+		gas += GasMeter::runGas(item.type() == Push ? Instruction::PUSH1 : item.instruction());
+	return gas;
+}
+
+/// @returns the number of stack elements @a _items accesses below the initial top of the stack.
+int stackDepth(AssemblyItems const& _items)
+{
+	int height = 0;
+	int depth = 0;
+	for (AssemblyItem const& item: _items)
+	{
+		depth = max(depth, item.arguments() - height);
+		height += item.deposit();
+	}
+	return depth;
+}
+
+/// @returns the stack (top at the back) after executing @a _items on @a _stack
+/// using the instruction semantics of the Yul interpreter.
+vector<u256> concreteEffect(AssemblyItems const& _items, vector<u256> _stack)
+{
+	yul::test::InterpreterState state;
+	yul::test::EVMInstructionInterpreter interpreter{state};
+	for (AssemblyItem const& item: _items)
+	{
+		if (item.type() == Push)
+		{
+			_stack.push_back(item.data());
+			continue;
+		}
+		Instruction instruction = item.instruction();
+		if (isDupInstruction(instruction))
+			_stack.push_back(_stack.at(_stack.size() - getDupNumber(instruction)));
+		else if (isSwapInstruction(instruction))
+			swap(_stack.back(), _stack.at(_stack.size() - 1 - getSwapNumber(instruction)));
+		else if (instruction == Instruction::POP)
+			_stack.pop_back();
+		else
+		{
+			vector<u256> arguments;
+			for (int i = 0; i < instructionInfo(instruction).args; ++i)
+			{
+				arguments.push_back(_stack.back());
+				_stack.pop_back();
+			}
+			_stack.push_back(interpreter.eval(instruction, arguments));
+		}
+	}
+	return _stack;
+}
+
+/// @returns the equivalence classes of all stack elements from the lowest of the @a _depth
+/// initial elements up to the top of the stack after executing @a _items.
+vector<ExpressionClasses::Id> symbolicEffect(
+	AssemblyItems const& _items,
+	int _depth,
+	shared_ptr<ExpressionClasses> const& _classes
+)
+{
+	KnownState state{_classes};
+	for (AssemblyItem const& item: _items)
+		state.feedItem(item, true);
+	vector<ExpressionClasses::Id> result;
+	for (int height = 1 - _depth; height <= state.stackHeight(); ++height)
+		result.push_back(state.stackElement(height, {}));
+	return result;
+}
+
+/// Names of the placeholders for arbitrary expressions bound by simplificationRuleList.
+vector<string> const ruleListVariables{"X", "Y"};
+
+/// @returns the name of the initial stack element at @a _depth, which is only a valid
+/// placeholder of RuleList.h for the topmost elements (see ruleListVariables).
+string variableName(int _depth)
+{
+	if (_depth < int(ruleListVariables.size()))
+		return ruleListVariables[size_t(_depth)];
+	return "S" + to_string(_depth);
+}
+
+string constantToString(u256 const& _value)
+{
+	if (_value == ~u256(0))
+		return "~u256(0)";
+	if (_value < 0x10000)
+		return toString(_value);
+	return "u256(\"" + formatNumber(_value) + "\")";
+}
+
+/// Expression in the syntax of RuleList.h together with the initial stack elements it uses.
+struct RuleExpression
+{
+	string text;
+	set<int> variables;
+};
+
+/// @returns the stack (top at the back) after executing @a _items on @a _depth named initial
+/// elements, where each element is written as an expression in the syntax of RuleList.h.
+vector<RuleExpression> ruleEffect(AssemblyItems const& _items, int _depth)
+{
+	vector<RuleExpression> stack;
+	for (int depth = _depth - 1; depth >= 0; --depth)
+		stack.push_back({variableName(depth), {depth}});
+	for (AssemblyItem const& item: _items)
+	{
+		if (item.type() == Push)
+		{
+			stack.push_back({constantToString(item.data()), {}});
+			continue;
+		}
+		Instruction instruction = item.instruction();
+		if (isDupInstruction(instruction))
+			stack.push_back(stack.at(stack.size() - getDupNumber(instruction)));
+		else if (isSwapInstruction(instruction))
+			swap(stack.back(), stack.at(stack.size() - 1 - getSwapNumber(instruction)));
+		else if (instruction == Instruction::POP)
+			stack.pop_back();
+		else
+		{
+			RuleExpression expression{"{Instruction::" + instructionInfo(instruction).name + ", {", {}};
+			for (int i = 0; i < instructionInfo(instruction).args; ++i)
+			{
+				expression.text += (i > 0 ? ", " : "") + stack.back().text;
+				expression.variables += stack.back().variables;
+				stack.pop_back();
+			}
+			expression.text += "}}";
+			stack.push_back(move(expression));
+		}
+	}
+	return stack;
+}
+
+string sequenceToString(AssemblyItems const& _items)
+{
+	string result;
+	for (AssemblyItem const& item: _items)
+		result +=
+			(result.empty() ? "" : " ") +
+			(item.type() == Push ? "PUSH " + constantToString(item.data()) : instructionInfo(item.instruction()).name);
+	return result.empty() ? "<empty>" : result;
+}
+
+string toPeepholeForm(AssemblyItems const& _items)
+{
+	string result;
+	for (AssemblyItem const& item: _items)
+		result +=
+			(result.empty() ? "" : ", ") +
+			(item.type() == Push ? constantToString(item.data()) : "Instruction::" + instructionInfo(item.instruction()).name);
+	return "{" + result + "}";
+}
+
+class SuperOptimiser
+{
+public:
+	SuperOptimiser(size_t _maxLength, size_t _trials, unsigned _seed):
+		m_maxLength(_maxLength), m_trials(_trials), m_random(_seed)
+	{}
+
+	/// Counts all sequences of stack items of at least two and at most the maximum number of items.
+	void addCode(AssemblyItems const& _items)
+	{
+		for (size_t start = 0; start < _items.size(); ++start)
+			for (size_t end = start + 1; end < _items.size() && end - start < m_maxLength && isStackItem(_items[end]); ++end)
+				if (isStackItem(_items[start]))
+					m_sequences[AssemblyItems(_items.begin() + start, _items.begin() + end + 1)]++;
+	}
+
+	/// Searches replacements for all sequences that occurred at least @a _minOccurrences times
+	/// and prints the ones found, the largest total savings first.
+	void run(size_t _minOccurrences, ostream& _out)
+	{
+		struct Rule
+		{
+			AssemblyItems original;
+			AssemblyItems replacement;
+			size_t occurrences;
+			unsigned gasSaved;
+			unsigned bytesSaved;
+		};
+		map<AssemblyItems, Rule> found;
+		for (auto const& sequence: m_sequences)
+			if (sequence.second >= _minOccurrences)
+				if (auto replacement = findReplacement(sequence.first))
+					found[sequence.first] = Rule{
+						sequence.first,
+						*replacement,
+						sequence.second,
+						gasCosts(sequence.first) - gasCosts(*replacement),
+						unsigned(bytesRequired(sequence.first, 1) - bytesRequired(*replacement, 1))
+					};
+
+		// Omit rules that do not save more than a rule for a part of their sequence.
+		vector<Rule> rules;
+		for (auto const& entry: found)
+		{
+			Rule const& rule = entry.second;
+			bool subsumed = false;
+			for (size_t start = 0; start < rule.original.size() && !subsumed; ++start)
+				for (size_t end = start + 2; end <= rule.original.size() && !subsumed; ++end)
+				{
+					if (end - start == rule.original.size())
+						continue;
+					auto part = found.find(AssemblyItems(rule.original.begin() + start, rule.original.begin() + end));
+					if (
+						part != found.end() &&
+						part->second.gasSaved >= rule.gasSaved &&
+						part->second.bytesSaved >= rule.bytesSaved
+					)
+						subsumed = true;
+				}
+			if (!subsumed)
+				rules.push_back(rule);
+		}
+		stable_sort(rules.begin(), rules.end(), [](Rule const& _a, Rule const& _b) {
+			return
+				make_pair(_a.occurrences * _a.gasSaved, _a.occurrences * _a.bytesSaved) >
+				make_pair(_b.occurrences * _b.gasSaved, _b.occurrences * _b.bytesSaved);
+		});
+
+		cerr << m_sequences.size() << " sequences, " << rules.size() << " rules found." << endl;
+		for (Rule const& rule: rules)
+		{
+			_out <<
+				"// " << sequenceToString(rule.original) << " -> " << sequenceToString(rule.replacement) << endl <<
+				"// occurrences: " << rule.occurrences << ", gas saved: " << rule.gasSaved <<
+				", bytes saved: " << rule.bytesSaved << endl <<
+				toPeepholeForm(rule.original) << " -> " << toPeepholeForm(rule.replacement) << endl;
+			string ruleListForm = toRuleListForm(rule.original, rule.replacement);
+			if (!ruleListForm.empty())
+				_out << ruleListForm << endl;
+			_out << endl;
+		}
+	}
+
+private:
+	/// @returns the cheapest sequence that is equivalent to @a _original and cheaper in gas
+	/// or in size at equal gas costs, if there is one.
+	boost::optional<AssemblyItems> findReplacement(AssemblyItems const& _original)
+	{
+		int depth = stackDepth(_original);
+		vector<vector<u256>> inputs;
+		vector<vector<u256>> outputs;
+		for (size_t i = 0; i < m_trials; ++i)
+		{
+			inputs.push_back(randomStack(depth));
+			outputs.push_back(concreteEffect(_original, inputs.back()));
+		}
+
+		AssemblyItems alphabet = this->alphabet(_original, depth);
+		unsigned const originalGas = gasCosts(_original);
+		size_t const originalSize = bytesRequired(_original, 1);
+		boost::optional<AssemblyItems> best;
+		auto isBetter = [&](AssemblyItems const& _candidate)
+		{
+			unsigned gas = gasCosts(_candidate);
+			size_t size = bytesRequired(_candidate, 1);
+			if (best)
+				return make_pair(gas, size) < make_pair(gasCosts(*best), bytesRequired(*best, 1));
+			return gas < originalGas || (gas == originalGas && size < originalSize);
+		};
+		auto isEquivalent = [&](AssemblyItems const& _candidate)
+		{
+			if (stackDepth(_candidate) > depth)
+				return false;
+			// Test a few inputs first, this rules out most candidates quickly.
+			for (size_t i = 0; i < min<size_t>(3, m_trials); ++i)
+				if (concreteEffect(_candidate, inputs[i]) != outputs[i])
+					return false;
+			auto classes = make_shared<ExpressionClasses>();
+			if (symbolicEffect(_candidate, depth, classes) != symbolicEffect(_original, depth, classes))
+				return false;
+			for (size_t i = 3; i < m_trials; ++i)
+				if (concreteEffect(_candidate, inputs[i]) != outputs[i])
+					return false;
+			return true;
+		};
+
+		AssemblyItems candidate;
+		function<void()> search = [&]()
+		{
+			if (isBetter(candidate) && isEquivalent(candidate))
+				best = candidate;
+			if (candidate.size() >= _original.size() || gasCosts(candidate) >= originalGas)
+				return;
+			for (AssemblyItem const& item: alphabet)
+			{
+				candidate.push_back(item);
+				search();
+				candidate.pop_back();
+			}
+		};
+		search();
+		return best;
+	}
+
+	/// @returns the items candidates for replacing @a _original are composed of.
+	AssemblyItems alphabet(AssemblyItems const& _original, int _depth) const
+	{
+		set<AssemblyItem> items{
+			AssemblyItem(Instruction::POP),
+			AssemblyItem(Instruction::ISZERO),
+			AssemblyItem(Instruction::NOT),
+			AssemblyItem(u256(0))
+		};
+		unsigned maxHeight = min<unsigned>(16, unsigned(_depth + _original.size()));
+		for (unsigned i = 1; i <= maxHeight; ++i)
+		{
+			items.insert(AssemblyItem(dupInstruction(i)));
+			if (i < maxHeight)
+				items.insert(AssemblyItem(swapInstruction(i)));
+		}
+		for (AssemblyItem const& item: _original)
+			items.insert(item);
+		return AssemblyItems(items.begin(), items.end());
+	}
+
+	/// @returns a rule in the syntax of RuleList.h if both sequences replace the same elements
+	/// on top of the stack by a single value and an empty string otherwise.
+	static string toRuleListForm(AssemblyItems const& _original, AssemblyItems const& _replacement)
+	{
+		int depth = stackDepth(_original);
+		vector<RuleExpression> originalStack = ruleEffect(_original, depth);
+		vector<RuleExpression> replacementStack = ruleEffect(_replacement, depth);
+		if (originalStack.empty() || originalStack.size() != replacementStack.size())
+			return {};
+		int consumed = depth + 1 - int(originalStack.size());
+		if (consumed < 0 || consumed > int(ruleListVariables.size()))
+			return {};
+		for (size_t i = 0; i + 1 < originalStack.size(); ++i)
+			if (originalStack[i].text != variableName(depth - 1 - int(i)) || replacementStack[i].text != originalStack[i].text)
+				return {};
+		RuleExpression const& pattern = originalStack.back();
+		RuleExpression const& result = replacementStack.back();
+		// All consumed elements have to be matched by the pattern and the result can only
+		// use what the pattern matched.
+		set<int> consumedVariables;
+		for (int i = 0; i < consumed; ++i)
+			consumedVariables.insert(i);
+		if (pattern.variables != consumedVariables || !includes(
+			pattern.variables.begin(), pattern.variables.end(),
+			result.variables.begin(), result.variables.end()
+		))
+			return {};
+		if (pattern.text.front() != '{')
+			return {};
+		// The matched expressions can have side effects, so the rule has to be marked
+		// if the result drops any of them.
+		bool removesNonConstants = result.variables != pattern.variables;
+		string flag = removesNonConstants ? "true" : "false";
+		if (result.text.front() == '{')
+			return "{" + pattern.text + ", [=]() -> Pattern { return " + result.text + "; }, " + flag + "},";
+		else
+			return "{" + pattern.text + ", [=]{ return " + result.text + "; }, " + flag + "},";
+	}
+
+	/// @returns a stack (top at the back) of @a _depth random values, biased towards values
+	/// that are likely to expose differences.
+	vector<u256> randomStack(int _depth)
+	{
+		vector<u256> stack;
+		for (int i = 0; i < _depth; ++i)
+			switch (m_random() % 6)
+			{
+			case 0:
+				stack.push_back(0);
+				break;
+			case 1:
+				stack.push_back(1);
+				break;
+			case 2:
+				stack.push_back(m_random() % 0x100);
+				break;
+			case 3:
+				stack.push_back(u256(1) << (m_random() % 256));
+				break;
+			case 4:
+				stack.push_back(~u256(0) - m_random() % 4);
+				break;
+			default:
+			{
+				u256 value = 0;
+				for (int j = 0; j < 8; ++j)
+					value = (value << 32) | m_random();
+				stack.push_back(value);
+			}
+			}
+		return stack;
+	}
+
+	size_t m_maxLength;
+	size_t m_trials;
+	mt19937 m_random;
+	map<AssemblyItems, size_t> m_sequences;
+};
+
+}
+
+int main(int argc, char** argv)
+{
+	po::options_description options(
+		R"(superopt, superoptimiser for EVM instruction sequences.
+Usage: superopt [Options] <file>...
+Compiles the given Solidity files, searches cheaper equivalent replacements for
+the short instruction sequences in the generated code and prints them as
+candidate peephole and RuleList.h rules.
+
+Allowed options)",
+		po::options_description::m_default_line_length,
+		po::options_description::m_default_line_length - 23);
+	options.add_options()
+		("help", "Show this help screen.")
+		("input-file", po::value<vector<string>>(), "input file")
+		("no-optimize", "Search in the code generated without the optimiser.")
+		("max-length", po::value<size_t>()->default_value(3), "Maximum number of items of a sequence.")
+		("min-occurrences", po::value<size_t>()->default_value(1), "Only consider sequences that occur at least this often.")
+		("trials", po::value<size_t>()->default_value(100), "Number of random inputs a replacement is tested with.")
+		("seed", po::value<unsigned>()->default_value(0), "Seed for the random inputs.");
+	po::positional_options_description filesPositions;
+	filesPositions.add("input-file", -1);
+
+	po::variables_map arguments;
+	try
+	{
+		po::command_line_parser cmdLineParser(argc, argv);
+		cmdLineParser.options(options).positional(filesPositions);
+		po::store(cmdLineParser.run(), arguments);
+	}
+	catch (po::error const& _exception)
+	{
+		cerr << _exception.what() << endl;
+		return 1;
+	}
+
+	if (arguments.count("help") || !arguments.count("input-file"))
+	{
+		cout << options;
+		return 0;
+	}
+
+	StringMap sources;
+	for (string const& path: arguments["input-file"].as<vector<string>>())
+		sources[path] = readFileAsString(path);
+
+	dev::solidity::CompilerStack compiler;
+	compiler.setSources(sources);
+	compiler.setOptimiserSettings(!arguments.count("no-optimize"));
+	if (!compiler.compile())
+	{
+		for (auto const& error: compiler.errors())
+			SourceReferenceFormatter(cerr).printErrorInformation(*error);
+		return 1;
+	}
+
+	SuperOptimiser optimiser{
+		max<size_t>(2, arguments["max-length"].as<size_t>()),
+		max<size_t>(3, arguments["trials"].as<size_t>()),
+		arguments["seed"].as<unsigned>()
+	};
+	for (string const& contract: compiler.contractNames())
+	{
+		if (auto items = compiler.assemblyItems(contract))
+			optimiser.addCode(*items);
+		if (auto items = compiler.runtimeAssemblyItems(contract))
+			optimiser.addCode(*items);
+	}
+	optimiser.run(arguments["min-occurrences"].as<size_t>(), cout);
+
+	return 0;
+}
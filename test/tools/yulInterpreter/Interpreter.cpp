@@ -204,9 +204,6 @@ void Interpreter::closeScope()
 
 void ExpressionEvaluator::operator()(Literal const& _literal)
 {
-	static YulString const trueString("true");
-	static YulString const falseString("false");
-
 	setValue(valueOfLiteral(_literal));
 }
 